@@ -9,6 +9,9 @@
 #include <LogUtil.h>
 #include "AVPacketQueue.h"
 
+// 刷新标记的 data 指向这里，只用于比较地址
+static uint8_t s_FlushMarker;
+
 AVPacketQueue::AVPacketQueue() {
     abort_request = 0;
     first_pkt = nullptr;
@@ -16,6 +19,7 @@ AVPacketQueue::AVPacketQueue() {
     nb_packets = 0;
     size = 0;
     duration = 0;
+    serial = 0;
 }
 
 AVPacketQueue::~AVPacketQueue() {
@@ -36,6 +40,7 @@ int AVPacketQueue::Put(AVPacket *pkt) {
     }
     pkt1->pkt = *pkt;
     pkt1->next = nullptr;
+    pkt1->serial = serial;
 
     if (!last_pkt) {
         first_pkt = pkt1;
@@ -72,6 +77,24 @@ int AVPacketQueue::PushNullPacket(int stream_index) {
     return PushPacket(pkt);
 }
 
+int AVPacketQueue::PushFlushPacket() {
+    AVPacket pkt;
+    av_init_packet(&pkt);
+    pkt.data = &s_FlushMarker;
+    pkt.size = 0;
+
+    Flush();
+    unique_lock<mutex> lock(m_Mutex);
+    serial++;
+    int ret = Put(&pkt);
+    m_CondVar.notify_all();
+    return ret;
+}
+
+bool AVPacketQueue::IsFlushPacket(AVPacket *pkt) {
+    return pkt->data == &s_FlushMarker;
+}
+
 void AVPacketQueue::Flush() {
     AVPacketNode *pkt, *pkt1;
     unique_lock<mutex> lock(m_Mutex);
@@ -105,6 +128,10 @@ int AVPacketQueue::GetPacket(AVPacket *pkt) {
 }
 
 int AVPacketQueue::GetPacket(AVPacket *pkt, int block) {
+    return GetPacket(pkt, block, nullptr);
+}
+
+int AVPacketQueue::GetPacket(AVPacket *pkt, int block, int *serial) {
     AVPacketNode *pkt1;
     int ret;
     unique_lock<mutex> lock(m_Mutex);
@@ -124,6 +151,9 @@ int AVPacketQueue::GetPacket(AVPacket *pkt, int block) {
             size -= pkt1->pkt.size + sizeof(*pkt1);
             duration -= pkt1->pkt.duration;
             *pkt = pkt1->pkt;
+            if (serial) {
+                *serial = pkt1->serial;
+            }
             av_free(pkt1);
             ret = 1;
             break;
@@ -152,6 +182,11 @@ int64_t AVPacketQueue::GetDuration() {
     return duration;
 }
 
+int AVPacketQueue::GetSerial() {
+    unique_lock<mutex> lock(m_Mutex);
+    return serial;
+}
+
 int AVPacketQueue::IsAbort() {
     unique_lock<mutex> lock(m_Mutex);
     return abort_request;
@@ -20,6 +20,7 @@ using namespace std;
 typedef struct AVPacketNode {
     AVPacket pkt;
     struct AVPacketNode *next;
+    int serial;                 // 入队时队列的序号，seek 之后递增
 } AVPacketNode;
 
 class AVPacketQueue {
@@ -34,6 +35,12 @@ public:
     // 入队空数据包
     int PushNullPacket(int stream_index);
 
+    // 清空队列、递增序号并入队刷新标记，消费者取到标记后刷新解码器（seek 时调用，不需要等待消费者）
+    int PushFlushPacket();
+
+    // 是否为刷新标记
+    static bool IsFlushPacket(AVPacket *pkt);
+
     // 刷新
     void Flush();
 
@@ -49,6 +56,12 @@ public:
     // 获取数据包
     int GetPacket(AVPacket *pkt, int block);
 
+    // 获取数据包及其序号，序号与 GetSerial 不一致的数据包已经过期
+    int GetPacket(AVPacket *pkt, int block, int *serial);
+
+    // 当前序号
+    int GetSerial();
+
     int GetPacketSize();
 
     int GetSize();
@@ -67,6 +80,7 @@ private:
     int nb_packets;
     int size;
     int64_t duration;
+    int serial;
     volatile int abort_request;
 };
 
@@ -0,0 +1,98 @@
+/**
+ *
+ * Created by 公众号：字节流动 on 2026/10/18.
+ * https://github.com/githubhaohao/LearnFFmpeg
+ * 最新文章首发于公众号：字节流动，有疑问或者技术交流可以添加微信 Byte-Flow ,领取视频教程, 拉你进技术交流群
+ *
+ * */
+
+#include <LogUtil.h>
+#include "BufferingPolicy.h"
+
+extern "C" {
+#include <libavutil/time.h>
+};
+
+BufferingPolicy::BufferingPolicy() {
+    m_LowDuration = BUFFER_LOW_MIN_DURATION;
+    m_HighDuration = BUFFER_LOW_MIN_DURATION + BUFFER_HIGH_MIN_GAP;
+}
+
+void BufferingPolicy::AddStream(AVPacketQueue *queue, AVRational timeBase) {
+    StreamState stream = {queue, timeBase, 0};
+    m_Streams.push_back(stream);
+}
+
+void BufferingPolicy::OnRead(int64_t readCostUs) {
+    int64_t now = av_gettime_relative();
+    int64_t elapsed = m_LastReadTime < 0 ? 0 : now - m_LastReadTime;
+    m_LastReadTime = now;
+
+    //峰值随时间衰减，网络恢复平稳后水位逐渐回落
+    m_PeakStallUs = FFMAX(readCostUs, m_PeakStallUs - elapsed / BUFFER_STALL_DECAY);
+    m_LowDuration = av_clipd(m_PeakStallUs / 1000000.0 * BUFFER_STALL_FACTOR, BUFFER_LOW_MIN_DURATION, BUFFER_LOW_MAX_DURATION);
+    m_HighDuration = FFMIN(BUFFER_HIGH_MAX_DURATION, m_LowDuration + FFMAX(m_LowDuration, BUFFER_HIGH_MIN_GAP));
+
+    for (size_t i = 0; i < m_Streams.size(); i++) {
+        StreamState &stream = m_Streams[i];
+        double duration = GetDuration(stream);
+        if (duration > 0) {
+            double byteRate = stream.queue->GetSize() / duration;
+            stream.byteRate = stream.byteRate > 0 ? stream.byteRate * 0.9 + byteRate * 0.1 : byteRate;
+        }
+    }
+
+    if (now - m_LastLogTime >= 1000000) {
+        m_LastLogTime = now;
+        for (size_t i = 0; i < m_Streams.size(); i++) {
+            StreamState &stream = m_Streams[i];
+            LOGCATE("BufferingPolicy::OnRead stream %d: buffered=%.3fs/%dB, watermark [low, high]=[%.3fs/%lldB, %.3fs/%lldB], peak stall=%lldms",
+                    (int) i, GetDuration(stream), stream.queue->GetSize(),
+                    m_LowDuration, (long long) ToBytes(stream, m_LowDuration),
+                    m_HighDuration, (long long) ToBytes(stream, m_HighDuration),
+                    (long long) m_PeakStallUs / 1000);
+        }
+    }
+}
+
+bool BufferingPolicy::IsEnough() {
+    for (size_t i = 0; i < m_Streams.size(); i++) {
+        StreamState &stream = m_Streams[i];
+        //数据包没有时长且码率未知时，有数据即可
+        if (stream.queue->GetDuration() == 0 && stream.byteRate <= 0 && stream.queue->GetPacketSize() > 0) continue;
+        if (GetDuration(stream) < m_LowDuration && stream.queue->GetSize() < ToBytes(stream, m_LowDuration)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool BufferingPolicy::IsFull() {
+    if (!IsEnough()) return false;
+
+    for (size_t i = 0; i < m_Streams.size(); i++) {
+        StreamState &stream = m_Streams[i];
+        if (GetDuration(stream) >= m_HighDuration || stream.queue->GetSize() >= ToBytes(stream, m_HighDuration)) {
+            return true;
+        }
+    }
+    return IsOverMaxBytes();
+}
+
+bool BufferingPolicy::IsOverMaxBytes() {
+    int64_t totalBytes = 0;
+    for (size_t i = 0; i < m_Streams.size(); i++) {
+        totalBytes += m_Streams[i].queue->GetSize();
+    }
+    return totalBytes >= BUFFER_MAX_BYTES;
+}
+
+double BufferingPolicy::GetDuration(StreamState &stream) {
+    return stream.queue->GetDuration() * av_q2d(stream.timeBase);
+}
+
+int64_t BufferingPolicy::ToBytes(StreamState &stream, double duration) {
+    //码率未知时不按字节判断
+    if (stream.byteRate <= 0) return INT64_MAX;
+    return static_cast<int64_t>(stream.byteRate * duration);
+}
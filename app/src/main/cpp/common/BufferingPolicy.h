@@ -0,0 +1,105 @@
+/**
+ *
+ * Created by 公众号：字节流动 on 2026/10/18.
+ * https://github.com/githubhaohao/LearnFFmpeg
+ * 最新文章首发于公众号：字节流动，有疑问或者技术交流可以添加微信 Byte-Flow ,领取视频教程, 拉你进技术交流群
+ *
+ * */
+
+#ifndef LEARNFFMPEG_BUFFERINGPOLICY_H
+#define LEARNFFMPEG_BUFFERINGPOLICY_H
+
+#include <vector>
+#include "AVPacketQueue.h"
+
+// 低水位时长的下限和上限（秒），缓冲中达到低水位后开始播放
+#define BUFFER_LOW_MIN_DURATION    0.1
+#define BUFFER_LOW_MAX_DURATION    5.0
+// 高水位至少比低水位高出的时长（秒），高于高水位时停止读取
+#define BUFFER_HIGH_MIN_GAP        0.4
+// 高水位时长上限（秒）
+#define BUFFER_HIGH_MAX_DURATION   10.0
+// 低水位 = 读取卡顿峰值 * 系数
+#define BUFFER_STALL_FACTOR        2.0
+// 卡顿峰值的衰减速度：每秒衰减 1/BUFFER_STALL_DECAY 秒
+#define BUFFER_STALL_DECAY         10
+// 所有队列合计的字节数上限，码率很高时防止占用过多内存
+#define BUFFER_MAX_BYTES           (32 * 1024 * 1024)
+
+/**
+ * @brief 自适应缓冲策略
+ *
+ * 解封装线程每读到一个数据包调用 OnRead 上报读取耗时（网络卡顿时 av_read_frame 会阻塞），
+ * 以衰减的卡顿峰值估算到达抖动，据此调整每条流的水位：
+ * - 低水位（时长）= 卡顿峰值 * BUFFER_STALL_FACTOR，本地文件没有卡顿时为 BUFFER_LOW_MIN_DURATION
+ * - 高水位（时长）= 低水位 + max(低水位, BUFFER_HIGH_MIN_GAP)
+ * - 字节水位由每条流的实际码率换算，数据包没有时长信息时按字节判断
+ *
+ * 不是线程安全的，由调用方加锁
+ */
+class BufferingPolicy {
+public:
+    BufferingPolicy();
+
+    /**
+     * @brief 添加需要缓冲的流
+     * @param queue 流的数据包队列
+     * @param timeBase 流的时间基，用于换算队列时长
+     */
+    void AddStream(AVPacketQueue *queue, AVRational timeBase);
+
+    /**
+     * @brief 上报一次读取
+     * @param readCostUs av_read_frame 的耗时（微秒）
+     */
+    void OnRead(int64_t readCostUs);
+
+    /**
+     * @brief 是否所有流都达到低水位，缓冲中时用于判断是否可以结束缓冲
+     */
+    bool IsEnough();
+
+    /**
+     * @brief 是否应该暂停读取：所有流都达到低水位，且有流超过高水位或合计字节数超过上限
+     * 只要有一条流低于低水位就继续读，避免交织不均匀时另一条流饿死
+     */
+    bool IsFull();
+
+    /**
+     * @brief 所有队列合计的字节数是否达到 BUFFER_MAX_BYTES，与水位和缓冲状态无关，达到时必须停止读取
+     */
+    bool IsOverMaxBytes();
+
+    double GetLowDuration() {
+        return m_LowDuration;
+    }
+
+    double GetHighDuration() {
+        return m_HighDuration;
+    }
+
+private:
+    struct StreamState {
+        AVPacketQueue *queue;
+        AVRational     timeBase;
+        double         byteRate;   // 平滑后的码率（字节/秒）
+    };
+
+    double GetDuration(StreamState &stream);
+
+    /**
+     * @brief 按码率把时长水位换算成字节水位
+     */
+    int64_t ToBytes(StreamState &stream, double duration);
+
+private:
+    std::vector<StreamState> m_Streams;
+    double   m_LowDuration;
+    double   m_HighDuration;
+    int64_t  m_PeakStallUs = 0;      // 衰减的读取卡顿峰值（微秒）
+    int64_t  m_LastReadTime = -1;    // 上次读取的时间（微秒）
+    int64_t  m_LastLogTime = 0;      // 上次打印水位的时间（微秒）
+};
+
+
+#endif //LEARNFFMPEG_BUFFERINGPOLICY_H
@@ -0,0 +1,20 @@
+/**
+ *
+ * Created by 公众号：字节流动 on 2026/10/18.
+ * https://github.com/githubhaohao/LearnFFmpeg
+ * 最新文章首发于公众号：字节流动，有疑问或者技术交流可以添加微信 Byte-Flow ,领取视频教程, 拉你进技术交流群
+ *
+ * */
+
+#include <LogUtil.h>
+#include "CostCounter.h"
+
+void CostCounter::Add(int64_t costUs) {
+    m_WindowCost += costUs;
+    m_WindowCount++;
+    if (m_WindowCount >= COST_REPORT_INTERVAL) {
+        LOGCATE("CostCounter %s avg=%.3fms over %d", m_Name, m_WindowCost / 1000.0 / m_WindowCount, m_WindowCount);
+        m_WindowCost = 0;
+        m_WindowCount = 0;
+    }
+}
@@ -0,0 +1,38 @@
+/**
+ *
+ * Created by 公众号：字节流动 on 2026/10/18.
+ * https://github.com/githubhaohao/LearnFFmpeg
+ * 最新文章首发于公众号：字节流动，有疑问或者技术交流可以添加微信 Byte-Flow ,领取视频教程, 拉你进技术交流群
+ *
+ * */
+
+#ifndef LEARNFFMPEG_COSTCOUNTER_H
+#define LEARNFFMPEG_COSTCOUNTER_H
+
+#include <cstdint>
+
+// 每累计多少次打印一次平均耗时
+#define COST_REPORT_INTERVAL 100
+
+/**
+ * @brief 耗时统计
+ *
+ * 调用方测量一次操作的耗时（微秒）后调用 Add，每 COST_REPORT_INTERVAL 次打印一次平均耗时，
+ * 用于在设备上对比同一帧走不同处理路径的开销。
+ *
+ * 每个计数器只在一个线程内使用，不加锁
+ */
+class CostCounter {
+public:
+    CostCounter(const char *name) : m_Name(name) {}
+
+    void Add(int64_t costUs);
+
+private:
+    const char *m_Name;
+    int64_t m_WindowCost = 0;   // 当前统计周期的总耗时（微秒）
+    int m_WindowCount = 0;      // 当前统计周期的次数
+};
+
+
+#endif //LEARNFFMPEG_COSTCOUNTER_H
@@ -0,0 +1,97 @@
+/**
+ *
+ * Created by 公众号：字节流动 on 2026/10/18.
+ * https://github.com/githubhaohao/LearnFFmpeg
+ * 最新文章首发于公众号：字节流动，有疑问或者技术交流可以添加微信 Byte-Flow ,领取视频教程, 拉你进技术交流群
+ *
+ * */
+
+#include <cstdlib>
+#include <LogUtil.h>
+#include "DirectBufferPool.h"
+
+DirectBufferPool::DirectBufferPool(int count, int capacity) {
+    m_Count = count > 0 ? count : 0;
+    m_Capacity = capacity > 0 ? capacity : 0;
+    m_ppBuffers = new uint8_t *[m_Count];
+    m_pStates = new int[m_Count];
+    for (int i = 0; i < m_Count; ++i) {
+        void *pBuffer = nullptr;
+        if (posix_memalign(&pBuffer, DIRECT_BUFFER_ALIGN, m_Capacity) != 0) {
+            pBuffer = nullptr;
+        }
+        m_ppBuffers[i] = static_cast<uint8_t *>(pBuffer);
+        m_pStates[i] = DIRECT_BUFFER_FREE;
+    }
+    LOGCATE("DirectBufferPool::DirectBufferPool count=%d, capacity=%d", m_Count, m_Capacity);
+}
+
+DirectBufferPool::~DirectBufferPool() {
+    LOGCATE("DirectBufferPool::~DirectBufferPool acquire=%ld, drop=%ld", m_AcquireCount, m_DropCount);
+    for (int i = 0; i < m_Count; ++i) {
+        if (m_pStates[i] != DIRECT_BUFFER_FREE) {
+            LOGCATE("DirectBufferPool::~DirectBufferPool buffer %d not released, state=%d", i, m_pStates[i]);
+        }
+        free(m_ppBuffers[i]);
+    }
+    delete[] m_ppBuffers;
+    delete[] m_pStates;
+}
+
+uint8_t *DirectBufferPool::GetBuffer(int index) {
+    if (index < 0 || index >= m_Count) return nullptr;
+    return m_ppBuffers[index];
+}
+
+int DirectBufferPool::IndexOf(const void *pData) {
+    if (pData == nullptr) return -1;
+    for (int i = 0; i < m_Count; ++i) {
+        if (m_ppBuffers[i] == pData) return i;
+    }
+    return -1;
+}
+
+int DirectBufferPool::Acquire() {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    for (int i = 0; i < m_Count; ++i) {
+        if (m_pStates[i] == DIRECT_BUFFER_FREE && m_ppBuffers[i] != nullptr) {
+            m_pStates[i] = DIRECT_BUFFER_FILLING;
+            m_AcquireCount++;
+            return i;
+        }
+    }
+    m_DropCount++;
+    LOGCATE("DirectBufferPool::Acquire no free buffer, drop=%ld", m_DropCount);
+    return -1;
+}
+
+int DirectBufferPool::Submit(int index) {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    if (index < 0 || index >= m_Count || m_pStates[index] != DIRECT_BUFFER_FILLING) {
+        LOGCATE("DirectBufferPool::Submit invalid buffer index=%d", index);
+        return -1;
+    }
+    m_pStates[index] = DIRECT_BUFFER_QUEUED;
+    return 0;
+}
+
+void DirectBufferPool::Release(int index) {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    if (index < 0 || index >= m_Count) return;
+    m_pStates[index] = DIRECT_BUFFER_FREE;
+}
+
+int DirectBufferPool::GetFreeCount() {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    int freeCount = 0;
+    for (int i = 0; i < m_Count; ++i) {
+        if (m_pStates[i] == DIRECT_BUFFER_FREE) freeCount++;
+    }
+    return freeCount;
+}
+
+void DirectBufferPool::ReleaseBuffer(void *opaque, uint8_t *pData) {
+    DirectBufferPool *pool = static_cast<DirectBufferPool *>(opaque);
+    if (pool == nullptr) return;
+    pool->Release(pool->IndexOf(pData));
+}
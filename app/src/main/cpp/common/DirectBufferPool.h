@@ -0,0 +1,65 @@
+/**
+ *
+ * Created by 公众号：字节流动 on 2026/10/18.
+ * https://github.com/githubhaohao/LearnFFmpeg
+ * 最新文章首发于公众号：字节流动，有疑问或者技术交流可以添加微信 Byte-Flow ,领取视频教程, 拉你进技术交流群
+ *
+ * */
+
+#ifndef LEARNFFMPEG_DIRECTBUFFERPOOL_H
+#define LEARNFFMPEG_DIRECTBUFFERPOOL_H
+
+#include <cstdint>
+#include <mutex>
+
+// 缓冲区起始地址对齐，方便 SIMD 处理
+#define DIRECT_BUFFER_ALIGN 64
+
+// 缓冲区状态
+#define DIRECT_BUFFER_FREE     0   // 空闲，可以被 Acquire
+#define DIRECT_BUFFER_FILLING  1   // 已借给 Java 填充数据
+#define DIRECT_BUFFER_QUEUED   2   // 已交回 Native，等待消费完成后 Release
+
+/**
+ * @brief 预分配的直接缓冲池，由 JNI 层包装成 Java 的 direct ByteBuffer，Java 和 Native 共享同一块内存
+ * 缓冲流转：Acquire(FREE -> FILLING)、Submit(FILLING -> QUEUED)、Release(-> FREE)，没有空闲缓冲时 Acquire 返回 -1
+ */
+class DirectBufferPool {
+public:
+    DirectBufferPool(int count, int capacity);
+
+    ~DirectBufferPool();
+
+    int GetCount() { return m_Count; }
+
+    int GetCapacity() { return m_Capacity; }
+
+    uint8_t *GetBuffer(int index);
+
+    // 根据缓冲区地址（GetDirectBufferAddress 的结果）查找索引，不属于本池返回 -1
+    int IndexOf(const void *pData);
+
+    int Acquire();
+
+    int Submit(int index);
+
+    void Release(int index);
+
+    int GetFreeCount();
+
+    // 与 AudioFrame 的释放回调签名一致，opaque 为缓冲池指针
+    static void ReleaseBuffer(void *opaque, uint8_t *pData);
+
+private:
+    int m_Count;
+    int m_Capacity;
+    uint8_t **m_ppBuffers = nullptr;
+    int *m_pStates = nullptr;
+    std::mutex m_Mutex;
+
+    long m_AcquireCount = 0;   // Acquire 成功次数
+    long m_DropCount = 0;      // 没有空闲缓冲导致的丢帧次数
+};
+
+
+#endif //LEARNFFMPEG_DIRECTBUFFERPOOL_H
@@ -0,0 +1,62 @@
+/**
+ *
+ * Created by 公众号：字节流动 on 2026/10/18.
+ * https://github.com/githubhaohao/LearnFFmpeg
+ * 最新文章首发于公众号：字节流动，有疑问或者技术交流可以添加微信 Byte-Flow ,领取视频教程, 拉你进技术交流群
+ *
+ * */
+
+#include <cmath>
+#include <cstring>
+#include <LogUtil.h>
+#include "DisplayMatrix.h"
+#include "YuvTransform.h"
+
+extern "C" {
+#include <libavutil/display.h>
+};
+
+int DisplayMatrix::WriteToStream(AVStream *stream, int degree, int mirror) {
+    if (stream == nullptr) return -1;
+    int clockwise = mirror == YUV_MIRROR_NONE ? degree : 360 - degree;
+    clockwise = ((clockwise % 360) + 360) % 360;
+    if (clockwise == 0 && mirror == YUV_MIRROR_NONE) return 0;
+
+    int32_t *matrix = reinterpret_cast<int32_t *>(av_stream_new_side_data(stream, AV_PKT_DATA_DISPLAYMATRIX,
+                                                                          sizeof(int32_t) * 9));
+    if (matrix == nullptr) {
+        LOGCATE("DisplayMatrix::WriteToStream av_stream_new_side_data fail");
+        return AVERROR(ENOMEM);
+    }
+    // av_display_rotation_set 的角度是逆时针方向；flip 作用在旋转之后的坐标上
+    av_display_rotation_set(matrix, -clockwise);
+    av_display_matrix_flip(matrix, mirror == YUV_MIRROR_HORIZONTAL, mirror == YUV_MIRROR_VERTICAL);
+    LOGCATE("DisplayMatrix::WriteToStream clockwise=%d, mirror=%d", clockwise, mirror);
+    return 0;
+}
+
+bool DisplayMatrix::ReadFromStream(const AVStream *stream, int *pClockwise, bool *pHFlip) {
+    *pClockwise = 0;
+    *pHFlip = false;
+    if (stream == nullptr) return false;
+
+    int size = 0;
+    const uint8_t *pData = av_stream_get_side_data(stream, AV_PKT_DATA_DISPLAYMATRIX, &size);
+    if (pData == nullptr || size < (int) sizeof(int32_t) * 9) return false;
+
+    int32_t matrix[9];
+    memcpy(matrix, pData, sizeof(matrix));
+    // 行列式为负说明带镜像，先去掉水平镜像，剩下的是纯旋转
+    int64_t det = (int64_t) matrix[0] * matrix[4] - (int64_t) matrix[1] * matrix[3];
+    bool hflip = det < 0;
+    if (hflip) av_display_matrix_flip(matrix, 1, 0);
+
+    double angle = -av_display_rotation_get(matrix);
+    if (std::isnan(angle)) return false;
+    // 只支持 90 度的整数倍
+    int clockwise = static_cast<int>(lround(angle / 90)) * 90;
+    *pClockwise = ((clockwise % 360) + 360) % 360;
+    *pHFlip = hflip;
+    LOGCATE("DisplayMatrix::ReadFromStream angle=%.2f, clockwise=%d, hflip=%d", angle, *pClockwise, hflip);
+    return true;
+}
@@ -0,0 +1,42 @@
+/**
+ *
+ * Created by 公众号：字节流动 on 2026/10/18.
+ * https://github.com/githubhaohao/LearnFFmpeg
+ * 最新文章首发于公众号：字节流动，有疑问或者技术交流可以添加微信 Byte-Flow ,领取视频教程, 拉你进技术交流群
+ *
+ * */
+
+#ifndef LEARNFFMPEG_DISPLAYMATRIX_H
+#define LEARNFFMPEG_DISPLAYMATRIX_H
+
+extern "C" {
+#include <libavformat/avformat.h>
+};
+
+/**
+ * @brief 视频流显示矩阵（AV_PKT_DATA_DISPLAYMATRIX）的读写，旋转按顺时针角度表示，镜像在旋转之后进行
+ * 读取时带镜像的矩阵统一分解为“顺时针旋转 + 水平镜像”
+ */
+class DisplayMatrix {
+public:
+    /**
+     * @brief 写入视频流的显示矩阵，需在 avformat_write_header 之前调用
+     * @param stream 视频流
+     * @param degree 旋转角度，含义与 TransformMatrix::degree 相同（mirror 非 0 时为逆时针）
+     * @param mirror 镜像方式，YUV_MIRROR_XXX
+     * @return 0表示成功（无旋转和镜像时不写入），负数表示失败
+     */
+    static int WriteToStream(AVStream *stream, int degree, int mirror);
+
+    /**
+     * @brief 读取视频流的显示矩阵
+     * @param stream 视频流
+     * @param pClockwise 输出顺时针旋转角度，0/90/180/270
+     * @param pHFlip 输出旋转后是否需要水平镜像
+     * @return 流带有有效的显示矩阵时返回 true，否则输出 0 并返回 false
+     */
+    static bool ReadFromStream(const AVStream *stream, int *pClockwise, bool *pHFlip);
+};
+
+
+#endif //LEARNFFMPEG_DISPLAYMATRIX_H
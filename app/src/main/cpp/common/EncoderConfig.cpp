@@ -0,0 +1,142 @@
+/**
+ *
+ * Created by 公众号：字节流动 on 2026/10/18.
+ * https://github.com/githubhaohao/LearnFFmpeg
+ * 最新文章首发于公众号：字节流动，有疑问或者技术交流可以添加微信 Byte-Flow ,领取视频教程, 拉你进技术交流群
+ *
+ * */
+
+#include <cstring>
+#include <LogUtil.h>
+#include "EncoderConfig.h"
+
+extern "C" {
+#include <libavutil/opt.h>
+};
+
+static void SetPrivOption(AVCodecContext *ctx, const char *key, const std::string &value) {
+    if (value.empty()) return;
+    int ret = av_opt_set(ctx->priv_data, key, value.c_str(), 0);
+    if (ret < 0) {
+        LOGCATE("EncoderConfig::Apply set %s=%s fail. ret=%d", key, value.c_str(), ret);
+    }
+}
+
+AVCodec *EncoderConfig::FindEncoder(const AVOutputFormat *oformat) const {
+    AVCodecID codecId = codec == ENCODER_CODEC_MPEG4 ? AV_CODEC_ID_MPEG4 : AV_CODEC_ID_H264;
+    // avformat_query_codec 返回 0 表示容器明确不支持，负数表示无法判断
+    if (oformat != nullptr && avformat_query_codec(oformat, codecId, FF_COMPLIANCE_NORMAL) == 0) {
+        LOGCATE("EncoderConfig::FindEncoder %s is not supported by %s, use %s", avcodec_get_name(codecId),
+                oformat->name, avcodec_get_name(oformat->video_codec));
+        codecId = oformat->video_codec;
+    }
+
+    AVCodec *encoder = nullptr;
+    if (codecId == AV_CODEC_ID_H264) {
+        encoder = avcodec_find_encoder_by_name("libx264");
+    }
+    if (encoder == nullptr) {
+        encoder = avcodec_find_encoder(codecId);
+    }
+    if (encoder == nullptr && codecId != AV_CODEC_ID_MPEG4) {
+        LOGCATE("EncoderConfig::FindEncoder no encoder for %s, fall back to mpeg4", avcodec_get_name(codecId));
+        encoder = avcodec_find_encoder(AV_CODEC_ID_MPEG4);
+    }
+    LOGCATE("EncoderConfig::FindEncoder encoder=%s", encoder != nullptr ? encoder->name : "null");
+    return encoder;
+}
+
+void EncoderConfig::Apply(AVCodecContext *ctx, int fps, long defaultBitRate) const {
+    bool isX264 = ctx->codec != nullptr && strcmp(ctx->codec->name, "libx264") == 0;
+    long targetBitRate = bitRate > 0 ? bitRate : defaultBitRate;
+
+    // preset/tune 先设置，下面的通用参数会覆盖其中对应的项
+    if (isX264) {
+        SetPrivOption(ctx, "preset", preset);
+        SetPrivOption(ctx, "tune", tune);
+        if (lookahead >= 0) av_opt_set_int(ctx->priv_data, "rc-lookahead", lookahead, 0);
+    }
+
+    ctx->gop_size = keyIntervalFrames > 0 ? keyIntervalFrames : fps * ENCODER_DEFAULT_KEYINT_SEC;
+    if (maxBFrames >= 0) ctx->max_b_frames = maxBFrames;
+    ctx->thread_count = threadCount;
+    // libx264 按 thread_type 决定是否使用 slice 线程，会覆盖 tune=zerolatency 的设置
+    ctx->thread_type = slicedThreads ? FF_THREAD_SLICE : FF_THREAD_FRAME;
+
+    int rc = rateControl;
+    if (rc == ENCODER_RC_CRF && !isX264) {
+        LOGCATE("EncoderConfig::Apply crf is not supported by %s, use abr", ctx->codec != nullptr ? ctx->codec->name : "null");
+        rc = ENCODER_RC_ABR;
+    }
+    long maxRate = maxBitRate;
+    switch (rc) {
+        case ENCODER_RC_CBR:
+            ctx->bit_rate = targetBitRate;
+            ctx->rc_min_rate = targetBitRate;
+            maxRate = targetBitRate;
+            break;
+        case ENCODER_RC_CRF:
+            ctx->bit_rate = 0;
+            av_opt_set_double(ctx->priv_data, "crf", crf, 0);
+            break;
+        default:
+            ctx->bit_rate = targetBitRate;
+            break;
+    }
+    if (maxRate > 0) {
+        ctx->rc_max_rate = maxRate;
+        ctx->rc_buffer_size = static_cast<int>(bufferSize > 0 ? bufferSize : maxRate);
+    }
+
+    LOGCATE("EncoderConfig::Apply encoder=%s, %s", ctx->codec != nullptr ? ctx->codec->name : "null", ToString().c_str());
+}
+
+std::string EncoderConfig::ToString() const {
+    char desc[256];
+    snprintf(desc, sizeof(desc),
+             "codec=%s, preset=%s, tune=%s, rc=%s, crf=%d, bitrate=%ld, maxrate=%ld, bufsize=%ld, "
+             "threads=%d, sliced=%d, lookahead=%d, bframes=%d, keyint=%d",
+             codec == ENCODER_CODEC_MPEG4 ? "mpeg4" : "h264", preset.c_str(), tune.c_str(),
+             GetRateControlName(rateControl), crf, bitRate, maxBitRate, bufferSize,
+             threadCount, slicedThreads, lookahead, maxBFrames, keyIntervalFrames);
+    return std::string(desc);
+}
+
+const char *EncoderConfig::GetRateControlName(int rateControl) {
+    switch (rateControl) {
+        case ENCODER_RC_CBR:
+            return "cbr";
+        case ENCODER_RC_CRF:
+            return "crf";
+        default:
+            return "abr";
+    }
+}
+
+void EncodeStats::Start(const std::string &desc, int fps) {
+    m_Desc = desc;
+    m_Fps = fps;
+    m_FrameCount = 0;
+    m_TotalCostUs = 0;
+    m_TotalBytes = 0;
+}
+
+void EncodeStats::AddFrame(int64_t costUs) {
+    m_FrameCount++;
+    m_TotalCostUs += costUs;
+    if (m_FrameCount % ENCODE_STATS_INTERVAL == 0) {
+        Report();
+    }
+}
+
+void EncodeStats::AddPacket(int size) {
+    m_TotalBytes += size;
+}
+
+void EncodeStats::Report() {
+    if (m_FrameCount == 0) return;
+    double encodeFps = m_TotalCostUs > 0 ? m_FrameCount * 1000000.0 / m_TotalCostUs : 0;
+    double bitRate = m_Fps > 0 ? m_TotalBytes * 8.0 * m_Fps / m_FrameCount : 0;
+    LOGCATE("%s frames=%ld, encode fps=%.1f, bitrate=%.0fkbps, %s", m_Name, m_FrameCount, encodeFps,
+            bitRate / 1000, m_Desc.c_str());
+}
@@ -0,0 +1,112 @@
+/**
+ *
+ * Created by 公众号：字节流动 on 2026/10/18.
+ * https://github.com/githubhaohao/LearnFFmpeg
+ * 最新文章首发于公众号：字节流动，有疑问或者技术交流可以添加微信 Byte-Flow ,领取视频教程, 拉你进技术交流群
+ *
+ * */
+
+#ifndef LEARNFFMPEG_ENCODERCONFIG_H
+#define LEARNFFMPEG_ENCODERCONFIG_H
+
+#include <string>
+#include <cstdint>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+};
+
+// 编码格式，与 Java 层 MediaRecorderContext.ENCODER_CODEC_XXX 一致
+#define ENCODER_CODEC_H264          0
+#define ENCODER_CODEC_MPEG4         1
+
+// 码率控制方式
+#define ENCODER_RC_ABR              0   // 平均码率，maxBitRate > 0 时带 VBV 上限
+#define ENCODER_RC_CBR              1   // 恒定码率，bitRate = minrate = maxrate
+#define ENCODER_RC_CRF              2   // 恒定质量（仅 x264），maxBitRate > 0 时带 VBV 上限
+
+#define ENCODER_DEFAULT_PRESET      "veryfast"
+#define ENCODER_DEFAULT_CRF         23
+#define ENCODER_DEFAULT_KEYINT_SEC  2       // 默认关键帧间隔（秒）
+#define ENCODE_STATS_INTERVAL       150     // 每编码多少帧输出一次统计
+
+/**
+ * @brief 视频编码配置，SingleVideoRecorder 和 MediaRecorder 共用，H.264 编码器不可用时退回 MPEG-4
+ * Apply 要求 AVCodecContext 由 avcodec_alloc_context3(codec) 分配，在 avcodec_open2 之前调用
+ */
+struct EncoderConfig {
+    int         codec = ENCODER_CODEC_H264;
+    std::string preset = ENCODER_DEFAULT_PRESET;   // x264 preset，空表示编码器默认
+    std::string tune;                              // x264 tune，如 zerolatency、film，空表示不设置
+    int         rateControl = ENCODER_RC_ABR;
+    int         crf = ENCODER_DEFAULT_CRF;         // ENCODER_RC_CRF 的质量参数
+    long        bitRate = 0;                       // 目标码率，0 表示使用录制器的码率
+    long        maxBitRate = 0;                    // VBV 最大码率，0 表示不限制（CBR 时等于 bitRate）
+    long        bufferSize = 0;                    // VBV 缓冲大小（bit），0 表示取 1 秒的最大码率
+    int         threadCount = 0;                   // 编码线程数，0 表示自动
+    bool        slicedThreads = false;             // 使用 slice 线程，延迟低但压缩率略差
+    int         lookahead = -1;                    // x264 rc-lookahead 帧数，-1 表示 preset 默认
+    int         maxBFrames = -1;                   // 最大连续 B 帧数，-1 表示编码器默认
+    int         keyIntervalFrames = 0;             // 关键帧间隔（帧），0 表示 ENCODER_DEFAULT_KEYINT_SEC 秒
+
+    /**
+     * @brief 查找编码器
+     * @param oformat 输出格式，用于检查容器是否支持该编码格式，可为 nullptr
+     * @return 编码器，H.264 优先 libx264；都不可用时返回 nullptr
+     */
+    AVCodec *FindEncoder(const AVOutputFormat *oformat) const;
+
+    /**
+     * @brief 把配置写入编码器上下文
+     * @param ctx 已设置宽高、时间基的编码器上下文
+     * @param fps 帧率，用于换算默认关键帧间隔
+     * @param defaultBitRate 录制器的码率，bitRate 为 0 时使用
+     */
+    void Apply(AVCodecContext *ctx, int fps, long defaultBitRate) const;
+
+    /**
+     * @brief 配置的文字描述，用于日志
+     */
+    std::string ToString() const;
+
+    static const char *GetRateControlName(int rateControl);
+};
+
+/**
+ * @brief 编码统计，输出每个配置的编码帧率和实际码率
+ *
+ * 编码帧率按每帧从 avcodec_send_frame 到取完输出包（含写入封装）的累计耗时计算，
+ * 不包括格式转换；码率按输出包大小和帧数换算
+ */
+class EncodeStats {
+public:
+    explicit EncodeStats(const char *name) : m_Name(name) {}
+
+    /**
+     * @brief 开始统计，清空计数
+     * @param desc 配置描述，见 EncoderConfig::ToString
+     * @param fps 帧率
+     */
+    void Start(const std::string &desc, int fps);
+
+    void AddFrame(int64_t costUs);
+
+    void AddPacket(int size);
+
+    /**
+     * @brief 输出当前累计的统计
+     */
+    void Report();
+
+private:
+    const char *m_Name;
+    std::string m_Desc;
+    int         m_Fps = 0;
+    long        m_FrameCount = 0;
+    int64_t     m_TotalCostUs = 0;
+    int64_t     m_TotalBytes = 0;
+};
+
+
+#endif //LEARNFFMPEG_ENCODERCONFIG_H
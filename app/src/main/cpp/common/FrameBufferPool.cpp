@@ -0,0 +1,181 @@
+/**
+ *
+ * Created by 公众号：字节流动 on 2026/10/18.
+ * https://github.com/githubhaohao/LearnFFmpeg
+ * 最新文章首发于公众号：字节流动，有疑问或者技术交流可以添加微信 Byte-Flow ,领取视频教程, 拉你进技术交流群
+ *
+ * */
+
+#include <sys/resource.h>
+#include <LogUtil.h>
+#include "FrameBufferPool.h"
+
+extern "C" {
+#include <libavutil/imgutils.h>
+#include <libavutil/pixdesc.h>
+};
+
+static uint8_t *DefaultAlloc(void *, int size) {
+    return static_cast<uint8_t *>(av_malloc(size));
+}
+
+static void DefaultFree(void *, uint8_t *data) {
+    av_free(data);
+}
+
+FrameBufferPool::FrameBufferPool(const FrameBufferAllocator *allocator) {
+    if (allocator != nullptr && allocator->alloc != nullptr && allocator->free != nullptr) {
+        m_Allocator = *allocator;
+    } else {
+        m_Allocator.opaque = nullptr;
+        m_Allocator.alloc = DefaultAlloc;
+        m_Allocator.free = DefaultFree;
+    }
+    m_FrameCount = 0;
+    m_RequestCount = 0;
+    m_AllocCount = 0;
+    m_FreeCount = 0;
+}
+
+FrameBufferPool::~FrameBufferPool() {
+    DumpStats("FrameBufferPool::~FrameBufferPool");
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    //池中仍被引用的缓冲会在最后一次 unref 时释放
+    for (auto &it : m_Pools) {
+        av_buffer_pool_uninit(&it.second);
+    }
+    m_Pools.clear();
+}
+
+void FrameBufferPool::Attach(AVCodecContext *codecCtx) {
+    if (codecCtx == nullptr) return;
+    codecCtx->opaque = this;
+    codecCtx->get_buffer2 = GetBuffer2;
+    //允许帧线程在各自的线程中直接申请缓冲，AVBufferPool 本身是线程安全的
+    codecCtx->thread_safe_callbacks = 1;
+}
+
+void FrameBufferPool::DumpStats(const char *tag) {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    int64_t requestCount = m_RequestCount;
+    int64_t allocCount = m_AllocCount;
+    int64_t freeCount = m_FreeCount;
+    LOGCATE("%s [request, alloc, free, live]=[%lld, %lld, %lld, %lld], hit=%.2f%%, page faults[minor, major]=[%ld, %ld], peak rss=%ldKB",
+            tag, (long long) requestCount, (long long) allocCount, (long long) freeCount,
+            (long long) (allocCount - freeCount),
+            requestCount > 0 ? (requestCount - allocCount) * 100.0 / requestCount : 0.0,
+            usage.ru_minflt, usage.ru_majflt, usage.ru_maxrss);
+}
+
+int FrameBufferPool::GetBuffer2(AVCodecContext *codecCtx, AVFrame *frame, int flags) {
+    FrameBufferPool *pool = static_cast<FrameBufferPool *>(codecCtx->opaque);
+    if (pool == nullptr || codecCtx->codec_type != AVMEDIA_TYPE_VIDEO ||
+        !(codecCtx->codec->capabilities & AV_CODEC_CAP_DR1)) {
+        return avcodec_default_get_buffer2(codecCtx, frame, flags);
+    }
+
+    const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(static_cast<AVPixelFormat>(frame->format));
+    if (desc == nullptr || desc->flags & (AV_PIX_FMT_FLAG_HWACCEL | AV_PIX_FMT_FLAG_PAL | AV_PIX_FMT_FLAG_BITSTREAM)) {
+        return avcodec_default_get_buffer2(codecCtx, frame, flags);
+    }
+
+    int ret = pool->GetVideoBuffer(codecCtx, frame);
+    if (ret < 0) {
+        LOGCATE("FrameBufferPool::GetBuffer2 fall back to default allocator. ret=%d", ret);
+        return avcodec_default_get_buffer2(codecCtx, frame, flags);
+    }
+    return 0;
+}
+
+int FrameBufferPool::GetVideoBuffer(AVCodecContext *codecCtx, AVFrame *frame) {
+    AVPixelFormat pixFmt = static_cast<AVPixelFormat>(frame->format);
+    int w = frame->width;
+    int h = frame->height;
+    int linesizeAlign[AV_NUM_DATA_POINTERS];
+    int linesize[4] = {0};
+    uint8_t *data[4] = {nullptr};
+    int planeSize[4] = {0};
+
+    //解码器要求的宽高对齐（宏块边界、运动补偿越界等）
+    avcodec_align_dimensions2(codecCtx, &w, &h, linesizeAlign);
+
+    //逐步增大宽度，直到所有平面行宽同时满足解码器和 GL 上传的对齐要求
+    int unaligned = 0;
+    do {
+        int ret = av_image_fill_linesizes(linesize, pixFmt, w);
+        if (ret < 0) return ret;
+        w += w & ~(w - 1);
+        unaligned = 0;
+        for (int i = 0; i < 4; i++) {
+            unaligned |= linesize[i] % FFMAX(linesizeAlign[i], FRAME_STRIDE_ALIGN);
+        }
+    } while (unaligned);
+
+    int totalSize = av_image_fill_pointers(data, pixFmt, h, nullptr, linesize);
+    if (totalSize < 0) return totalSize;
+
+    int i = 0;
+    for (; i < 3 && data[i + 1]; i++) {
+        planeSize[i] = static_cast<int>(data[i + 1] - data[i]);
+    }
+    planeSize[i] = static_cast<int>(totalSize - (data[i] - data[0]));
+
+    memset(frame->data, 0, sizeof(frame->data));
+    for (i = 0; i < 4 && planeSize[i] > 0; i++) {
+        //多申请一些尾部空间，部分 SIMD 解码函数会越界读取
+        AVBufferPool *bufferPool = GetPool(planeSize[i] + 16 + FRAME_STRIDE_ALIGN - 1);
+        if (bufferPool == nullptr) {
+            av_frame_unref(frame);
+            return AVERROR(ENOMEM);
+        }
+        frame->buf[i] = av_buffer_pool_get(bufferPool);
+        if (frame->buf[i] == nullptr) {
+            av_frame_unref(frame);
+            return AVERROR(ENOMEM);
+        }
+        frame->data[i] = frame->buf[i]->data;
+        frame->linesize[i] = linesize[i];
+        m_RequestCount++;
+    }
+    frame->extended_data = frame->data;
+
+    if (++m_FrameCount % FRAME_POOL_STATS_INTERVAL == 0) {
+        DumpStats("FrameBufferPool::GetVideoBuffer");
+    }
+    return 0;
+}
+
+AVBufferPool *FrameBufferPool::GetPool(int size) {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    auto it = m_Pools.find(size);
+    if (it != m_Pools.end()) {
+        return it->second;
+    }
+    AVBufferPool *bufferPool = av_buffer_pool_init2(size, this, AllocBuffer, nullptr);
+    if (bufferPool != nullptr) {
+        m_Pools[size] = bufferPool;
+        LOGCATE("FrameBufferPool::GetPool new pool size=%d, pool count=%d", size, (int) m_Pools.size());
+    }
+    return bufferPool;
+}
+
+AVBufferRef *FrameBufferPool::AllocBuffer(void *opaque, int size) {
+    FrameBufferPool *pool = static_cast<FrameBufferPool *>(opaque);
+    uint8_t *data = pool->m_Allocator.alloc(pool->m_Allocator.opaque, size);
+    if (data == nullptr) return nullptr;
+
+    AVBufferRef *buf = av_buffer_create(data, size, FreeBuffer, pool, 0);
+    if (buf == nullptr) {
+        pool->m_Allocator.free(pool->m_Allocator.opaque, data);
+        return nullptr;
+    }
+    pool->m_AllocCount++;
+    return buf;
+}
+
+void FrameBufferPool::FreeBuffer(void *opaque, uint8_t *data) {
+    FrameBufferPool *pool = static_cast<FrameBufferPool *>(opaque);
+    pool->m_Allocator.free(pool->m_Allocator.opaque, data);
+    pool->m_FreeCount++;
+}
@@ -0,0 +1,96 @@
+/**
+ *
+ * Created by 公众号：字节流动 on 2026/10/18.
+ * https://github.com/githubhaohao/LearnFFmpeg
+ * 最新文章首发于公众号：字节流动，有疑问或者技术交流可以添加微信 Byte-Flow ,领取视频教程, 拉你进技术交流群
+ *
+ * */
+
+#ifndef LEARNFFMPEG_FRAMEBUFFERPOOL_H
+#define LEARNFFMPEG_FRAMEBUFFERPOOL_H
+
+#include <map>
+#include <mutex>
+#include <atomic>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavutil/buffer.h>
+};
+
+// 平面行宽对齐字节数：64 字节同时满足 SIMD、cache line 以及任意 GL_UNPACK_ALIGNMENT(1/2/4/8)
+#define FRAME_STRIDE_ALIGN        64
+// 每分配多少帧打印一次内存统计
+#define FRAME_POOL_STATS_INTERVAL 600
+
+/**
+ * @brief 帧缓冲内存分配器
+ * 默认使用 av_malloc，可替换为可映射的内存（例如 GL 线程提供的 PBO 映射内存）
+ */
+struct FrameBufferAllocator {
+    void *opaque;                                    // 分配器上下文
+    uint8_t *(*alloc)(void *opaque, int size);       // 分配一块 size 字节的内存
+    void (*free)(void *opaque, uint8_t *data);       // 释放内存
+};
+
+/**
+ * @brief 解码器帧缓冲池
+ *
+ * 作为 AVCodecContext 的 get_buffer2 回调，按平面大小维护一组 AVBufferPool：
+ * - 解码出来的帧复用池中的内存，避免每帧 malloc/free
+ * - 每个平面的行宽按 FRAME_STRIDE_ALIGN 对齐，渲染端可直接通过
+ *   GL_UNPACK_ROW_LENGTH 上传，无需逐行重排
+ * - 统计分配次数、缺页次数和峰值 RSS，便于观察长时间播放的内存表现
+ *
+ * 注意：缓冲池的生命周期必须长于解码器上下文以及所有引用池内存的 AVFrame
+ */
+class FrameBufferPool {
+public:
+    FrameBufferPool(const FrameBufferAllocator *allocator = nullptr);
+
+    ~FrameBufferPool();
+
+    /**
+     * @brief 将缓冲池挂接到解码器上下文，需在 avcodec_open2 之前调用
+     * @param codecCtx 解码器上下文
+     */
+    void Attach(AVCodecContext *codecCtx);
+
+    /**
+     * @brief 打印分配统计以及进程的缺页次数、峰值 RSS
+     * @param tag 日志标识
+     */
+    void DumpStats(const char *tag);
+
+    int64_t GetRequestCount() {
+        return m_RequestCount;
+    }
+
+    int64_t GetAllocCount() {
+        return m_AllocCount;
+    }
+
+private:
+    static int GetBuffer2(AVCodecContext *codecCtx, AVFrame *frame, int flags);
+
+    static AVBufferRef *AllocBuffer(void *opaque, int size);
+
+    static void FreeBuffer(void *opaque, uint8_t *data);
+
+    int GetVideoBuffer(AVCodecContext *codecCtx, AVFrame *frame);
+
+    AVBufferPool *GetPool(int size);
+
+private:
+    FrameBufferAllocator      m_Allocator;
+    std::mutex                m_Mutex;
+    std::map<int, AVBufferPool *> m_Pools;          // 按缓冲区大小索引的缓冲池
+
+    std::atomic<int64_t>      m_FrameCount;         // 分配的视频帧数
+    std::atomic<int64_t>      m_RequestCount;       // 从池中申请缓冲的次数
+    std::atomic<int64_t>      m_AllocCount;         // 实际分配内存的次数（池未命中）
+    std::atomic<int64_t>      m_FreeCount;          // 实际释放内存的次数
+};
+
+
+#endif //LEARNFFMPEG_FRAMEBUFFERPOOL_H
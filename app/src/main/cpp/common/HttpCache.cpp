@@ -0,0 +1,662 @@
+/**
+ *
+ * Created by 公众号：字节流动 on 2026/10/18.
+ * https://github.com/githubhaohao/LearnFFmpeg
+ * 最新文章首发于公众号：字节流动，有疑问或者技术交流可以添加微信 Byte-Flow ,领取视频教程, 拉你进技术交流群
+ *
+ * */
+
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <utime.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <functional>
+#include <LogUtil.h>
+#include "HttpCache.h"
+
+extern "C" {
+#include <libavutil/time.h>
+#include <libavutil/intreadwrite.h>
+};
+
+static const char HTTP_CACHE_INDEX_MAGIC[4] = {'H', 'C', 'I', 'X'};
+
+std::mutex HttpCache::s_Mutex;
+std::condition_variable HttpCache::s_Cond;
+std::string HttpCache::s_CacheDir;
+std::map<std::string, std::weak_ptr<HttpCache>> HttpCache::s_Caches;
+
+static std::string GetCacheKey(const char *url) {
+    char key[32] = {0};
+    snprintf(key, sizeof(key), "%016llx", (unsigned long long) std::hash<std::string>()(url));
+    return key;
+}
+
+void HttpCache::SetCacheDir(const char *dir) {
+    std::unique_lock<std::mutex> lock(s_Mutex);
+    s_CacheDir = dir != nullptr && dir[0] != '\0' ? std::string(dir) + "/" HTTP_CACHE_SUB_DIR : "";
+    LOGCATE("HttpCache::SetCacheDir %s", s_CacheDir.c_str());
+}
+
+bool HttpCache::IsCacheableUrl(const char *url) {
+    if (url == nullptr) return false;
+    if (strncmp(url, "http://", 7) != 0 && strncmp(url, "https://", 8) != 0) return false;
+    //播放列表和清单会变化，分片由 FFmpeg 另外打开，不缓存
+    return strstr(url, ".m3u8") == nullptr && strstr(url, ".mpd") == nullptr;
+}
+
+std::shared_ptr<HttpCache> HttpCache::Acquire(const char *url, const AVIOInterruptCB *interruptCB) {
+    //只根据 url 判断，不满足条件时不发起任何网络请求
+    if (!IsCacheableUrl(url)) return nullptr;
+
+    std::unique_lock<std::mutex> lock(s_Mutex);
+    if (s_CacheDir.empty()) return nullptr;
+    std::string key = GetCacheKey(url);
+    for (auto it = s_Caches.find(key); it != s_Caches.end(); it = s_Caches.find(key)) {
+        std::shared_ptr<HttpCache> cache = it->second.lock();
+        if (cache) {
+            //哈希冲突的另一个 url 不缓存
+            return cache->m_Url == url ? cache : nullptr;
+        }
+        //最后一个读取方刚刚释放，等它保存完索引
+        s_Cond.wait(lock);
+    }
+
+    //在 s_Mutex 内打开：音频和视频解码器同时打开同一个 url 时，后来的等待第一个打开完成后直接共享
+    HttpCache *cache = new HttpCache(url, s_CacheDir, interruptCB);
+    if (!cache->Open()) {
+        delete cache;
+        return nullptr;
+    }
+    //不能缓存的资源直接读取探测时建立的连接，每个读取方各自一个实例，不登记
+    if (cache->m_Passthrough) {
+        return std::shared_ptr<HttpCache>(cache);
+    }
+    std::shared_ptr<HttpCache> result(cache, Release);
+    s_Caches[key] = result;
+    return result;
+}
+
+void HttpCache::Release(HttpCache *cache) {
+    std::unique_lock<std::mutex> lock(s_Mutex);
+    std::string key = cache->m_Key;
+    delete cache;
+    auto it = s_Caches.find(key);
+    if (it != s_Caches.end() && it->second.expired()) {
+        s_Caches.erase(it);
+    }
+    s_Cond.notify_all();
+}
+
+HttpCache::HttpCache(const char *url, const std::string &cacheDir, const AVIOInterruptCB *interruptCB) {
+    m_Url = url;
+    m_Key = GetCacheKey(url);
+    m_CacheDir = cacheDir;
+    m_DataPath = m_CacheDir + "/" + m_Key + ".data";
+    m_IndexPath = m_CacheDir + "/" + m_Key + ".idx";
+    if (interruptCB != nullptr) {
+        m_OpenInterruptCB = *interruptCB;
+    } else {
+        m_OpenInterruptCB.callback = nullptr;
+        m_OpenInterruptCB.opaque = nullptr;
+    }
+    m_Abort = false;
+}
+
+HttpCache::~HttpCache() {
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_Abort = true;
+        m_Cond.notify_all();
+    }
+    for (int i = 0; i < HTTP_CACHE_CONNECTIONS; i++) {
+        if (m_FetchThreads[i] != nullptr) {
+            m_FetchThreads[i]->join();
+            delete m_FetchThreads[i];
+            m_FetchThreads[i] = nullptr;
+        }
+    }
+
+    if (m_DataFd >= 0) {
+        SaveIndex();
+        close(m_DataFd);
+        m_DataFd = -1;
+    }
+
+    for (int i = 0; i < HTTP_CACHE_CONNECTIONS; i++) {
+        if (m_Upstream[i] != nullptr) {
+            avio_closep(&m_Upstream[i]);
+        }
+    }
+
+    int64_t total = m_HitBytes + m_MissBytes;
+    LOGCATE("HttpCache::~HttpCache url=%s, hit rate=%.2f%%, [hit, miss, network]=[%lld, %lld, %lld]B, miss wait=%lldms, cached blocks on open=%lld/%lld, range requests=%lld",
+            m_Url.c_str(), total > 0 ? m_HitBytes * 100.0 / total : 0.0,
+            (long long) m_HitBytes, (long long) m_MissBytes, (long long) m_NetworkBytes,
+            (long long) m_MissWaitUs / 1000, (long long) m_CachedBlocksOnOpen, (long long) m_BlockCount, (long long) m_RangeRequests);
+}
+
+bool HttpCache::Open() {
+    m_OpenTime = av_gettime_relative();
+    AVIOInterruptCB upstreamCB = {UpstreamInterruptCallback, this};
+    int result = avio_open2(&m_Upstream[0], m_Url.c_str(), AVIO_FLAG_READ, &upstreamCB, nullptr);
+    if (result < 0) {
+        LOGCATE("HttpCache::Open avio_open2 fail. result=%d", result);
+        return false;
+    }
+
+    m_RangeRequests++;
+
+    //打开之后网络读取只看读取方的中断回调，打开方可能先于其他读取方释放
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_OpenInterruptCB.callback = nullptr;
+        m_OpenInterruptCB.opaque = nullptr;
+    }
+
+    //只缓存长度已知且可以按 Range 读取的资源（直播的 http-flv 等长度未知），
+    //其他情况以及缓存文件无法创建时都直接读取这个连接，不必让 FFmpeg 再连一次
+    m_ContentLength = avio_size(m_Upstream[0]);
+    if (m_ContentLength <= 0 || !(m_Upstream[0]->seekable & AVIO_SEEKABLE_NORMAL)) {
+        LOGCATE("HttpCache::Open not cacheable, length=%lld, seekable=%d", (long long) m_ContentLength, m_Upstream[0]->seekable);
+        m_Passthrough = true;
+        return true;
+    }
+
+    mkdir(m_CacheDir.c_str(), 0755);
+    EvictLRU(m_CacheDir, m_Key);
+
+    m_DataFd = open(m_DataPath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (m_DataFd < 0) {
+        LOGCATE("HttpCache::Open fail to open %s", m_DataPath.c_str());
+        m_Passthrough = true;
+        return true;
+    }
+
+    m_BlockCount = (m_ContentLength + HTTP_CACHE_BLOCK_SIZE - 1) / HTTP_CACHE_BLOCK_SIZE;
+    m_Blocks.assign(static_cast<size_t>(m_BlockCount), BLOCK_MISSING);
+    LoadIndex();
+    m_CachedBlocksOnOpen = std::count(m_Blocks.begin(), m_Blocks.end(), (uint8_t) BLOCK_CACHED);
+    if (m_CachedBlocksOnOpen == 0) {
+        //按资源长度建立稀疏文件，未下载的区间不占磁盘
+        if (ftruncate(m_DataFd, m_ContentLength) != 0) {
+            LOGCATE("HttpCache::Open ftruncate fail.");
+            close(m_DataFd);
+            m_DataFd = -1;
+            m_Passthrough = true;
+            return true;
+        }
+    }
+    //更新最近使用时间
+    utime(m_IndexPath.c_str(), nullptr);
+
+    //文件头和读取位置的预读同时进行，头部缓存后再根据 box 布局添加其他预取区间
+    AddPrefetchRange("head", 0, FFMIN(m_ContentLength, (int64_t) HTTP_CACHE_PREFETCH_HEAD));
+    for (int i = 0; i < HTTP_CACHE_CONNECTIONS; i++) {
+        m_FetchThreads[i] = new std::thread(FetchThreadProc, this, i);
+    }
+    LOGCATE("HttpCache::Open url=%s, length=%lld, cached blocks=%lld/%lld", m_Url.c_str(),
+            (long long) m_ContentLength, (long long) m_CachedBlocksOnOpen, (long long) m_BlockCount);
+    return true;
+}
+
+void HttpCache::LoadIndex() {
+    FILE *fp = fopen(m_IndexPath.c_str(), "rb");
+    if (fp == nullptr) return;
+
+    do {
+        char magic[4] = {0};
+        int32_t version = 0, blockSize = 0, urlLength = 0;
+        int64_t contentLength = 0, blockCount = 0;
+        if (fread(magic, sizeof(magic), 1, fp) != 1 || memcmp(magic, HTTP_CACHE_INDEX_MAGIC, sizeof(magic)) != 0) break;
+        if (fread(&version, sizeof(version), 1, fp) != 1 || version != HTTP_CACHE_INDEX_VERSION) break;
+        if (fread(&contentLength, sizeof(contentLength), 1, fp) != 1 || contentLength != m_ContentLength) break;
+        if (fread(&blockSize, sizeof(blockSize), 1, fp) != 1 || blockSize != HTTP_CACHE_BLOCK_SIZE) break;
+        if (fread(&urlLength, sizeof(urlLength), 1, fp) != 1 || urlLength != (int32_t) m_Url.size()) break;
+        std::string url(static_cast<size_t>(urlLength), '\0');
+        if (urlLength > 0 && fread(&url[0], urlLength, 1, fp) != 1) break;
+        if (url != m_Url) break;
+        if (fread(&blockCount, sizeof(blockCount), 1, fp) != 1 || blockCount != m_BlockCount) break;
+        std::vector<uint8_t> blocks(static_cast<size_t>(blockCount));
+        if (blockCount > 0 && fread(blocks.data(), blocks.size(), 1, fp) != 1) break;
+        m_Blocks.swap(blocks);
+    } while (false);
+
+    fclose(fp);
+}
+
+void HttpCache::SaveIndex() {
+    std::string tmpPath = m_IndexPath + ".tmp";
+    FILE *fp = fopen(tmpPath.c_str(), "wb");
+    if (fp == nullptr) return;
+
+    bool result = true;
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        int32_t version = HTTP_CACHE_INDEX_VERSION;
+        int32_t blockSize = HTTP_CACHE_BLOCK_SIZE;
+        int32_t urlLength = static_cast<int32_t>(m_Url.size());
+        result &= fwrite(HTTP_CACHE_INDEX_MAGIC, sizeof(HTTP_CACHE_INDEX_MAGIC), 1, fp) == 1;
+        result &= fwrite(&version, sizeof(version), 1, fp) == 1;
+        result &= fwrite(&m_ContentLength, sizeof(m_ContentLength), 1, fp) == 1;
+        result &= fwrite(&blockSize, sizeof(blockSize), 1, fp) == 1;
+        result &= fwrite(&urlLength, sizeof(urlLength), 1, fp) == 1;
+        result &= fwrite(m_Url.data(), m_Url.size(), 1, fp) == 1;
+        result &= fwrite(&m_BlockCount, sizeof(m_BlockCount), 1, fp) == 1;
+        if (m_BlockCount > 0) {
+            //下载中的块按未缓存保存
+            std::vector<uint8_t> blocks(m_Blocks);
+            std::replace(blocks.begin(), blocks.end(), (uint8_t) BLOCK_FETCHING, (uint8_t) BLOCK_MISSING);
+            result &= fwrite(blocks.data(), blocks.size(), 1, fp) == 1;
+        }
+    }
+    result &= fclose(fp) == 0;
+    //数据先落盘再更新索引，避免索引标记了没有写入的数据
+    fsync(m_DataFd);
+    if (!result || rename(tmpPath.c_str(), m_IndexPath.c_str()) != 0) {
+        remove(tmpPath.c_str());
+    }
+}
+
+void HttpCache::EvictLRU(const std::string &cacheDir, const std::string &keepKey) {
+    struct CacheEntry {
+        std::string key;
+        int64_t size;
+        time_t lastUse;
+    };
+    std::vector<CacheEntry> entries;
+    int64_t totalSize = 0;
+
+    DIR *dir = opendir(cacheDir.c_str());
+    if (dir == nullptr) return;
+    struct dirent *ent = nullptr;
+    while ((ent = readdir(dir)) != nullptr) {
+        std::string name = ent->d_name;
+        size_t dot = name.rfind(".data");
+        if (dot == std::string::npos || dot + 5 != name.size()) continue;
+        std::string key = name.substr(0, dot);
+        struct stat dataStat, indexStat;
+        std::string dataPath = cacheDir + "/" + name;
+        std::string indexPath = cacheDir + "/" + key + ".idx";
+        if (stat(dataPath.c_str(), &dataStat) != 0) continue;
+        //稀疏文件按实际占用的磁盘块计算
+        CacheEntry entry = {key, (int64_t) dataStat.st_blocks * 512,
+                            stat(indexPath.c_str(), &indexStat) == 0 ? indexStat.st_mtime : 0};
+        totalSize += entry.size;
+        //正在使用的缓存不参与淘汰（调用时持有 s_Mutex）
+        if (key != keepKey && s_Caches.find(key) == s_Caches.end()) entries.push_back(entry);
+    }
+    closedir(dir);
+
+    std::sort(entries.begin(), entries.end(), [](const CacheEntry &a, const CacheEntry &b) {
+        return a.lastUse < b.lastUse;
+    });
+    for (size_t i = 0; i < entries.size() && totalSize > HTTP_CACHE_MAX_SIZE; i++) {
+        remove((cacheDir + "/" + entries[i].key + ".data").c_str());
+        remove((cacheDir + "/" + entries[i].key + ".idx").c_str());
+        totalSize -= entries[i].size;
+        LOGCATE("HttpCache::EvictLRU remove %s, size=%lld", entries[i].key.c_str(), (long long) entries[i].size);
+    }
+}
+
+void HttpCache::FetchThreadProc(HttpCache *cache, int index) {
+    LOGCATE("HttpCache::FetchThreadProc start, index=%d", index);
+    cache->FetchLoop(index);
+    LOGCATE("HttpCache::FetchThreadProc end, index=%d", index);
+}
+
+int HttpCache::UpstreamInterruptCallback(void *ctx) {
+    HttpCache *cache = static_cast<HttpCache *>(ctx);
+    return cache->IsUpstreamInterrupted() ? 1 : 0;
+}
+
+bool HttpCache::IsInterrupted(const Reader *reader) {
+    return reader->interruptCB.callback != nullptr && reader->interruptCB.callback(reader->interruptCB.opaque) != 0;
+}
+
+bool HttpCache::IsUpstreamInterrupted() {
+    if (m_Abort) return true;
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    if (m_Readers.empty()) {
+        return m_OpenInterruptCB.callback != nullptr && m_OpenInterruptCB.callback(m_OpenInterruptCB.opaque) != 0;
+    }
+    for (Reader *reader : m_Readers) {
+        if (!IsInterrupted(reader)) return false;
+    }
+    return true;
+}
+
+HttpCache::Reader *HttpCache::AddReader(const AVIOInterruptCB *interruptCB) {
+    Reader *reader = new Reader();
+    reader->pos = 0;
+    reader->readPos = 0;
+    if (interruptCB != nullptr) {
+        reader->interruptCB = *interruptCB;
+    } else {
+        reader->interruptCB.callback = nullptr;
+        reader->interruptCB.opaque = nullptr;
+    }
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_Readers.push_back(reader);
+    m_Cond.notify_all();
+    return reader;
+}
+
+void HttpCache::RemoveReader(Reader *reader) {
+    if (reader == nullptr) return;
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_Readers.erase(std::remove(m_Readers.begin(), m_Readers.end(), reader), m_Readers.end());
+        m_Cond.notify_all();
+    }
+    delete reader;
+}
+
+void HttpCache::FetchLoop(int index) {
+    uint8_t *buffer = static_cast<uint8_t *>(av_malloc(HTTP_CACHE_BLOCK_SIZE));
+    if (buffer == nullptr) return;
+
+    while (!m_Abort) {
+        int64_t first = 0;
+        int count = 0;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            //文件头缓存后（包括上次播放已缓存）解析一次 box 布局
+            if (!m_HeadParsed && m_Blocks[0] == BLOCK_CACHED) {
+                m_HeadParsed = true;
+                lock.unlock();
+                ScheduleMp4Prefetch();
+                continue;
+            }
+            count = ClaimBlocks(&first);
+            if (count == 0) {
+                //m_Abort 在锁内设置，这里再检查一次避免错过析构时的通知
+                if (!m_Abort) m_Cond.wait(lock);
+                continue;
+            }
+        }
+
+        //认领的块在同一个 Range 请求中顺序读取
+        int fetched = 0, result = 0;
+        for (; fetched < count && !m_Abort; fetched++) {
+            result = FetchBlock(index, first + fetched, buffer);
+            if (result < 0) break;
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_Blocks[first + fetched] = BLOCK_CACHED;
+            m_NetworkBytes += result;
+            m_FetchError = 0;
+            m_FetchErrorCount = 0;
+            CheckPrefetchRanges();
+            m_Cond.notify_all();
+        }
+
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        for (int i = fetched; i < count; i++) {
+            m_Blocks[first + i] = BLOCK_MISSING;
+        }
+        if (result < 0) {
+            if (m_Abort) break;
+            m_FetchError = result;
+            if (result != AVERROR_EXIT) m_FetchErrorCount++;
+            m_Cond.notify_all();
+            //网络错误或被中断（停止、seek），稍后重试
+            m_Cond.wait_for(lock, std::chrono::milliseconds(100));
+        }
+    }
+    av_free(buffer);
+}
+
+int HttpCache::ClaimBlocks(int64_t *first) {
+    int64_t start = -1, end = 0;
+    auto windowEnd = [this](const Reader *reader) {
+        return FFMIN(m_BlockCount, (reader->readPos + HTTP_CACHE_READ_AHEAD) / HTTP_CACHE_BLOCK_SIZE + 1);
+    };
+
+    for (size_t i = 0; start < 0 && i < m_Readers.size(); i++) {
+        int64_t readBlock = m_Readers[i]->readPos / HTTP_CACHE_BLOCK_SIZE;
+        if (readBlock < m_BlockCount && m_Blocks[readBlock] == BLOCK_MISSING) {
+            start = readBlock;
+            end = windowEnd(m_Readers[i]);
+        }
+    }
+    for (size_t i = 0; start < 0 && i < m_PrefetchRanges.size(); i++) {
+        const PrefetchRange &range = m_PrefetchRanges[i];
+        for (int64_t j = range.beginBlock; j < range.endBlock; j++) {
+            if (m_Blocks[j] == BLOCK_MISSING) {
+                start = j;
+                end = range.endBlock;
+                break;
+            }
+        }
+    }
+    for (size_t i = 0; start < 0 && i < m_Readers.size(); i++) {
+        int64_t readEnd = windowEnd(m_Readers[i]);
+        for (int64_t j = m_Readers[i]->readPos / HTTP_CACHE_BLOCK_SIZE; start < 0 && j < readEnd; j++) {
+            if (m_Blocks[j] == BLOCK_MISSING) {
+                start = j;
+                end = readEnd;
+            }
+        }
+    }
+    if (start < 0) return 0;
+
+    int count = 0;
+    while (count < HTTP_CACHE_FETCH_RUN && start + count < end && m_Blocks[start + count] == BLOCK_MISSING) {
+        m_Blocks[start + count] = BLOCK_FETCHING;
+        count++;
+    }
+    *first = start;
+    return count;
+}
+
+int HttpCache::FetchBlock(int index, int64_t block, uint8_t *buffer) {
+    //除第一个连接外，其他连接在第一次使用时建立
+    if (m_Upstream[index] == nullptr) {
+        AVIOInterruptCB upstreamCB = {UpstreamInterruptCallback, this};
+        int result = avio_open2(&m_Upstream[index], m_Url.c_str(), AVIO_FLAG_READ, &upstreamCB, nullptr);
+        if (result < 0) {
+            LOGCATE("HttpCache::FetchBlock avio_open2 fail. index=%d, result=%d", index, result);
+            return result;
+        }
+        m_UpstreamPos[index] = 0;
+        m_RangeRequests++;
+    }
+
+    AVIOContext *upstream = m_Upstream[index];
+    int64_t offset = block * HTTP_CACHE_BLOCK_SIZE;
+    int length = static_cast<int>(FFMIN((int64_t) HTTP_CACHE_BLOCK_SIZE, m_ContentLength - offset));
+    if (m_UpstreamPos[index] != offset) {
+        int64_t pos = avio_seek(upstream, offset, SEEK_SET);
+        if (pos < 0) {
+            LOGCATE("HttpCache::FetchBlock avio_seek fail. offset=%lld, result=%lld", (long long) offset, (long long) pos);
+            m_UpstreamPos[index] = -1;
+            return static_cast<int>(pos);
+        }
+        m_UpstreamPos[index] = offset;
+        m_RangeRequests++;
+    }
+
+    int size = avio_read(upstream, buffer, length);
+    if (size != length) {
+        LOGCATE("HttpCache::FetchBlock avio_read fail. block=%lld, size=%d", (long long) block, size);
+        m_UpstreamPos[index] = -1;
+        return size < 0 ? size : AVERROR(EIO);
+    }
+    m_UpstreamPos[index] += size;
+
+    if (pwrite(m_DataFd, buffer, size, offset) != size) {
+        LOGCATE("HttpCache::FetchBlock pwrite fail. block=%lld", (long long) block);
+        return AVERROR(EIO);
+    }
+    return size;
+}
+
+void HttpCache::ScheduleMp4Prefetch() {
+    uint8_t *head = static_cast<uint8_t *>(av_malloc(HTTP_CACHE_BLOCK_SIZE));
+    if (head == nullptr) return;
+    ssize_t headSize = pread(m_DataFd, head, HTTP_CACHE_BLOCK_SIZE, 0);
+
+    //遍历顶层 box，mdat 之后才出现 moov（或 mdat 后面还有数据）时预取尾部
+    int64_t offset = 0;
+    while (headSize > 0 && offset + 8 <= headSize) {
+        const uint8_t *box = head + offset;
+        int64_t boxSize = AV_RB32(box);
+        uint32_t type = AV_RL32(box + 4);
+        int headerSize = 8;
+        if (boxSize == 1) {
+            if (offset + 16 > headSize) break;
+            boxSize = static_cast<int64_t>(AV_RB64(box + 8));
+            headerSize = 16;
+        } else if (boxSize == 0) {
+            boxSize = m_ContentLength - offset;
+        }
+        if (boxSize < headerSize || offset + boxSize > m_ContentLength) break;
+
+        if (type == MKTAG('m', 'o', 'o', 'v')) {
+            //moov 在文件头，按顺序读取即可
+            break;
+        }
+        if (type == MKTAG('m', 'd', 'a', 't')) {
+            int64_t mdatStart = offset + headerSize;
+            int64_t tailStart = offset + boxSize;
+            if (tailStart < m_ContentLength) {
+                AddPrefetchRange("moov", tailStart, FFMIN(m_ContentLength, tailStart + HTTP_CACHE_PREFETCH_TAIL));
+            }
+            AddPrefetchRange("mdat", mdatStart, FFMIN(tailStart, mdatStart + HTTP_CACHE_PREFETCH_MDAT));
+            break;
+        }
+        offset += boxSize;
+    }
+    av_free(head);
+}
+
+void HttpCache::AddPrefetchRange(const char *name, int64_t begin, int64_t end) {
+    if (begin >= end) return;
+    PrefetchRange range;
+    range.name = name;
+    range.beginBlock = begin / HTTP_CACHE_BLOCK_SIZE;
+    range.endBlock = (end + HTTP_CACHE_BLOCK_SIZE - 1) / HTTP_CACHE_BLOCK_SIZE;
+    range.startTime = av_gettime_relative();
+    range.done = false;
+    LOGCATE("HttpCache::AddPrefetchRange %s [%lld, %lld)", name, (long long) begin, (long long) end);
+
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_PrefetchRanges.push_back(range);
+    CheckPrefetchRanges();
+    m_Cond.notify_all();
+}
+
+void HttpCache::CheckPrefetchRanges() {
+    for (size_t i = 0; i < m_PrefetchRanges.size(); i++) {
+        PrefetchRange &range = m_PrefetchRanges[i];
+        if (range.done) continue;
+        int64_t j = range.beginBlock;
+        while (j < range.endBlock && m_Blocks[j] == BLOCK_CACHED) j++;
+        if (j < range.endBlock) continue;
+        range.done = true;
+        int64_t now = av_gettime_relative();
+        LOGCATE("HttpCache::CheckPrefetchRanges %s done, cost=%lldms, since open=%lldms", range.name,
+                (long long) (now - range.startTime) / 1000, (long long) (now - m_OpenTime) / 1000);
+    }
+}
+
+bool HttpCache::IsSeekable() {
+    return !m_Passthrough || (m_Upstream[0]->seekable & AVIO_SEEKABLE_NORMAL);
+}
+
+int HttpCache::Read(Reader *reader, uint8_t *buf, int size) {
+    if (m_Passthrough) {
+        //有多少返回多少，直播流不必等缓冲区填满
+        int result = avio_read_partial(m_Upstream[0], buf, size);
+        if (result == 0) return AVERROR_EOF;
+        if (result > 0) {
+            reader->pos += result;
+            m_NetworkBytes += result;
+        }
+        return result;
+    }
+
+    if (reader->pos >= m_ContentLength) return AVERROR_EOF;
+
+    int64_t block = reader->pos / HTTP_CACHE_BLOCK_SIZE;
+    bool miss = false;
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        //进入新的块时通知预读线程跟随
+        if (block != reader->readPos / HTTP_CACHE_BLOCK_SIZE) {
+            reader->readPos = reader->pos;
+            m_Cond.notify_all();
+        }
+
+        if (m_Blocks[block] != BLOCK_CACHED) {
+            int64_t waitStart = av_gettime_relative();
+            while (m_Blocks[block] != BLOCK_CACHED) {
+                if (m_Abort || IsInterrupted(reader)) return AVERROR_EXIT;
+                //偶发的网络错误由预读线程重新认领该块重试，连续失败多次才认为无法恢复
+                if (m_FetchErrorCount >= HTTP_CACHE_MAX_FETCH_ERRORS) {
+                    LOGCATE("HttpCache::Read block=%lld fetch fail %d times, error=%d", (long long) block,
+                            m_FetchErrorCount, m_FetchError);
+                    int error = m_FetchError < 0 ? m_FetchError : AVERROR(EIO);
+                    m_FetchError = 0;
+                    m_FetchErrorCount = 0;
+                    return error;
+                }
+                m_Cond.wait_for(lock, std::chrono::milliseconds(20));
+            }
+            m_MissWaitUs += av_gettime_relative() - waitStart;
+            miss = true;
+        }
+    }
+
+    //每次最多读到当前块的末尾
+    int64_t blockEnd = FFMIN(m_ContentLength, (block + 1) * HTTP_CACHE_BLOCK_SIZE);
+    int length = static_cast<int>(FFMIN((int64_t) size, blockEnd - reader->pos));
+    ssize_t result = pread(m_DataFd, buf, length, reader->pos);
+    if (result <= 0) {
+        return AVERROR(EIO);
+    }
+    reader->pos += result;
+    if (miss) {
+        m_MissBytes += result;
+    } else {
+        m_HitBytes += result;
+    }
+    return static_cast<int>(result);
+}
+
+int64_t HttpCache::Seek(Reader *reader, int64_t offset, int whence) {
+    if (m_Passthrough) {
+        if ((whence & ~AVSEEK_FORCE) == AVSEEK_SIZE) return avio_size(m_Upstream[0]);
+        int64_t pos = avio_seek(m_Upstream[0], offset, whence);
+        if (pos >= 0) reader->pos = pos;
+        return pos;
+    }
+
+    int64_t pos = 0;
+    switch (whence & ~AVSEEK_FORCE) {
+        case AVSEEK_SIZE:
+            return m_ContentLength;
+        case SEEK_SET:
+            pos = offset;
+            break;
+        case SEEK_CUR:
+            pos = reader->pos + offset;
+            break;
+        case SEEK_END:
+            pos = m_ContentLength + offset;
+            break;
+        default:
+            return AVERROR(EINVAL);
+    }
+    if (pos < 0 || pos > m_ContentLength) return AVERROR(EINVAL);
+
+    reader->pos = pos;
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    reader->readPos = pos;
+    m_Cond.notify_all();
+    return pos;
+}
@@ -0,0 +1,238 @@
+/**
+ *
+ * Created by 公众号：字节流动 on 2026/10/18.
+ * https://github.com/githubhaohao/LearnFFmpeg
+ * 最新文章首发于公众号：字节流动，有疑问或者技术交流可以添加微信 Byte-Flow ,领取视频教程, 拉你进技术交流群
+ *
+ * */
+
+#ifndef LEARNFFMPEG_HTTPCACHE_H
+#define LEARNFFMPEG_HTTPCACHE_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+
+extern "C" {
+#include <libavformat/avformat.h>
+};
+
+// 是否开启 http 磁盘缓存，置 0 时直接使用 FFmpeg 的 http 协议
+#define HTTP_CACHE_ENABLE        1
+// 缓存目录，位于 Java 层通过 SetCacheDir 传入的应用缓存目录下
+#define HTTP_CACHE_SUB_DIR       "http_cache"
+// 缓存总大小上限，超过后按最近使用时间淘汰
+#define HTTP_CACHE_MAX_SIZE      (512LL * 1024 * 1024)
+// 缓存块大小，按块记录哪些字节区间已经缓存
+#define HTTP_CACHE_BLOCK_SIZE    (256 * 1024)
+// 后台线程在读取位置之前预读的字节数
+#define HTTP_CACHE_READ_AHEAD    (16 * 1024 * 1024)
+// 索引文件格式版本
+#define HTTP_CACHE_INDEX_VERSION 1
+// 并发下载的连接数，每个连接独立发起 Range 请求
+#define HTTP_CACHE_CONNECTIONS   3
+// 每个连接一次认领的连续块数，连续块只需要一次 Range 请求
+#define HTTP_CACHE_FETCH_RUN     8
+// 打开时并发预取的文件头长度
+#define HTTP_CACHE_PREFETCH_HEAD (512 * 1024)
+// moov 在文件尾部时，并发预取的 mdat 起始数据长度（约前几秒的音视频数据）
+#define HTTP_CACHE_PREFETCH_MDAT (4 * 1024 * 1024)
+// 尾部 moov 预取的最大长度，超过时只取这么多，剩余部分按需读取
+#define HTTP_CACHE_PREFETCH_TAIL (16 * 1024 * 1024)
+// 读取等待的块连续下载失败多少次后才向 FFmpeg 返回错误，之前由预读线程重试
+#define HTTP_CACHE_MAX_FETCH_ERRORS 5
+
+/**
+ * @brief http 媒体的磁盘缓存
+ *
+ * 作为 MediaSource 的数据来源，为 http(s) 点播文件提供：
+ * - 稀疏磁盘缓存：数据文件按原始偏移写入（稀疏文件），块位图记录已缓存的区间，关闭时保存索引，
+ *   下次播放同一 url 时已缓存的区间直接从本地读取
+ * - 后台预读：多个连接并发在当前读取位置之后按块下载，读取跳转后跟随到新位置
+ * - 打开加速：MP4 的 moov 在文件尾部时，解析文件头的 box 得到 moov 和 mdat 的位置，
+ *   并发预取文件尾部的 moov 和 mdat 起始数据，avformat_find_stream_info 直接从本地读取，
+ *   不必等待“读头 -> 跳到尾部 -> 跳回 mdat”三次串行的请求
+ * - 按最近使用时间淘汰，缓存目录总大小不超过 HTTP_CACHE_MAX_SIZE
+ * - 同一个 url 只有一个实例，音频和视频解码器各自作为一个读取方共享下载线程、连接和块位图
+ *
+ * 只对长度已知且支持 Range 请求的资源生效：m3u8 按 url 直接交给 FFmpeg 处理，
+ * 探测后才知道不能缓存的资源（如直播的 http-flv）直接读取探测时建立的连接
+ */
+class HttpCache {
+public:
+    // 一个读取方（一个 AVIOContext）的读取位置和中断回调
+    struct Reader {
+        int64_t         pos;                 // 读取位置，只在读取线程中使用
+        int64_t         readPos;             // 预读线程跟随的读取位置，由 m_Mutex 保护
+        AVIOInterruptCB interruptCB;         // 封装格式上下文的中断回调，停止或 seek 时中断阻塞的读取
+    };
+
+    /**
+     * @brief 设置缓存所在的目录（应用的缓存目录），未设置时不缓存
+     */
+    static void SetCacheDir(const char *dir);
+
+    /**
+     * @brief 只根据 url 判断是否可能缓存（http/https，不是 m3u8/mpd 清单），不访问网络
+     */
+    static bool IsCacheableUrl(const char *url);
+
+    /**
+     * @brief 获取 url 对应的缓存，同一个 url 的读取方共享一个实例
+     * 探测后发现不能缓存（长度未知、不支持 Range）时返回直接读取探测连接的实例，不再另外建立连接
+     * @param url http(s) 地址
+     * @param interruptCB 打开时的中断回调
+     * @return url 不满足缓存条件或者连接失败时返回 nullptr
+     */
+    static std::shared_ptr<HttpCache> Acquire(const char *url, const AVIOInterruptCB *interruptCB);
+
+    ~HttpCache();
+
+    /**
+     * @brief 添加一个读取方，从头开始读取
+     * @param interruptCB 读取方的中断回调，可为 nullptr
+     */
+    Reader *AddReader(const AVIOInterruptCB *interruptCB);
+
+    void RemoveReader(Reader *reader);
+
+    /**
+     * @brief 读取方的 AVIOContext 是否可以 seek，直接读取探测连接时与网络连接一致
+     */
+    bool IsSeekable();
+
+    /**
+     * @brief 读取数据，数据未缓存时等待预读线程下载
+     * @return 读取的字节数，或 AVERROR
+     */
+    int Read(Reader *reader, uint8_t *buf, int size);
+
+    /**
+     * @brief 跳转读取位置，语义与 AVIOContext 的 seek 回调相同
+     */
+    int64_t Seek(Reader *reader, int64_t offset, int whence);
+
+private:
+    HttpCache(const char *url, const std::string &cacheDir, const AVIOInterruptCB *interruptCB);
+
+    bool Open();
+
+    void LoadIndex();
+
+    void SaveIndex();
+
+    /**
+     * @brief 按最近使用时间淘汰缓存，直到总大小不超过上限
+     * @param cacheDir 缓存目录
+     * @param keepKey 当前要打开的缓存，不参与淘汰
+     */
+    static void EvictLRU(const std::string &cacheDir, const std::string &keepKey);
+
+    /**
+     * @brief 最后一个读取方释放后，在 s_Mutex 内保存索引并从登记表中移除，
+     * 同一个 url 再次打开时一定能读到完整的索引
+     */
+    static void Release(HttpCache *cache);
+
+    static void FetchThreadProc(HttpCache *cache, int index);
+
+    static int UpstreamInterruptCallback(void *ctx);
+
+    void FetchLoop(int index);
+
+    /**
+     * @brief 认领一段连续的未缓存块，调用时需持有 m_Mutex
+     * 优先级：各读取方读取位置所在的块 > 打开时的预取区间 > 各读取方预读窗口内的其他块
+     * @return 认领的块数，0 表示没有需要下载的块
+     */
+    int ClaimBlocks(int64_t *first);
+
+    int FetchBlock(int index, int64_t block, uint8_t *buffer);
+
+    /**
+     * @brief 文件头缓存后解析 MP4 顶层 box，moov 在 mdat 之后时添加尾部和 mdat 起始的预取区间
+     */
+    void ScheduleMp4Prefetch();
+
+    void AddPrefetchRange(const char *name, int64_t begin, int64_t end);
+
+    /**
+     * @brief 块下载完成后检查预取区间是否已完成，调用时需持有 m_Mutex
+     */
+    void CheckPrefetchRanges();
+
+    /**
+     * @brief 读取方的中断回调是否要求中断
+     */
+    static bool IsInterrupted(const Reader *reader);
+
+    /**
+     * @brief 网络读取是否中断：析构，或者所有读取方都要求中断（没有读取方时看打开时的中断回调），
+     * 只要还有读取方在等数据就继续下载。调用时不能持有 m_Mutex
+     */
+    bool IsUpstreamInterrupted();
+
+private:
+    // 块状态
+    enum {
+        BLOCK_MISSING = 0,
+        BLOCK_CACHED = 1,
+        BLOCK_FETCHING = 2,
+    };
+
+    // 打开时并发预取的区间
+    struct PrefetchRange {
+        const char *name;
+        int64_t     beginBlock;
+        int64_t     endBlock;
+        int64_t     startTime;               // 添加区间的时间（微秒）
+        bool        done;
+    };
+
+    static std::mutex   s_Mutex;
+    static std::condition_variable s_Cond;
+    static std::string  s_CacheDir;
+    static std::map<std::string, std::weak_ptr<HttpCache>> s_Caches;  // 按缓存文件名登记的实例
+
+    std::string         m_Url;
+    std::string         m_Key;               // url 的哈希，作为缓存文件名
+    std::string         m_CacheDir;
+    std::string         m_DataPath;          // 数据文件（稀疏文件）
+    std::string         m_IndexPath;         // 索引文件（块位图）
+    int                 m_DataFd = -1;
+    AVIOContext        *m_Upstream[HTTP_CACHE_CONNECTIONS] = {nullptr};  // 每个下载线程的网络输入
+    int64_t             m_UpstreamPos[HTTP_CACHE_CONNECTIONS] = {0};      // 网络输入的当前位置
+    AVIOInterruptCB     m_OpenInterruptCB;   // 打开时的中断回调
+    std::vector<Reader *> m_Readers;
+    int64_t             m_ContentLength = 0;
+    int64_t             m_BlockCount = 0;
+    std::vector<uint8_t> m_Blocks;           // 块状态，BLOCK_MISSING/BLOCK_CACHED/BLOCK_FETCHING
+    std::vector<PrefetchRange> m_PrefetchRanges;
+    bool                m_HeadParsed = false;  // 是否已经解析文件头
+    bool                m_Passthrough = false; // 不能缓存，直接读取探测连接 m_Upstream[0]
+
+    int                 m_FetchError = 0;    // 预读线程最近一次的错误
+    int                 m_FetchErrorCount = 0; // 预读线程连续失败的次数，下载成功后清零
+
+    std::mutex          m_Mutex;
+    std::condition_variable m_Cond;
+    std::thread        *m_FetchThreads[HTTP_CACHE_CONNECTIONS] = {nullptr};
+    std::atomic<bool>   m_Abort;
+
+    // 统计
+    std::atomic<int64_t> m_HitBytes{0};      // 直接命中缓存的字节数
+    std::atomic<int64_t> m_MissBytes{0};     // 需要等待下载的字节数
+    int64_t             m_MissWaitUs = 0;    // 等待下载的总时长
+    int64_t             m_NetworkBytes = 0;  // 从网络下载的字节数
+    int64_t             m_CachedBlocksOnOpen = 0; // 打开时已缓存的块数
+    int64_t             m_OpenTime = 0;      // 打开时间（微秒）
+    std::atomic<int64_t> m_RangeRequests{0}; // 发起的 Range 请求数
+};
+
+
+#endif //LEARNFFMPEG_HTTPCACHE_H
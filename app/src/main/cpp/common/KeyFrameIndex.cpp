@@ -0,0 +1,288 @@
+/**
+ *
+ * Created by 公众号：字节流动 on 2026/10/18.
+ * https://github.com/githubhaohao/LearnFFmpeg
+ * 最新文章首发于公众号：字节流动，有疑问或者技术交流可以添加微信 Byte-Flow ,领取视频教程, 拉你进技术交流群
+ *
+ * */
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+#include <algorithm>
+#include <LogUtil.h>
+#include "KeyFrameIndex.h"
+#include "MediaSource.h"
+
+extern "C" {
+#include <libavutil/time.h>
+};
+
+static const char KEY_FRAME_INDEX_MAGIC[4] = {'K', 'F', 'I', 'X'};
+
+std::mutex KeyFrameIndex::s_Mutex;
+std::map<std::string, std::weak_ptr<KeyFrameIndex>> KeyFrameIndex::s_Indexes;
+
+std::shared_ptr<KeyFrameIndex> KeyFrameIndex::Acquire(const char *url) {
+    //只处理本地文件，网络流没有稳定的文件大小和修改时间
+    struct stat fileStat;
+    if (url == nullptr || stat(url, &fileStat) != 0 || !S_ISREG(fileStat.st_mode)) {
+        return nullptr;
+    }
+
+    std::unique_lock<std::mutex> lock(s_Mutex);
+    for (auto it = s_Indexes.begin(); it != s_Indexes.end();) {
+        if (it->second.expired()) {
+            it = s_Indexes.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    auto it = s_Indexes.find(url);
+    if (it != s_Indexes.end()) {
+        std::shared_ptr<KeyFrameIndex> index = it->second.lock();
+        if (index) return index;
+    }
+
+    std::shared_ptr<KeyFrameIndex> index(new KeyFrameIndex(url));
+    index->m_FileSize = fileStat.st_size;
+    index->m_FileMTime = fileStat.st_mtime;
+    index->m_Thread = new std::thread(BuildThreadProc, index.get());
+    s_Indexes[url] = index;
+    return index;
+}
+
+KeyFrameIndex::KeyFrameIndex(const char *url) {
+    m_Url = url;
+    m_SidecarPath = m_Url + KEY_FRAME_INDEX_SUFFIX;
+    m_Ready = false;
+    m_Abort = false;
+}
+
+KeyFrameIndex::~KeyFrameIndex() {
+    m_Abort = true;
+    if (m_Thread != nullptr) {
+        m_Thread->join();
+        delete m_Thread;
+        m_Thread = nullptr;
+    }
+}
+
+bool KeyFrameIndex::Lookup(int streamIndex, int64_t targetUs, KeyFrameEntry *entry) {
+    if (!m_Ready) return false;
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    auto it = m_Entries.find(streamIndex);
+    if (it == m_Entries.end() || it->second.empty()) return false;
+
+    std::vector<KeyFrameEntry> &entries = it->second;
+    auto upper = std::upper_bound(entries.begin(), entries.end(), targetUs,
+                                  [](int64_t timeUs, const KeyFrameEntry &e) {
+                                      return timeUs < e.timeUs;
+                                  });
+    //目标在第一个关键帧之前，从第一个关键帧开始
+    *entry = upper == entries.begin() ? entries.front() : *(upper - 1);
+    return true;
+}
+
+int KeyFrameIndex::Seek(AVFormatContext *fmtCtx, int streamIndex, int64_t targetUs) {
+    KeyFrameEntry entry;
+    if (fmtCtx == nullptr || !Lookup(streamIndex, targetUs, &entry)) return -1;
+    int result = av_seek_frame(fmtCtx, -1, entry.pos, AVSEEK_FLAG_BYTE);
+    LOGCATE("KeyFrameIndex::Seek target=%lldus, keyframe=%lldus, pos=%lld, result=%d",
+            (long long) targetUs, (long long) entry.timeUs, (long long) entry.pos, result);
+    return result;
+}
+
+void KeyFrameIndex::BuildThreadProc(KeyFrameIndex *index) {
+    //Linux 上 nice 值是线程级别的，who=0 只降低当前线程的优先级
+    setpriority(PRIO_PROCESS, 0, KEY_FRAME_INDEX_THREAD_NICE);
+
+    int64_t startTime = av_gettime_relative();
+    bool loaded = index->LoadSidecar();
+    if (!loaded && index->Build() == 0) {
+        index->SaveSidecar();
+    }
+
+    size_t entryCount = 0;
+    {
+        std::unique_lock<std::mutex> lock(index->m_Mutex);
+        for (auto &it : index->m_Entries) {
+            entryCount += it.second.size();
+        }
+    }
+    index->m_Ready = entryCount > 0;
+    LOGCATE("KeyFrameIndex::BuildThreadProc url=%s, fromSidecar=%d, entries=%d, cost=%lldms",
+            index->m_Url.c_str(), loaded, (int) entryCount, (long long) (av_gettime_relative() - startTime) / 1000);
+}
+
+int KeyFrameIndex::InterruptCallback(void *ctx) {
+    KeyFrameIndex *index = static_cast<KeyFrameIndex *>(ctx);
+    return index->m_Abort ? 1 : 0;
+}
+
+int KeyFrameIndex::Build() {
+    int result = -1;
+    AVFormatContext *fmtCtx = avformat_alloc_context();
+    AVPacket *packet = nullptr;
+    MediaSource *source = nullptr;
+    std::map<int, std::vector<KeyFrameEntry>> entries;
+    do {
+        fmtCtx->interrupt_callback.callback = InterruptCallback;
+        fmtCtx->interrupt_callback.opaque = this;
+        if (MediaSource::Open(&fmtCtx, m_Url.c_str(), NULL, &source) != 0) {
+            LOGCATE("KeyFrameIndex::Build avformat_open_input fail.");
+            break;
+        }
+
+        //MP4 等格式自带索引且不支持字节 seek，不需要建索引；
+        //返回空索引，由调用方写入不含索引点的旁路文件，下次打开时直接加载，不再重新打开文件判断格式
+        if (fmtCtx->iformat->flags & AVFMT_NO_BYTE_SEEK) {
+            LOGCATE("KeyFrameIndex::Build format %s does not support byte seek, save empty index.", fmtCtx->iformat->name);
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_Entries.clear();
+            result = 0;
+            break;
+        }
+
+        if (avformat_find_stream_info(fmtCtx, NULL) < 0) {
+            LOGCATE("KeyFrameIndex::Build avformat_find_stream_info fail.");
+            break;
+        }
+
+        //视频流只需要关键帧，让 demuxer 提前丢弃其他数据包
+        for (unsigned int i = 0; i < fmtCtx->nb_streams; i++) {
+            if (fmtCtx->streams[i]->codecpar->codec_type == AVMEDIA_TYPE_VIDEO) {
+                fmtCtx->streams[i]->discard = AVDISCARD_NONKEY;
+            }
+        }
+
+        packet = av_packet_alloc();
+        while (!m_Abort && av_read_frame(fmtCtx, packet) >= 0) {
+            int64_t ts = packet->pts != AV_NOPTS_VALUE ? packet->pts : packet->dts;
+            if ((packet->flags & AV_PKT_FLAG_KEY) && packet->pos >= 0 && ts != AV_NOPTS_VALUE) {
+                AVStream *stream = fmtCtx->streams[packet->stream_index];
+                int64_t timeUs = av_rescale_q(ts, stream->time_base, AV_TIME_BASE_Q);
+                std::vector<KeyFrameEntry> &list = entries[packet->stream_index];
+                if (list.empty() || timeUs - list.back().timeUs >= KEY_FRAME_INDEX_MIN_INTERVAL) {
+                    KeyFrameEntry entry = {timeUs, packet->pos};
+                    list.push_back(entry);
+                }
+            }
+            av_packet_unref(packet);
+        }
+
+        if (m_Abort) {
+            LOGCATE("KeyFrameIndex::Build aborted.");
+            break;
+        }
+
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_Entries.swap(entries);
+        result = 0;
+    } while (false);
+
+    if (packet != nullptr) {
+        av_packet_free(&packet);
+    }
+    if (fmtCtx != nullptr) {
+        avformat_close_input(&fmtCtx);
+    }
+    delete source;
+    return result;
+}
+
+bool KeyFrameIndex::LoadSidecar() {
+    FILE *fp = fopen(m_SidecarPath.c_str(), "rb");
+    if (fp == nullptr) return false;
+    struct stat sidecarStat;
+    if (fstat(fileno(fp), &sidecarStat) != 0) {
+        fclose(fp);
+        return false;
+    }
+
+    bool result = false;
+    std::map<int, std::vector<KeyFrameEntry>> entries;
+    do {
+        char magic[4] = {0};
+        int32_t version = 0, streamCount = 0;
+        int64_t fileSize = 0, fileMTime = 0;
+        if (fread(magic, sizeof(magic), 1, fp) != 1 || memcmp(magic, KEY_FRAME_INDEX_MAGIC, sizeof(magic)) != 0) break;
+        if (fread(&version, sizeof(version), 1, fp) != 1 || version != KEY_FRAME_INDEX_VERSION) break;
+        if (fread(&fileSize, sizeof(fileSize), 1, fp) != 1 || fileSize != m_FileSize) break;
+        if (fread(&fileMTime, sizeof(fileMTime), 1, fp) != 1 || fileMTime != m_FileMTime) break;
+        if (fread(&streamCount, sizeof(streamCount), 1, fp) != 1 || streamCount < 0) break;
+
+        bool valid = true;
+        for (int i = 0; i < streamCount && valid; i++) {
+            int32_t streamIndex = 0, count = 0;
+            if (fread(&streamIndex, sizeof(streamIndex), 1, fp) != 1 ||
+                fread(&count, sizeof(count), 1, fp) != 1 || count < 0) {
+                valid = false;
+                break;
+            }
+            //索引点数不能超过文件剩余的长度，避免损坏的索引文件导致分配超大内存
+            long offset = ftell(fp);
+            if (offset < 0 || (int64_t) count > (sidecarStat.st_size - offset) / (int64_t) sizeof(KeyFrameEntry)) {
+                valid = false;
+                break;
+            }
+            std::vector<KeyFrameEntry> &list = entries[streamIndex];
+            list.resize(count);
+            if (count > 0 && fread(list.data(), sizeof(KeyFrameEntry), count, fp) != (size_t) count) {
+                valid = false;
+            }
+        }
+        if (!valid) break;
+
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_Entries.swap(entries);
+        result = true;
+    } while (false);
+
+    fclose(fp);
+    LOGCATE("KeyFrameIndex::LoadSidecar path=%s, result=%d", m_SidecarPath.c_str(), result);
+    return result;
+}
+
+bool KeyFrameIndex::SaveSidecar() {
+    //先写临时文件再重命名，避免中途退出留下不完整的索引
+    std::string tmpPath = m_SidecarPath + ".tmp";
+    FILE *fp = fopen(tmpPath.c_str(), "wb");
+    if (fp == nullptr) {
+        LOGCATE("KeyFrameIndex::SaveSidecar fail to open %s", tmpPath.c_str());
+        return false;
+    }
+
+    bool result = true;
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        int32_t version = KEY_FRAME_INDEX_VERSION;
+        int32_t streamCount = static_cast<int32_t>(m_Entries.size());
+        result &= fwrite(KEY_FRAME_INDEX_MAGIC, sizeof(KEY_FRAME_INDEX_MAGIC), 1, fp) == 1;
+        result &= fwrite(&version, sizeof(version), 1, fp) == 1;
+        result &= fwrite(&m_FileSize, sizeof(m_FileSize), 1, fp) == 1;
+        result &= fwrite(&m_FileMTime, sizeof(m_FileMTime), 1, fp) == 1;
+        result &= fwrite(&streamCount, sizeof(streamCount), 1, fp) == 1;
+        for (auto &it : m_Entries) {
+            int32_t streamIndex = it.first;
+            int32_t count = static_cast<int32_t>(it.second.size());
+            result &= fwrite(&streamIndex, sizeof(streamIndex), 1, fp) == 1;
+            result &= fwrite(&count, sizeof(count), 1, fp) == 1;
+            if (count > 0) {
+                result &= fwrite(it.second.data(), sizeof(KeyFrameEntry), count, fp) == (size_t) count;
+            }
+        }
+    }
+    result &= fclose(fp) == 0;
+
+    if (result) {
+        result = rename(tmpPath.c_str(), m_SidecarPath.c_str()) == 0;
+    }
+    if (!result) {
+        remove(tmpPath.c_str());
+    }
+    LOGCATE("KeyFrameIndex::SaveSidecar path=%s, result=%d", m_SidecarPath.c_str(), result);
+    return result;
+}
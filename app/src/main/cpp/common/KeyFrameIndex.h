@@ -0,0 +1,122 @@
+/**
+ *
+ * Created by 公众号：字节流动 on 2026/10/18.
+ * https://github.com/githubhaohao/LearnFFmpeg
+ * 最新文章首发于公众号：字节流动，有疑问或者技术交流可以添加微信 Byte-Flow ,领取视频教程, 拉你进技术交流群
+ *
+ * */
+
+#ifndef LEARNFFMPEG_KEYFRAMEINDEX_H
+#define LEARNFFMPEG_KEYFRAMEINDEX_H
+
+#include <map>
+#include <vector>
+#include <string>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <memory>
+
+extern "C" {
+#include <libavformat/avformat.h>
+};
+
+// 索引文件后缀，与媒体文件放在同一目录
+#define KEY_FRAME_INDEX_SUFFIX      ".kfidx"
+// 索引文件格式版本
+#define KEY_FRAME_INDEX_VERSION     1
+// 同一条流两个索引点之间的最小间隔（微秒），音频每个包都是关键帧，按间隔抽样保持索引紧凑
+#define KEY_FRAME_INDEX_MIN_INTERVAL 500000
+// 建索引线程的 nice 值，尽量不和解码、渲染线程抢 CPU
+#define KEY_FRAME_INDEX_THREAD_NICE 10
+
+/**
+ * @brief 索引点：关键帧的显示时间和所在的字节位置
+ */
+struct KeyFrameEntry {
+    int64_t timeUs;   // 时间戳（微秒，AV_TIME_BASE）
+    int64_t pos;      // 数据包在文件中的字节位置
+};
+
+/**
+ * @brief 关键帧索引
+ *
+ * MPEG-TS、FLV 以及索引不全的文件，demuxer 自身的 seek 需要二分查找甚至线性扫描，大文件上非常慢。
+ * 打开文件后在低优先级线程中扫描一遍，记录每条流的关键帧时间戳和字节位置，之后按字节位置直接 seek。
+ * - 索引以文件大小和修改时间为 key 保存为旁路文件，下次打开同一文件直接加载
+ * - 同一文件只建一份索引，音频、视频解码器通过 Acquire 共享
+ * - 只对支持字节 seek 的本地文件生效（MP4 等自带索引的格式不需要），
+ *   这类文件保存一份不含索引点的旁路文件，之后打开时只读取旁路文件，不再扫描
+ */
+class KeyFrameIndex {
+public:
+    /**
+     * @brief 获取文件对应的索引，首次获取时在后台开始建立
+     * @param url 媒体文件路径
+     * @return 索引对象，所有持有者释放后销毁
+     */
+    static std::shared_ptr<KeyFrameIndex> Acquire(const char *url);
+
+    ~KeyFrameIndex();
+
+    /**
+     * @brief 索引是否已可用
+     */
+    bool IsReady() {
+        return m_Ready;
+    }
+
+    /**
+     * @brief 查找目标时间之前（含）最近的索引点
+     * @param streamIndex 流索引
+     * @param targetUs 目标时间（微秒）
+     * @param entry 输出索引点
+     * @return 是否找到
+     */
+    bool Lookup(int streamIndex, int64_t targetUs, KeyFrameEntry *entry);
+
+    /**
+     * @brief 按索引以字节位置 seek
+     * @param fmtCtx 封装格式上下文
+     * @param streamIndex 查找索引所用的流
+     * @param targetUs 目标时间（微秒）
+     * @return 0 成功；索引未就绪或不可用时返回负数，调用方回退到 avformat_seek_file
+     */
+    int Seek(AVFormatContext *fmtCtx, int streamIndex, int64_t targetUs);
+
+private:
+    KeyFrameIndex(const char *url);
+
+    static void BuildThreadProc(KeyFrameIndex *index);
+
+    static int InterruptCallback(void *ctx);
+
+    /**
+     * @brief 扫描整个文件建立索引
+     * @return 0 成功，负数失败
+     */
+    int Build();
+
+    bool LoadSidecar();
+
+    bool SaveSidecar();
+
+private:
+    std::string              m_Url;
+    std::string              m_SidecarPath;
+    int64_t                  m_FileSize = -1;
+    int64_t                  m_FileMTime = -1;
+
+    std::mutex               m_Mutex;
+    std::map<int, std::vector<KeyFrameEntry>> m_Entries;   // 按流索引存放的索引点
+
+    std::thread             *m_Thread = nullptr;
+    std::atomic<bool>        m_Ready;
+    std::atomic<bool>        m_Abort;
+
+    static std::mutex        s_Mutex;
+    static std::map<std::string, std::weak_ptr<KeyFrameIndex>> s_Indexes;
+};
+
+
+#endif //LEARNFFMPEG_KEYFRAMEINDEX_H
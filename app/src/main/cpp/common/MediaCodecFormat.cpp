@@ -0,0 +1,143 @@
+/**
+ *
+ * Created by 公众号：字节流动 on 2026/10/18.
+ * https://github.com/githubhaohao/LearnFFmpeg
+ * 最新文章首发于公众号：字节流动，有疑问或者技术交流可以添加微信 Byte-Flow ,领取视频教程, 拉你进技术交流群
+ *
+ * */
+
+#include "MediaCodecFormat.h"
+
+extern "C" {
+#include <libavutil/intreadwrite.h>
+};
+
+static const uint8_t START_CODE[] = {0, 0, 0, 1};
+
+bool MediaCodecFormat::FromCodecParameters(const AVCodecParameters *par, MediaCodecFormat *format) {
+    const char *mime = GetMimeType(par->codec_id);
+    if (mime == nullptr) return false;
+
+    format->mime = mime;
+    format->width = par->width;
+    format->height = par->height;
+    format->csd0.clear();
+    format->csd1.clear();
+
+    const uint8_t *extradata = par->extradata;
+    int size = par->extradata_size;
+    if (extradata == nullptr || size <= 0) {
+        //没有 extradata 时参数集在码流中，由解码器自己解析
+        return true;
+    }
+
+    switch (par->codec_id) {
+        case AV_CODEC_ID_H264:
+            if (IsAnnexB(extradata, size)) {
+                SplitAnnexBAvc(extradata, size, format);
+                return true;
+            }
+            return ParseAvcC(extradata, size, format);
+        case AV_CODEC_ID_HEVC:
+            if (IsAnnexB(extradata, size)) {
+                format->csd0.assign(extradata, extradata + size);
+                return true;
+            }
+            return ParseHvcC(extradata, size, format);
+        case AV_CODEC_ID_MPEG4:
+            format->csd0.assign(extradata, extradata + size);
+            return true;
+        default:
+            return true;
+    }
+}
+
+const char *MediaCodecFormat::GetMimeType(enum AVCodecID codecId) {
+    switch (codecId) {
+        case AV_CODEC_ID_H264:       return "video/avc";
+        case AV_CODEC_ID_HEVC:       return "video/hevc";
+        case AV_CODEC_ID_MPEG4:      return "video/mp4v-es";
+        case AV_CODEC_ID_H263:       return "video/3gpp";
+        case AV_CODEC_ID_MPEG2VIDEO: return "video/mpeg2";
+        case AV_CODEC_ID_VP8:        return "video/x-vnd.on2.vp8";
+        case AV_CODEC_ID_VP9:        return "video/x-vnd.on2.vp9";
+        case AV_CODEC_ID_AV1:        return "video/av01";
+        default:                     return nullptr;
+    }
+}
+
+bool MediaCodecFormat::IsAnnexB(const uint8_t *data, int size) {
+    return (size >= 3 && AV_RB24(data) == 1) || (size >= 4 && AV_RB32(data) == 1);
+}
+
+bool MediaCodecFormat::ParseAvcC(const uint8_t *data, int size, MediaCodecFormat *format) {
+    //configurationVersion(1) profile(1) compatibility(1) level(1) lengthSizeMinusOne(1) numOfSPS(1)
+    if (size < 7 || data[0] != 1) return false;
+
+    int pos = 5;
+    for (int pass = 0; pass < 2; pass++) {
+        if (pos >= size) return false;
+        int count = pass == 0 ? (data[pos] & 0x1f) : data[pos];
+        pos++;
+        for (int i = 0; i < count; i++) {
+            if (pos + 2 > size) return false;
+            int len = AV_RB16(data + pos);
+            pos += 2;
+            if (pos + len > size) return false;
+            AppendNal(pass == 0 ? format->csd0 : format->csd1, data + pos, len);
+            pos += len;
+        }
+    }
+    return !format->csd0.empty();
+}
+
+bool MediaCodecFormat::ParseHvcC(const uint8_t *data, int size, MediaCodecFormat *format) {
+    //前 22 字节是 profile、level 等信息，之后是 numOfArrays 和参数集数组
+    if (size < 23) return false;
+
+    int pos = 22;
+    int numArrays = data[pos++];
+    for (int i = 0; i < numArrays; i++) {
+        //array_completeness(1) reserved(1) NAL_unit_type(6) numNalus(16)
+        if (pos + 3 > size) return false;
+        int numNalus = AV_RB16(data + pos + 1);
+        pos += 3;
+        for (int j = 0; j < numNalus; j++) {
+            if (pos + 2 > size) return false;
+            int len = AV_RB16(data + pos);
+            pos += 2;
+            if (pos + len > size) return false;
+            AppendNal(format->csd0, data + pos, len);
+            pos += len;
+        }
+    }
+    return !format->csd0.empty();
+}
+
+void MediaCodecFormat::SplitAnnexBAvc(const uint8_t *data, int size, MediaCodecFormat *format) {
+    int pos = 0;
+    while (pos < size) {
+        //跳过起始码
+        while (pos + 3 <= size && AV_RB24(data + pos) != 1) pos++;
+        if (pos + 3 > size) break;
+        pos += 3;
+        int start = pos;
+        //找到下一个起始码，去掉 4 字节起始码前面的 0
+        while (pos + 3 <= size && AV_RB24(data + pos) != 1) pos++;
+        int end = pos + 3 <= size ? pos : size;
+        while (end > start && data[end - 1] == 0) end--;
+        if (end <= start) continue;
+
+        int nalType = data[start] & 0x1f;
+        if (nalType == 7) {
+            AppendNal(format->csd0, data + start, end - start);
+        } else if (nalType == 8) {
+            AppendNal(format->csd1, data + start, end - start);
+        }
+    }
+}
+
+void MediaCodecFormat::AppendNal(std::vector<uint8_t> &csd, const uint8_t *nal, int size) {
+    csd.insert(csd.end(), START_CODE, START_CODE + sizeof(START_CODE));
+    csd.insert(csd.end(), nal, nal + size);
+}
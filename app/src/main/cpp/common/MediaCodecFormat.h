@@ -0,0 +1,67 @@
+/**
+ *
+ * Created by 公众号：字节流动 on 2026/10/18.
+ * https://github.com/githubhaohao/LearnFFmpeg
+ * 最新文章首发于公众号：字节流动，有疑问或者技术交流可以添加微信 Byte-Flow ,领取视频教程, 拉你进技术交流群
+ *
+ * */
+
+#ifndef LEARNFFMPEG_MEDIACODECFORMAT_H
+#define LEARNFFMPEG_MEDIACODECFORMAT_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+};
+
+/**
+ * @brief 由 FFmpeg 的 AVCodecParameters 生成 MediaCodec 的配置参数（mime、宽高、csd-0/csd-1），
+ * 不需要再用 AMediaExtractor 打开一遍文件
+ */
+struct MediaCodecFormat {
+    std::string          mime;
+    int                  width = 0;
+    int                  height = 0;
+    std::vector<uint8_t> csd0;
+    std::vector<uint8_t> csd1;
+
+    /**
+     * @brief 生成配置参数
+     * @param par 视频流的编码参数
+     * @param format 输出的配置参数
+     * @return MediaCodec 不支持该编码格式或 extradata 无法解析时返回 false
+     */
+    static bool FromCodecParameters(const AVCodecParameters *par, MediaCodecFormat *format);
+
+    /**
+     * @brief codec_id 对应的 MediaCodec mime，不支持时返回 nullptr
+     */
+    static const char *GetMimeType(enum AVCodecID codecId);
+
+    /**
+     * @brief 数据是否以 Annex B 起始码开头
+     */
+    static bool IsAnnexB(const uint8_t *data, int size);
+
+private:
+
+    static bool ParseAvcC(const uint8_t *data, int size, MediaCodecFormat *format);
+
+    static bool ParseHvcC(const uint8_t *data, int size, MediaCodecFormat *format);
+
+    /**
+     * @brief 拆分 Annex B 格式的 H.264 extradata，SPS 放入 csd-0，PPS 放入 csd-1
+     */
+    static void SplitAnnexBAvc(const uint8_t *data, int size, MediaCodecFormat *format);
+
+    /**
+     * @brief 追加起始码和 NAL 单元
+     */
+    static void AppendNal(std::vector<uint8_t> &csd, const uint8_t *nal, int size);
+};
+
+
+#endif //LEARNFFMPEG_MEDIACODECFORMAT_H
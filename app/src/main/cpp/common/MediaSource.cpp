@@ -0,0 +1,293 @@
+/**
+ *
+ * Created by 公众号：字节流动 on 2026/10/18.
+ * https://github.com/githubhaohao/LearnFFmpeg
+ * 最新文章首发于公众号：字节流动，有疑问或者技术交流可以添加微信 Byte-Flow ,领取视频教程, 拉你进技术交流群
+ *
+ * */
+
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <LogUtil.h>
+#include "MediaSource.h"
+
+extern "C" {
+#include <libavutil/time.h>
+};
+
+int MediaSource::Open(AVFormatContext **fmtCtx, const char *url, AVDictionary **options, MediaSource **source) {
+    *source = nullptr;
+    MediaSource *mediaSource = Create(url, &(*fmtCtx)->interrupt_callback);
+    if (mediaSource != nullptr) {
+        (*fmtCtx)->pb = mediaSource->m_IOContext;
+        (*fmtCtx)->flags |= AVFMT_FLAG_CUSTOM_IO;
+    }
+
+    int result = avformat_open_input(fmtCtx, url, nullptr, options);
+    if (result != 0) {
+        //自定义 IO 不会被 avformat_open_input 释放
+        delete mediaSource;
+        return result;
+    }
+    *source = mediaSource;
+    return result;
+}
+
+void MediaSource::MakeFdUrl(char *url, int size, int fd, int64_t offset, int64_t length) {
+    snprintf(url, size, MEDIA_SOURCE_FD_PREFIX "%d?offset=%lld&length=%lld", fd, (long long) offset, (long long) length);
+}
+
+MediaSource::MediaSource() {
+    m_OpenTime = av_gettime_relative();
+}
+
+MediaSource::~MediaSource() {
+    int64_t elapsed = av_gettime_relative() - m_OpenTime;
+    LOGCATE("MediaSource::~MediaSource [reads, bytes, seeks, madvise]=[%lld, %lld, %lld, %lld], avg read=%lldB, throughput=%.2fMB/s",
+            (long long) m_ReadCount, (long long) m_ReadBytes, (long long) m_SeekCount, (long long) m_AdviseCount,
+            (long long) (m_ReadCount > 0 ? m_ReadBytes / m_ReadCount : 0),
+            elapsed > 0 ? m_ReadBytes * 1.0 / elapsed : 0.0);
+
+    if (m_IOContext != nullptr) {
+        av_freep(&m_IOContext->buffer);
+        avio_context_free(&m_IOContext);
+    }
+    if (m_Cache) {
+        m_Cache->RemoveReader(m_CacheReader);
+        m_CacheReader = nullptr;
+        m_Cache.reset();
+    }
+    if (m_MapBase != nullptr) {
+        munmap(m_MapBase, m_MapSize);
+        m_MapBase = nullptr;
+    }
+    if (m_Fd >= 0) {
+        close(m_Fd);
+        m_Fd = -1;
+    }
+}
+
+MediaSource *MediaSource::Create(const char *url, const AVIOInterruptCB *interruptCB) {
+    if (url == nullptr) return nullptr;
+
+#if HTTP_CACHE_ENABLE
+    if (strncmp(url, "http://", 7) == 0 || strncmp(url, "https://", 8) == 0) {
+        std::shared_ptr<HttpCache> cache = HttpCache::Acquire(url, interruptCB);
+        if (!cache) return nullptr;
+        MediaSource *source = new MediaSource();
+        source->m_Cache = cache;
+        source->m_CacheReader = cache->AddReader(interruptCB);
+        if (!source->AllocIOContext()) {
+            delete source;
+            return nullptr;
+        }
+        source->m_IOContext->seekable = cache->IsSeekable() ? AVIO_SEEKABLE_NORMAL : 0;
+        LOGCATE("MediaSource::Create http cache url=%s, seekable=%d", url, source->m_IOContext->seekable);
+        return source;
+    }
+#endif
+
+    int fd = -1;
+    int64_t offset = 0, length = 0;
+    bool isFdUrl = strncmp(url, MEDIA_SOURCE_FD_PREFIX, strlen(MEDIA_SOURCE_FD_PREFIX)) == 0;
+    if (isFdUrl) {
+        long long o = 0, l = 0;
+        if (sscanf(url + strlen(MEDIA_SOURCE_FD_PREFIX), "%d?offset=%lld&length=%lld", &fd, &o, &l) != 3) {
+            LOGCATE("MediaSource::Create invalid fd url %s", url);
+            return nullptr;
+        }
+        offset = o;
+        length = l;
+        //调用方可以在 Open 之后关闭 fd，复制一份用于检查文件大小
+        fd = fcntl(fd, F_DUPFD_CLOEXEC, 0);
+        if (fd < 0) return nullptr;
+    } else {
+        //不走 mmap 时本地文件交给 FFmpeg 的 file 协议
+        if (!MEDIA_SOURCE_MMAP_ENABLE) return nullptr;
+        //带协议的 url 交给 FFmpeg 处理
+        const char *path = url;
+        if (strncmp(url, "file:", 5) == 0) {
+            path = url + 5;
+        } else if (strstr(url, "://") != nullptr) {
+            return nullptr;
+        }
+        fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return nullptr;
+        struct stat fileStat;
+        if (fstat(fd, &fileStat) != 0 || !S_ISREG(fileStat.st_mode)) {
+            close(fd);
+            return nullptr;
+        }
+        length = fileStat.st_size;
+    }
+
+    MediaSource *source = new MediaSource();
+    //映射成功后 fd 由 MediaSource 持有
+    bool mapped = MEDIA_SOURCE_MMAP_ENABLE && source->Map(fd, offset, length);
+    if (!mapped) {
+        //本地路径回退到 file 协议；FFmpeg 4.2 没有 fd 协议，fd 区间只能自己用 pread 读取
+        if (!isFdUrl || !source->AttachFd(fd, offset, length)) {
+            close(fd);
+            delete source;
+            return nullptr;
+        }
+    }
+
+    if (!source->AllocIOContext()) {
+        delete source;
+        return nullptr;
+    }
+    LOGCATE("MediaSource::Create url=%s, offset=%lld, length=%lld, mapped=%d", url, (long long) offset, (long long) length, mapped);
+    return source;
+}
+
+bool MediaSource::AllocIOContext() {
+    uint8_t *buffer = static_cast<uint8_t *>(av_malloc(MEDIA_SOURCE_IO_BUFFER_SIZE));
+    if (buffer == nullptr) return false;
+    m_IOContext = avio_alloc_context(buffer, MEDIA_SOURCE_IO_BUFFER_SIZE, 0, this, ReadPacket, nullptr, Seek);
+    if (m_IOContext == nullptr) {
+        av_free(buffer);
+        return false;
+    }
+    return true;
+}
+
+bool MediaSource::Map(int fd, int64_t offset, int64_t length) {
+    if (fd < 0 || offset < 0 || length <= 0) return false;
+
+    //mmap 的偏移必须按页对齐
+    int64_t pageSize = sysconf(_SC_PAGESIZE);
+    int64_t alignedOffset = offset & ~(pageSize - 1);
+    int64_t delta = offset - alignedOffset;
+    if (static_cast<uint64_t>(length + delta) > SIZE_MAX) return false;
+
+    m_MapSize = static_cast<size_t>(length + delta);
+    void *base = mmap(nullptr, m_MapSize, PROT_READ, MAP_SHARED, fd, alignedOffset);
+    if (base == MAP_FAILED) {
+        //32 位进程映射超大文件可能失败，回退到 file 协议
+        LOGCATE("MediaSource::Map mmap fail. size=%lld", (long long) m_MapSize);
+        m_MapSize = 0;
+        return false;
+    }
+    m_MapBase = static_cast<uint8_t *>(base);
+    m_Data = m_MapBase + delta;
+    m_Size = length;
+    m_Pos = 0;
+    m_Fd = fd;
+    m_Offset = offset;
+    m_CheckedEnd = 0;
+
+    madvise(m_MapBase, m_MapSize, MADV_SEQUENTIAL);
+    m_AdviseCount++;
+    Prefetch(0);
+    return true;
+}
+
+bool MediaSource::AttachFd(int fd, int64_t offset, int64_t length) {
+    if (fd < 0 || offset < 0 || length <= 0) return false;
+    m_Fd = fd;
+    m_Offset = offset;
+    m_Size = length;
+    m_Pos = 0;
+    return true;
+}
+
+void MediaSource::Prefetch(int64_t pos) {
+    if (m_MapBase == nullptr || pos >= m_Size) return;
+    //madvise 的地址必须按页对齐
+    uintptr_t pageMask = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE) - 1);
+    uint8_t *start = m_Data + pos;
+    uint8_t *alignedStart = reinterpret_cast<uint8_t *>(reinterpret_cast<uintptr_t>(start) & ~pageMask);
+    int64_t end = FFMIN(m_Size, pos + MEDIA_SOURCE_PREFETCH_SIZE);
+    madvise(alignedStart, static_cast<size_t>(m_Data + end - alignedStart), MADV_WILLNEED);
+    m_PrefetchEnd = end;
+    m_AdviseCount++;
+}
+
+bool MediaSource::CheckMapped(int64_t end) {
+    if (m_MapBase == nullptr || m_Truncated) return false;
+    if (end <= m_CheckedEnd) return true;
+
+    struct stat fileStat = {};
+    if (fstat(m_Fd, &fileStat) != 0 || fileStat.st_size - m_Offset < m_Size) {
+        LOGCATE("MediaSource::CheckMapped file truncated, size=%lld, expect=%lld, fall back to pread",
+                (long long) fileStat.st_size, (long long) (m_Offset + m_Size));
+        m_Truncated = true;
+        return false;
+    }
+    //一次确认一个预读窗口，顺序读取时每 MEDIA_SOURCE_PREFETCH_SIZE 字节只多一次 fstat
+    m_CheckedEnd = FFMIN(m_Size, end + MEDIA_SOURCE_PREFETCH_SIZE);
+    return true;
+}
+
+int MediaSource::ReadPacket(void *opaque, uint8_t *buf, int bufSize) {
+    MediaSource *source = static_cast<MediaSource *>(opaque);
+    if (source->m_Cache) {
+        int size = source->m_Cache->Read(source->m_CacheReader, buf, bufSize);
+        if (size > 0) {
+            source->m_ReadCount++;
+            source->m_ReadBytes += size;
+        }
+        return size;
+    }
+
+    int64_t remaining = source->m_Size - source->m_Pos;
+    if (remaining <= 0) return AVERROR_EOF;
+
+    int size = static_cast<int>(FFMIN(remaining, (int64_t) bufSize));
+    if (source->CheckMapped(source->m_Pos + size)) {
+        memcpy(buf, source->m_Data + source->m_Pos, size);
+    } else {
+        ssize_t n = pread(source->m_Fd, buf, size, source->m_Offset + source->m_Pos);
+        if (n < 0) return AVERROR(errno);
+        if (n == 0) return AVERROR_EOF;
+        size = static_cast<int>(n);
+    }
+    source->m_Pos += size;
+    source->m_ReadCount++;
+    source->m_ReadBytes += size;
+
+    //读到预读窗口的后半段时继续向前预读
+    if (source->m_Pos + MEDIA_SOURCE_PREFETCH_SIZE / 2 > source->m_PrefetchEnd) {
+        source->Prefetch(source->m_Pos);
+    }
+    return size;
+}
+
+int64_t MediaSource::Seek(void *opaque, int64_t offset, int whence) {
+    MediaSource *source = static_cast<MediaSource *>(opaque);
+    if (source->m_Cache) {
+        if ((whence & ~AVSEEK_FORCE) != AVSEEK_SIZE) source->m_SeekCount++;
+        return source->m_Cache->Seek(source->m_CacheReader, offset, whence);
+    }
+
+    int64_t pos = 0;
+    switch (whence & ~AVSEEK_FORCE) {
+        case AVSEEK_SIZE:
+            return source->m_Size;
+        case SEEK_SET:
+            pos = offset;
+            break;
+        case SEEK_CUR:
+            pos = source->m_Pos + offset;
+            break;
+        case SEEK_END:
+            pos = source->m_Size + offset;
+            break;
+        default:
+            return AVERROR(EINVAL);
+    }
+    if (pos < 0 || pos > source->m_Size) return AVERROR(EINVAL);
+
+    source->m_SeekCount++;
+    //跳出已预读的窗口时，在新位置重新预读
+    if (pos < source->m_PrefetchEnd - MEDIA_SOURCE_PREFETCH_SIZE || pos >= source->m_PrefetchEnd) {
+        source->Prefetch(pos);
+    }
+    source->m_Pos = pos;
+    return pos;
+}
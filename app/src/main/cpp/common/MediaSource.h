@@ -0,0 +1,114 @@
+/**
+ *
+ * Created by 公众号：字节流动 on 2026/10/18.
+ * https://github.com/githubhaohao/LearnFFmpeg
+ * 最新文章首发于公众号：字节流动，有疑问或者技术交流可以添加微信 Byte-Flow ,领取视频教程, 拉你进技术交流群
+ *
+ * */
+
+#ifndef LEARNFFMPEG_MEDIASOURCE_H
+#define LEARNFFMPEG_MEDIASOURCE_H
+
+#include <stdint.h>
+#include "HttpCache.h"
+
+extern "C" {
+#include <libavformat/avformat.h>
+};
+
+// 本地文件是否走 mmap，置 0 时回退到 FFmpeg 的 file 协议，便于对比吞吐和系统调用次数
+#define MEDIA_SOURCE_MMAP_ENABLE    1
+// fd 区间的 url 前缀，格式为 fd://<fd>?offset=<offset>&length=<length>
+#define MEDIA_SOURCE_FD_PREFIX      "fd://"
+// AVIOContext 内部缓冲区大小
+#define MEDIA_SOURCE_IO_BUFFER_SIZE (64 * 1024)
+// 每次 MADV_WILLNEED 预读的窗口大小
+#define MEDIA_SOURCE_PREFETCH_SIZE  (2 * 1024 * 1024)
+
+/**
+ * @brief 媒体输入源
+ *
+ * 两个播放器统一通过 MediaSource::Open 打开媒体：
+ * - 本地路径、fd 区间（如 AAsset_openFileDescriptor 得到的 fd/offset/length）使用 mmap 映射，
+ *   通过自定义 AVIOContext 读取，读数据不需要 read 系统调用，由缺页直接从 page cache 映射
+ * - fd 区间映射失败（或关闭 mmap）时改用 pread 读取，FFmpeg 4.2 没有可以打开它的 fd 协议
+ * - 映射区域设置 MADV_SEQUENTIAL，读取和 seek 时对前方窗口设置 MADV_WILLNEED 提前预读
+ * - 文件在映射期间被截断时，访问超出文件末尾的映射页会触发 SIGBUS。每进入一个新的预读窗口前 fstat 一次，
+ *   发现文件变短后改用 pread 读取，不再访问映射内存（两次 fstat 之间的截断仍无法完全避免）
+ * - http(s) 点播文件经 HttpCache 读取，带磁盘缓存和后台预读
+ * - 其他协议（rtsp、m3u8 等）交给 FFmpeg 自己处理
+ *
+ * 注意：AVIOContext 的缓冲区可能被 libavformat 重新分配，不能直接指向映射内存，
+ * 因此读回调仍有一次从映射区到缓冲区的 memcpy；大块读取时 avio 会直接把调用方的目标内存传给读回调
+ */
+class MediaSource {
+public:
+    /**
+     * @brief 打开媒体输入
+     * @param fmtCtx 已分配的封装格式上下文（可预先设置中断回调），失败时被释放并置空
+     * @param url 本地路径、fd://<fd>?offset=<offset>&length=<length>，或 FFmpeg 支持的其他协议
+     * @param options avformat_open_input 的选项，可为 nullptr
+     * @param source 输出自定义输入源，交给 FFmpeg 处理时为 nullptr；必须在 avformat_close_input 之后 delete
+     * @return avformat_open_input 的返回值
+     */
+    static int Open(AVFormatContext **fmtCtx, const char *url, AVDictionary **options, MediaSource **source);
+
+    /**
+     * @brief 生成 fd 区间的 url
+     * fd 只需要在 Open 期间有效，映射建立后即可关闭
+     */
+    static void MakeFdUrl(char *url, int size, int fd, int64_t offset, int64_t length);
+
+    ~MediaSource();
+
+private:
+    MediaSource();
+
+    static MediaSource *Create(const char *url, const AVIOInterruptCB *interruptCB);
+
+    bool AllocIOContext();
+
+    bool Map(int fd, int64_t offset, int64_t length);
+
+    /**
+     * @brief 不映射，直接用 pread 读取 fd 区间，成功后 fd 由 MediaSource 持有
+     */
+    bool AttachFd(int fd, int64_t offset, int64_t length);
+
+    void Prefetch(int64_t pos);
+
+    /**
+     * @brief 检查 [m_Pos, end) 是否仍在文件范围内，超出已检查的窗口时 fstat 一次
+     * @return false 表示文件已被截断，之后改用 pread 读取
+     */
+    bool CheckMapped(int64_t end);
+
+    static int ReadPacket(void *opaque, uint8_t *buf, int bufSize);
+
+    static int64_t Seek(void *opaque, int64_t offset, int whence);
+
+private:
+    AVIOContext *m_IOContext = nullptr;
+    uint8_t     *m_MapBase = nullptr;      // 映射起始地址（页对齐）
+    size_t       m_MapSize = 0;            // 映射长度
+    uint8_t     *m_Data = nullptr;         // 数据起始地址（fd 区间的 offset 处）
+    int64_t      m_Size = 0;               // 数据长度
+    int64_t      m_Pos = 0;                // 当前读取位置
+    int64_t      m_PrefetchEnd = 0;        // 已经预读到的位置
+    int          m_Fd = -1;                // 映射的文件，用于检查文件大小和截断后的 pread
+    int64_t      m_Offset = 0;             // 数据在文件中的偏移
+    int64_t      m_CheckedEnd = 0;         // 最近一次 fstat 确认过的可读范围
+    bool         m_Truncated = false;      // 文件已被截断，改用 pread（没有映射时始终用 pread）
+    std::shared_ptr<HttpCache> m_Cache;    // http 磁盘缓存，非空时读写都转给它，同一个 url 的 MediaSource 共享
+    HttpCache::Reader *m_CacheReader = nullptr; // 在共享缓存中的读取位置
+
+    // 统计，用于和 file 协议对比
+    int64_t      m_ReadCount = 0;          // 读回调次数（file 协议下每次对应一次 read 系统调用）
+    int64_t      m_ReadBytes = 0;          // 读取字节数
+    int64_t      m_SeekCount = 0;          // seek 次数
+    int64_t      m_AdviseCount = 0;        // madvise 次数
+    int64_t      m_OpenTime = 0;           // 打开时间（微秒）
+};
+
+
+#endif //LEARNFFMPEG_MEDIASOURCE_H
@@ -0,0 +1,370 @@
+/**
+ *
+ * Created by 公众号：字节流动 on 2026/10/18.
+ * https://github.com/githubhaohao/LearnFFmpeg
+ * 最新文章首发于公众号：字节流动，有疑问或者技术交流可以添加微信 Byte-Flow ,领取视频教程, 拉你进技术交流群
+ *
+ * */
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <thread>
+#include <vector>
+#include <functional>
+#include <LogUtil.h>
+#include "StreamInfoCache.h"
+#include "MediaSource.h"
+
+extern "C" {
+#include <libavutil/time.h>
+};
+
+static const char STREAM_INFO_CACHE_MAGIC[4] = {'S', 'I', 'C', 'X'};
+
+/**
+ * @brief 缓存文件中每条流的记录，字段对应 AVStream 和 AVCodecParameters
+ */
+struct StreamInfoRecord {
+    int32_t codecType;
+    int32_t codecId;
+    uint32_t codecTag;
+    int32_t format;
+    int64_t bitRate;
+    int32_t bitsPerCodedSample;
+    int32_t bitsPerRawSample;
+    int32_t profile;
+    int32_t level;
+    int32_t width;
+    int32_t height;
+    AVRational sampleAspectRatio;
+    int32_t fieldOrder;
+    int32_t colorRange;
+    int32_t colorPrimaries;
+    int32_t colorTrc;
+    int32_t colorSpace;
+    int32_t chromaLocation;
+    int32_t videoDelay;
+    uint64_t channelLayout;
+    int32_t channels;
+    int32_t sampleRate;
+    int32_t blockAlign;
+    int32_t frameSize;
+    int32_t initialPadding;
+    int32_t extradataSize;
+    AVRational timeBase;
+    AVRational avgFrameRate;
+    AVRational realFrameRate;
+    int64_t startTime;
+    int64_t duration;
+};
+
+std::mutex StreamInfoCache::s_Mutex;
+std::map<std::string, StreamInfoCache::ProbeTask *> StreamInfoCache::s_ProbeTasks;
+std::string StreamInfoCache::s_CacheDir;
+
+void StreamInfoCache::SetCacheDir(const char *dir) {
+    std::unique_lock<std::mutex> lock(s_Mutex);
+    s_CacheDir = dir != nullptr && dir[0] != '\0' ? std::string(dir) + "/" STREAM_INFO_CACHE_SUB_DIR : "";
+}
+
+int StreamInfoCache::FindStreamInfo(AVFormatContext *fmtCtx, const char *url, const char **mode) {
+#if FAST_OPEN_ENABLE
+    if (Load(fmtCtx, url)) {
+        *mode = "cache";
+        return 0;
+    }
+
+    int64_t probeSize = fmtCtx->probesize;
+    int64_t analyzeDuration = fmtCtx->max_analyze_duration;
+    fmtCtx->probesize = FAST_OPEN_PROBE_SIZE;
+    fmtCtx->max_analyze_duration = FAST_OPEN_ANALYZE_DURATION;
+    int result = avformat_find_stream_info(fmtCtx, nullptr);
+    fmtCtx->probesize = probeSize;
+    fmtCtx->max_analyze_duration = analyzeDuration;
+
+    if (result >= 0 && IsComplete(fmtCtx)) {
+        *mode = "fast";
+        if (IsAccurate(fmtCtx)) {
+            Save(fmtCtx, url);
+        } else if (url != nullptr && strncmp(url, MEDIA_SOURCE_FD_PREFIX, strlen(MEDIA_SOURCE_FD_PREFIX)) != 0) {
+            //时长或帧率不准，后台完整探测一次，下次打开直接使用（fd 在打开后会被关闭，不能后台探测）
+            std::unique_lock<std::mutex> lock(s_Mutex);
+            if (s_ProbeTasks.find(url) == s_ProbeTasks.end()) {
+                ProbeTask *task = new ProbeTask();
+                task->deadline = av_gettime_relative() + STREAM_INFO_PROBE_TIMEOUT;
+                s_ProbeTasks[url] = task;
+                task->thread = new std::thread(ProbeThreadProc, std::string(url), task);
+            }
+        }
+        return result;
+    }
+    //被停止打断时不再继续探测
+    if (result == AVERROR_EXIT) return result;
+    LOGCATE("StreamInfoCache::FindStreamInfo fast probe incomplete, result=%d, fall back to full probe", result);
+#endif
+    //已经读到的数据保留在 demuxer 的缓冲中，完整探测接着分析
+    *mode = "full";
+    int findResult = avformat_find_stream_info(fmtCtx, nullptr);
+    if (findResult >= 0) Save(fmtCtx, url);
+    return findResult;
+}
+
+std::string StreamInfoCache::GetCachePath(const char *url) {
+    std::unique_lock<std::mutex> lock(s_Mutex);
+    if (s_CacheDir.empty()) return "";
+    char key[32] = {0};
+    snprintf(key, sizeof(key), "%016llx", (unsigned long long) std::hash<std::string>()(url));
+    return s_CacheDir + "/" + key + ".sinfo";
+}
+
+bool StreamInfoCache::Load(AVFormatContext *fmtCtx, const char *url) {
+    //头部不包含流信息的格式（如 FLV、TS）在探测时才创建流，无法直接套用缓存
+    if (url == nullptr || fmtCtx->nb_streams == 0 || (fmtCtx->ctx_flags & AVFMTCTX_NOHEADER)) return false;
+    FILE *fp = fopen(GetCachePath(url).c_str(), "rb");
+    if (fp == nullptr) return false;
+    struct stat cacheStat;
+    if (fstat(fileno(fp), &cacheStat) != 0) {
+        fclose(fp);
+        return false;
+    }
+
+    bool result = false;
+    std::vector<StreamInfoRecord> records;
+    std::vector<std::vector<uint8_t>> extradatas;
+    int64_t duration = 0, startTime = 0, bitRate = 0;
+    do {
+        char magic[4] = {0};
+        int32_t version = 0, urlLength = 0, streamCount = 0;
+        int64_t fileSize = 0;
+        if (fread(magic, sizeof(magic), 1, fp) != 1 || memcmp(magic, STREAM_INFO_CACHE_MAGIC, sizeof(magic)) != 0) break;
+        if (fread(&version, sizeof(version), 1, fp) != 1 || version != STREAM_INFO_CACHE_VERSION) break;
+        if (fread(&urlLength, sizeof(urlLength), 1, fp) != 1 || urlLength != (int32_t) strlen(url)) break;
+        std::string cachedUrl(static_cast<size_t>(urlLength), '\0');
+        if (urlLength > 0 && fread(&cachedUrl[0], urlLength, 1, fp) != 1) break;
+        if (cachedUrl != url) break;
+        //文件大小变化说明内容已经更新
+        if (fread(&fileSize, sizeof(fileSize), 1, fp) != 1) break;
+        if (fileSize != (fmtCtx->pb != nullptr ? avio_size(fmtCtx->pb) : -1)) break;
+        if (fread(&duration, sizeof(duration), 1, fp) != 1) break;
+        if (fread(&startTime, sizeof(startTime), 1, fp) != 1) break;
+        if (fread(&bitRate, sizeof(bitRate), 1, fp) != 1) break;
+        if (fread(&streamCount, sizeof(streamCount), 1, fp) != 1 || streamCount != (int32_t) fmtCtx->nb_streams) break;
+
+        records.resize(static_cast<size_t>(streamCount));
+        extradatas.resize(static_cast<size_t>(streamCount));
+        int i = 0;
+        for (; i < streamCount; i++) {
+            StreamInfoRecord &record = records[i];
+            if (fread(&record, sizeof(record), 1, fp) != 1) break;
+            //extradata 不能超过文件剩余的长度，避免损坏的缓存文件导致分配超大内存
+            long offset = ftell(fp);
+            if (record.extradataSize < 0 || record.extradataSize > STREAM_INFO_MAX_EXTRADATA ||
+                offset < 0 || record.extradataSize > cacheStat.st_size - offset) break;
+            AVCodecParameters *codecpar = fmtCtx->streams[i]->codecpar;
+            if (record.codecType != codecpar->codec_type) break;
+            if (codecpar->codec_id != AV_CODEC_ID_NONE && record.codecId != codecpar->codec_id) break;
+            extradatas[i].resize(static_cast<size_t>(record.extradataSize));
+            if (record.extradataSize > 0 && fread(extradatas[i].data(), record.extradataSize, 1, fp) != 1) break;
+        }
+        result = i == streamCount;
+    } while (false);
+    fclose(fp);
+    if (!result) return false;
+
+    for (int i = 0; i < (int) records.size(); i++) {
+        const StreamInfoRecord &record = records[i];
+        AVStream *stream = fmtCtx->streams[i];
+        AVCodecParameters *codecpar = stream->codecpar;
+        codecpar->codec_id = static_cast<AVCodecID>(record.codecId);
+        codecpar->codec_tag = record.codecTag;
+        codecpar->format = record.format;
+        codecpar->bit_rate = record.bitRate;
+        codecpar->bits_per_coded_sample = record.bitsPerCodedSample;
+        codecpar->bits_per_raw_sample = record.bitsPerRawSample;
+        codecpar->profile = record.profile;
+        codecpar->level = record.level;
+        codecpar->width = record.width;
+        codecpar->height = record.height;
+        codecpar->sample_aspect_ratio = record.sampleAspectRatio;
+        codecpar->field_order = static_cast<AVFieldOrder>(record.fieldOrder);
+        codecpar->color_range = static_cast<AVColorRange>(record.colorRange);
+        codecpar->color_primaries = static_cast<AVColorPrimaries>(record.colorPrimaries);
+        codecpar->color_trc = static_cast<AVColorTransferCharacteristic>(record.colorTrc);
+        codecpar->color_space = static_cast<AVColorSpace>(record.colorSpace);
+        codecpar->chroma_location = static_cast<AVChromaLocation>(record.chromaLocation);
+        codecpar->video_delay = record.videoDelay;
+        codecpar->channel_layout = record.channelLayout;
+        codecpar->channels = record.channels;
+        codecpar->sample_rate = record.sampleRate;
+        codecpar->block_align = record.blockAlign;
+        codecpar->frame_size = record.frameSize;
+        codecpar->initial_padding = record.initialPadding;
+        //demuxer 已经读到 extradata 时以 demuxer 的为准
+        if (codecpar->extradata_size == 0 && !extradatas[i].empty()) {
+            codecpar->extradata = static_cast<uint8_t *>(av_mallocz(extradatas[i].size() + AV_INPUT_BUFFER_PADDING_SIZE));
+            if (codecpar->extradata != nullptr) {
+                memcpy(codecpar->extradata, extradatas[i].data(), extradatas[i].size());
+                codecpar->extradata_size = static_cast<int>(extradatas[i].size());
+            }
+        }
+        stream->avg_frame_rate = record.avgFrameRate;
+        stream->r_frame_rate = record.realFrameRate;
+        //时间基由 demuxer 决定，数据包的时间戳都以它为单位，不能覆盖；
+        //缓存的起始时间和时长按保存时的时间基记录，换算到当前时间基后再使用
+        bool timeBaseValid = record.timeBase.num > 0 && record.timeBase.den > 0 &&
+                             stream->time_base.num > 0 && stream->time_base.den > 0;
+        if (timeBaseValid && stream->start_time == AV_NOPTS_VALUE && record.startTime != AV_NOPTS_VALUE)
+            stream->start_time = av_rescale_q(record.startTime, record.timeBase, stream->time_base);
+        if (timeBaseValid && stream->duration == AV_NOPTS_VALUE && record.duration != AV_NOPTS_VALUE)
+            stream->duration = av_rescale_q(record.duration, record.timeBase, stream->time_base);
+    }
+    //只补充 demuxer 没有给出的值，demuxer 从文件头读到的值更可靠
+    if (fmtCtx->duration == AV_NOPTS_VALUE) fmtCtx->duration = duration;
+    if (fmtCtx->start_time == AV_NOPTS_VALUE) fmtCtx->start_time = startTime;
+    if (fmtCtx->bit_rate == 0) fmtCtx->bit_rate = bitRate;
+    return true;
+}
+
+bool StreamInfoCache::Save(AVFormatContext *fmtCtx, const char *url) {
+    if (url == nullptr || fmtCtx->nb_streams == 0) return false;
+    std::string path = GetCachePath(url);
+    if (path.empty()) return false;
+    mkdir(path.substr(0, path.rfind('/')).c_str(), 0755);
+
+    std::string tmpPath = path + ".tmp";
+    FILE *fp = fopen(tmpPath.c_str(), "wb");
+    if (fp == nullptr) return false;
+
+    int32_t version = STREAM_INFO_CACHE_VERSION;
+    int32_t urlLength = static_cast<int32_t>(strlen(url));
+    int64_t fileSize = fmtCtx->pb != nullptr ? avio_size(fmtCtx->pb) : -1;
+    int32_t streamCount = static_cast<int32_t>(fmtCtx->nb_streams);
+    bool result = true;
+    result &= fwrite(STREAM_INFO_CACHE_MAGIC, sizeof(STREAM_INFO_CACHE_MAGIC), 1, fp) == 1;
+    result &= fwrite(&version, sizeof(version), 1, fp) == 1;
+    result &= fwrite(&urlLength, sizeof(urlLength), 1, fp) == 1;
+    result &= fwrite(url, urlLength, 1, fp) == 1;
+    result &= fwrite(&fileSize, sizeof(fileSize), 1, fp) == 1;
+    result &= fwrite(&fmtCtx->duration, sizeof(fmtCtx->duration), 1, fp) == 1;
+    result &= fwrite(&fmtCtx->start_time, sizeof(fmtCtx->start_time), 1, fp) == 1;
+    result &= fwrite(&fmtCtx->bit_rate, sizeof(fmtCtx->bit_rate), 1, fp) == 1;
+    result &= fwrite(&streamCount, sizeof(streamCount), 1, fp) == 1;
+    for (int i = 0; i < streamCount; i++) {
+        AVStream *stream = fmtCtx->streams[i];
+        AVCodecParameters *codecpar = stream->codecpar;
+        StreamInfoRecord record;
+        memset(&record, 0, sizeof(record));
+        record.codecType = codecpar->codec_type;
+        record.codecId = codecpar->codec_id;
+        record.codecTag = codecpar->codec_tag;
+        record.format = codecpar->format;
+        record.bitRate = codecpar->bit_rate;
+        record.bitsPerCodedSample = codecpar->bits_per_coded_sample;
+        record.bitsPerRawSample = codecpar->bits_per_raw_sample;
+        record.profile = codecpar->profile;
+        record.level = codecpar->level;
+        record.width = codecpar->width;
+        record.height = codecpar->height;
+        record.sampleAspectRatio = codecpar->sample_aspect_ratio;
+        record.fieldOrder = codecpar->field_order;
+        record.colorRange = codecpar->color_range;
+        record.colorPrimaries = codecpar->color_primaries;
+        record.colorTrc = codecpar->color_trc;
+        record.colorSpace = codecpar->color_space;
+        record.chromaLocation = codecpar->chroma_location;
+        record.videoDelay = codecpar->video_delay;
+        record.channelLayout = codecpar->channel_layout;
+        record.channels = codecpar->channels;
+        record.sampleRate = codecpar->sample_rate;
+        record.blockAlign = codecpar->block_align;
+        record.frameSize = codecpar->frame_size;
+        record.initialPadding = codecpar->initial_padding;
+        record.extradataSize = codecpar->extradata_size;
+        record.timeBase = stream->time_base;
+        record.avgFrameRate = stream->avg_frame_rate;
+        record.realFrameRate = stream->r_frame_rate;
+        record.startTime = stream->start_time;
+        record.duration = stream->duration;
+        result &= fwrite(&record, sizeof(record), 1, fp) == 1;
+        if (codecpar->extradata_size > 0) {
+            result &= fwrite(codecpar->extradata, codecpar->extradata_size, 1, fp) == 1;
+        }
+    }
+    result &= fclose(fp) == 0;
+    if (!result || rename(tmpPath.c_str(), path.c_str()) != 0) {
+        remove(tmpPath.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool StreamInfoCache::IsComplete(AVFormatContext *fmtCtx) {
+    bool hasStream = false;
+    for (int i = 0; i < (int) fmtCtx->nb_streams; i++) {
+        AVCodecParameters *codecpar = fmtCtx->streams[i]->codecpar;
+        if (codecpar->codec_type == AVMEDIA_TYPE_VIDEO) {
+            if (codecpar->width <= 0 || codecpar->height <= 0 || codecpar->format < 0) return false;
+            hasStream = true;
+        } else if (codecpar->codec_type == AVMEDIA_TYPE_AUDIO) {
+            if (codecpar->sample_rate <= 0 || codecpar->channels <= 0 || codecpar->format < 0) return false;
+            hasStream = true;
+        }
+    }
+    return hasStream;
+}
+
+bool StreamInfoCache::IsAccurate(AVFormatContext *fmtCtx) {
+    //直播流没有时长，只检查帧率
+    bool live = fmtCtx->pb == nullptr || avio_size(fmtCtx->pb) <= 0;
+    if (!live && fmtCtx->duration == AV_NOPTS_VALUE) return false;
+    for (int i = 0; i < (int) fmtCtx->nb_streams; i++) {
+        AVStream *stream = fmtCtx->streams[i];
+        if (stream->codecpar->codec_type == AVMEDIA_TYPE_VIDEO && stream->avg_frame_rate.num == 0) return false;
+    }
+    return true;
+}
+
+void StreamInfoCache::UnInit(const char *url) {
+    if (url == nullptr) return;
+    ProbeTask *task = nullptr;
+    {
+        std::unique_lock<std::mutex> lock(s_Mutex);
+        auto it = s_ProbeTasks.find(url);
+        if (it == s_ProbeTasks.end()) return;
+        task = it->second;
+        s_ProbeTasks.erase(it);
+    }
+    JoinProbeTask(task);
+}
+
+void StreamInfoCache::JoinProbeTask(ProbeTask *task) {
+    task->stop = true;
+    task->thread->join();
+    delete task->thread;
+    delete task;
+}
+
+void StreamInfoCache::ProbeThreadProc(std::string url, ProbeTask *task) {
+    int64_t startTime = av_gettime_relative();
+    AVFormatContext *fmtCtx = avformat_alloc_context();
+    fmtCtx->interrupt_callback.callback = InterruptCallback;
+    fmtCtx->interrupt_callback.opaque = task;
+
+    int result = -1;
+    //网络流使用 FFmpeg 自己的协议，不和正在播放的 http 缓存争用缓存文件
+    if (avformat_open_input(&fmtCtx, url.c_str(), nullptr, nullptr) == 0) {
+        result = avformat_find_stream_info(fmtCtx, nullptr);
+        if (result >= 0) Save(fmtCtx, url.c_str());
+        avformat_close_input(&fmtCtx);
+    } else {
+        avformat_free_context(fmtCtx);
+    }
+    LOGCATE("StreamInfoCache::ProbeThreadProc url=%s, result=%d, stop=%d, cost=%lldms", url.c_str(), result,
+            task->stop, (long long) (av_gettime_relative() - startTime) / 1000);
+}
+
+int StreamInfoCache::InterruptCallback(void *ctx) {
+    ProbeTask *task = static_cast<ProbeTask *>(ctx);
+    return task->stop || av_gettime_relative() > task->deadline ? 1 : 0;
+}
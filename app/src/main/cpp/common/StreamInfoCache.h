@@ -0,0 +1,110 @@
+/**
+ *
+ * Created by 公众号：字节流动 on 2026/10/18.
+ * https://github.com/githubhaohao/LearnFFmpeg
+ * 最新文章首发于公众号：字节流动，有疑问或者技术交流可以添加微信 Byte-Flow ,领取视频教程, 拉你进技术交流群
+ *
+ * */
+
+#ifndef LEARNFFMPEG_STREAMINFOCACHE_H
+#define LEARNFFMPEG_STREAMINFOCACHE_H
+
+#include <map>
+#include <string>
+#include <mutex>
+#include <thread>
+
+extern "C" {
+#include <libavformat/avformat.h>
+};
+
+// 是否开启快速打开，置 0 时每次都使用默认参数完整探测
+#define FAST_OPEN_ENABLE            1
+// 快速打开的探测数据量（字节）
+#define FAST_OPEN_PROBE_SIZE        (64 * 1024)
+// 快速打开的探测时长（微秒）
+#define FAST_OPEN_ANALYZE_DURATION  500000
+// 流信息缓存目录，位于 Java 层通过 SetCacheDir 传入的应用缓存目录下
+#define STREAM_INFO_CACHE_SUB_DIR   "streaminfo"
+// 缓存文件格式版本
+#define STREAM_INFO_CACHE_VERSION   1
+// 缓存文件中单条流 extradata 的长度上限，超过时认为缓存文件已损坏
+#define STREAM_INFO_MAX_EXTRADATA   (1024 * 1024)
+// 后台完整探测的超时时间（微秒）
+#define STREAM_INFO_PROBE_TIMEOUT   30000000
+
+/**
+ * @brief 流信息缓存，用于快速打开
+ *
+ * avformat_find_stream_info 使用默认的 probesize 和 analyzeduration 时，直播流和大文件要多读、多解码
+ * 几百毫秒的数据。FindStreamInfo 按以下顺序获取流信息：
+ * 1. 上次打开同一 url 时保存的流信息（AVCodecParameters、时间基、帧率、时长），文件大小、流数量和
+ *    编码格式都一致时直接使用，不再探测
+ * 2. 使用最小的 probesize/analyzeduration 探测；音视频流的关键参数（宽高、像素格式、采样率、声道、
+ *    采样格式）齐全即可开始播放，时长或帧率缺失时在后台用独立的上下文完整探测，结果保存供下次使用
+ * 3. 关键参数不全时恢复默认参数继续完整探测
+ */
+class StreamInfoCache {
+public:
+    /**
+     * @brief 设置缓存所在的目录（应用的缓存目录），未设置时不缓存
+     */
+    static void SetCacheDir(const char *dir);
+
+    /**
+     * @brief 获取流信息，代替 avformat_find_stream_info
+     * @param fmtCtx avformat_open_input 之后的封装格式上下文
+     * @param url 媒体地址，用作缓存的 key
+     * @param mode 输出流信息的来源："cache"、"fast"、"full"，用于打印打开耗时
+     * @return avformat_find_stream_info 的返回值
+     */
+    static int FindStreamInfo(AVFormatContext *fmtCtx, const char *url, const char **mode);
+
+    /**
+     * @brief 停止 url 的后台探测并等待线程退出，播放器释放时调用
+     */
+    static void UnInit(const char *url);
+
+private:
+    /**
+     * @brief 后台完整探测任务
+     */
+    struct ProbeTask {
+        std::thread  *thread = nullptr;
+        volatile bool stop = false;    // 播放器释放时置位，中断探测
+        int64_t       deadline = 0;    // 超过该时间同样中断探测
+    };
+
+    static std::string GetCachePath(const char *url);
+
+    static bool Load(AVFormatContext *fmtCtx, const char *url);
+
+    static bool Save(AVFormatContext *fmtCtx, const char *url);
+
+    /**
+     * @brief 音视频流的关键参数是否齐全，齐全时可以打开解码器
+     */
+    static bool IsComplete(AVFormatContext *fmtCtx);
+
+    /**
+     * @brief 时长、帧率等非关键信息是否齐全
+     */
+    static bool IsAccurate(AVFormatContext *fmtCtx);
+
+    static void ProbeThreadProc(std::string url, ProbeTask *task);
+
+    /**
+     * @brief 停止并回收探测任务，调用方不能持有 s_Mutex
+     */
+    static void JoinProbeTask(ProbeTask *task);
+
+    static int InterruptCallback(void *ctx);
+
+private:
+    static std::mutex            s_Mutex;
+    static std::map<std::string, ProbeTask *> s_ProbeTasks;   // 后台探测任务，由 UnInit 回收
+    static std::string           s_CacheDir;
+};
+
+
+#endif //LEARNFFMPEG_STREAMINFOCACHE_H
@@ -0,0 +1,28 @@
+/**
+ *
+ * Created by 公众号：字节流动 on 2026/10/18.
+ * https://github.com/githubhaohao/LearnFFmpeg
+ * 最新文章首发于公众号：字节流动，有疑问或者技术交流可以添加微信 Byte-Flow ,领取视频教程, 拉你进技术交流群
+ *
+ * */
+
+#include <LogUtil.h>
+#include "WakeupCounter.h"
+
+void WakeupCounter::OnWakeup() {
+    long now = GetSysCurrentTime();
+    if (m_WindowStart == -1) m_WindowStart = now;
+    m_WindowCount++;
+    m_TotalCount++;
+
+    long elapsed = now - m_WindowStart;
+    if (elapsed >= WAKEUP_REPORT_INTERVAL) {
+        LOGCATE("WakeupCounter %s wakeups=%.1f/s", m_Name, m_WindowCount * 1000.0 / elapsed);
+        m_WindowStart = now;
+        m_WindowCount = 0;
+    }
+}
+
+void WakeupCounter::Report() {
+    LOGCATE("WakeupCounter %s total wakeups=%ld", m_Name, m_TotalCount);
+}
@@ -0,0 +1,40 @@
+/**
+ *
+ * Created by 公众号：字节流动 on 2026/10/18.
+ * https://github.com/githubhaohao/LearnFFmpeg
+ * 最新文章首发于公众号：字节流动，有疑问或者技术交流可以添加微信 Byte-Flow ,领取视频教程, 拉你进技术交流群
+ *
+ * */
+
+#ifndef LEARNFFMPEG_WAKEUPCOUNTER_H
+#define LEARNFFMPEG_WAKEUPCOUNTER_H
+
+// 唤醒次数的统计周期（毫秒）
+#define WAKEUP_REPORT_INTERVAL 1000
+
+/**
+ * @brief 线程唤醒次数统计
+ *
+ * 线程每次从条件变量等待中返回时调用 OnWakeup，每个统计周期打印一次每秒唤醒次数，
+ * 线程结束时调用 Report 打印总次数。暂停或缺数据时线程阻塞等待，没有唤醒也就没有日志，
+ * 用于确认空闲的播放器不占用 CPU。
+ *
+ * 每个计数器只在一个线程内使用，不加锁
+ */
+class WakeupCounter {
+public:
+    WakeupCounter(const char *name) : m_Name(name) {}
+
+    void OnWakeup();
+
+    void Report();
+
+private:
+    const char *m_Name;
+    long m_WindowStart = -1;   // 当前统计周期的开始时间（毫秒）
+    int  m_WindowCount = 0;    // 当前统计周期内的唤醒次数
+    long m_TotalCount = 0;     // 总唤醒次数
+};
+
+
+#endif //LEARNFFMPEG_WAKEUPCOUNTER_H
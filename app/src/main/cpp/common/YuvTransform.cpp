@@ -0,0 +1,430 @@
+/**
+ *
+ * Created by 公众号：字节流动 on 2026/10/18.
+ * https://github.com/githubhaohao/LearnFFmpeg
+ * 最新文章首发于公众号：字节流动，有疑问或者技术交流可以添加微信 Byte-Flow ,领取视频教程, 拉你进技术交流群
+ *
+ * */
+
+#include "YuvTransform.h"
+
+// 定义 YUV_TRANSFORM_NO_SIMD 时只编译 C 实现，主机测试用它覆盖没有 SIMD 的平台
+#if defined(YUV_TRANSFORM_NO_SIMD)
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define YUV_TRANSFORM_NEON
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define YUV_TRANSFORM_SSE2
+#endif
+
+// 输出像素 (x, y) 与源像素的对应关系
+struct PlaneTransform {
+    bool transpose;  // 输出的列对应源的行
+    bool flipX;      // 输出水平翻转
+    bool flipY;      // 输出垂直翻转
+};
+
+static PlaneTransform GetPlaneTransform(int degree, int mirror) {
+    // 与 GLCameraRender::UpdateMVPMatrix 一致：不镜像时为顺时针角度，镜像时为逆时针角度
+    int clockwise = mirror == YUV_MIRROR_NONE ? degree : 360 - degree;
+    clockwise = ((clockwise % 360) + 360) % 360;
+
+    PlaneTransform tf = {false, false, false};
+    switch (clockwise) {
+        case 90:
+            tf.transpose = true;
+            tf.flipX = true;
+            break;
+        case 180:
+            tf.flipX = true;
+            tf.flipY = true;
+            break;
+        case 270:
+            tf.transpose = true;
+            tf.flipY = true;
+            break;
+        default:
+            break;
+    }
+
+    if (mirror == YUV_MIRROR_HORIZONTAL) tf.flipX = !tf.flipX;
+    else if (mirror == YUV_MIRROR_VERTICAL) tf.flipY = !tf.flipY;
+    return tf;
+}
+
+// 输出坐标 (x, y) 对应的源坐标，w/h 为源平面宽高
+static inline void MapToSource(const PlaneTransform &tf, int w, int h, int x, int y, int *pCol, int *pRow) {
+    if (tf.transpose) {
+        *pRow = tf.flipX ? h - 1 - x : x;
+        *pCol = tf.flipY ? w - 1 - y : y;
+    } else {
+        *pRow = tf.flipY ? h - 1 - y : y;
+        *pCol = tf.flipX ? w - 1 - x : x;
+    }
+}
+
+// C 实现，处理输出区域 [x0, x1) x [y0, y1)
+static void TransformRegion_C(const uint8_t *src, int srcStride, int w, int h,
+                              uint8_t *dst, int dstStride, const PlaneTransform &tf,
+                              int x0, int x1, int y0, int y1) {
+    int col, row;
+    for (int y = y0; y < y1; ++y) {
+        uint8_t *d = dst + y * dstStride;
+        for (int x = x0; x < x1; ++x) {
+            MapToSource(tf, w, h, x, y, &col, &row);
+            d[x] = src[row * srcStride + col];
+        }
+    }
+}
+
+// 源为交错的两字节像素（NV21/NV12 的色度），拆成两个平面
+static void TransformRegionUV_C(const uint8_t *src, int srcStride, int w, int h,
+                                uint8_t *dst0, int dst0Stride, uint8_t *dst1, int dst1Stride,
+                                const PlaneTransform &tf, int x0, int x1, int y0, int y1) {
+    int col, row;
+    for (int y = y0; y < y1; ++y) {
+        uint8_t *d0 = dst0 + y * dst0Stride;
+        uint8_t *d1 = dst1 + y * dst1Stride;
+        for (int x = x0; x < x1; ++x) {
+            MapToSource(tf, w, h, x, y, &col, &row);
+            const uint8_t *s = src + row * srcStride + col * 2;
+            d0[x] = s[0];
+            d1[x] = s[1];
+        }
+    }
+}
+
+#if defined(YUV_TRANSFORM_NEON)
+
+static inline void Transpose8x8(const uint8_t *s, int ss, uint8_t *d, int ds) {
+    uint8x8x2_t t01 = vtrn_u8(vld1_u8(s), vld1_u8(s + ss));
+    uint8x8x2_t t23 = vtrn_u8(vld1_u8(s + 2 * ss), vld1_u8(s + 3 * ss));
+    uint8x8x2_t t45 = vtrn_u8(vld1_u8(s + 4 * ss), vld1_u8(s + 5 * ss));
+    uint8x8x2_t t67 = vtrn_u8(vld1_u8(s + 6 * ss), vld1_u8(s + 7 * ss));
+
+    uint16x4x2_t u02 = vtrn_u16(vreinterpret_u16_u8(t01.val[0]), vreinterpret_u16_u8(t23.val[0]));
+    uint16x4x2_t u13 = vtrn_u16(vreinterpret_u16_u8(t01.val[1]), vreinterpret_u16_u8(t23.val[1]));
+    uint16x4x2_t u46 = vtrn_u16(vreinterpret_u16_u8(t45.val[0]), vreinterpret_u16_u8(t67.val[0]));
+    uint16x4x2_t u57 = vtrn_u16(vreinterpret_u16_u8(t45.val[1]), vreinterpret_u16_u8(t67.val[1]));
+
+    uint32x2x2_t v04 = vtrn_u32(vreinterpret_u32_u16(u02.val[0]), vreinterpret_u32_u16(u46.val[0]));
+    uint32x2x2_t v15 = vtrn_u32(vreinterpret_u32_u16(u13.val[0]), vreinterpret_u32_u16(u57.val[0]));
+    uint32x2x2_t v26 = vtrn_u32(vreinterpret_u32_u16(u02.val[1]), vreinterpret_u32_u16(u46.val[1]));
+    uint32x2x2_t v37 = vtrn_u32(vreinterpret_u32_u16(u13.val[1]), vreinterpret_u32_u16(u57.val[1]));
+
+    vst1_u8(d,          vreinterpret_u8_u32(v04.val[0]));
+    vst1_u8(d + ds,     vreinterpret_u8_u32(v15.val[0]));
+    vst1_u8(d + 2 * ds, vreinterpret_u8_u32(v26.val[0]));
+    vst1_u8(d + 3 * ds, vreinterpret_u8_u32(v37.val[0]));
+    vst1_u8(d + 4 * ds, vreinterpret_u8_u32(v04.val[1]));
+    vst1_u8(d + 5 * ds, vreinterpret_u8_u32(v15.val[1]));
+    vst1_u8(d + 6 * ds, vreinterpret_u8_u32(v26.val[1]));
+    vst1_u8(d + 7 * ds, vreinterpret_u8_u32(v37.val[1]));
+}
+
+static inline void TransposeUV8x8(const uint8_t *s, int ss, uint8_t *d0, uint8_t *d1, int ds0, int ds1) {
+    uint16x8x2_t t01 = vtrnq_u16(vreinterpretq_u16_u8(vld1q_u8(s)), vreinterpretq_u16_u8(vld1q_u8(s + ss)));
+    uint16x8x2_t t23 = vtrnq_u16(vreinterpretq_u16_u8(vld1q_u8(s + 2 * ss)), vreinterpretq_u16_u8(vld1q_u8(s + 3 * ss)));
+    uint16x8x2_t t45 = vtrnq_u16(vreinterpretq_u16_u8(vld1q_u8(s + 4 * ss)), vreinterpretq_u16_u8(vld1q_u8(s + 5 * ss)));
+    uint16x8x2_t t67 = vtrnq_u16(vreinterpretq_u16_u8(vld1q_u8(s + 6 * ss)), vreinterpretq_u16_u8(vld1q_u8(s + 7 * ss)));
+
+    uint32x4x2_t u02 = vtrnq_u32(vreinterpretq_u32_u16(t01.val[0]), vreinterpretq_u32_u16(t23.val[0]));
+    uint32x4x2_t u13 = vtrnq_u32(vreinterpretq_u32_u16(t01.val[1]), vreinterpretq_u32_u16(t23.val[1]));
+    uint32x4x2_t u46 = vtrnq_u32(vreinterpretq_u32_u16(t45.val[0]), vreinterpretq_u32_u16(t67.val[0]));
+    uint32x4x2_t u57 = vtrnq_u32(vreinterpretq_u32_u16(t45.val[1]), vreinterpretq_u32_u16(t67.val[1]));
+
+    uint16x8_t cols[8];
+    cols[0] = vcombine_u16(vget_low_u16(vreinterpretq_u16_u32(u02.val[0])), vget_low_u16(vreinterpretq_u16_u32(u46.val[0])));
+    cols[4] = vcombine_u16(vget_high_u16(vreinterpretq_u16_u32(u02.val[0])), vget_high_u16(vreinterpretq_u16_u32(u46.val[0])));
+    cols[2] = vcombine_u16(vget_low_u16(vreinterpretq_u16_u32(u02.val[1])), vget_low_u16(vreinterpretq_u16_u32(u46.val[1])));
+    cols[6] = vcombine_u16(vget_high_u16(vreinterpretq_u16_u32(u02.val[1])), vget_high_u16(vreinterpretq_u16_u32(u46.val[1])));
+    cols[1] = vcombine_u16(vget_low_u16(vreinterpretq_u16_u32(u13.val[0])), vget_low_u16(vreinterpretq_u16_u32(u57.val[0])));
+    cols[5] = vcombine_u16(vget_high_u16(vreinterpretq_u16_u32(u13.val[0])), vget_high_u16(vreinterpretq_u16_u32(u57.val[0])));
+    cols[3] = vcombine_u16(vget_low_u16(vreinterpretq_u16_u32(u13.val[1])), vget_low_u16(vreinterpretq_u16_u32(u57.val[1])));
+    cols[7] = vcombine_u16(vget_high_u16(vreinterpretq_u16_u32(u13.val[1])), vget_high_u16(vreinterpretq_u16_u32(u57.val[1])));
+
+    for (int j = 0; j < 8; ++j) {
+        vst1_u8(d0 + j * ds0, vmovn_u16(cols[j]));
+        vst1_u8(d1 + j * ds1, vshrn_n_u16(cols[j], 8));
+    }
+}
+
+static inline void ReverseRow16(const uint8_t *s, uint8_t *d) {
+    uint8x16_t v = vrev64q_u8(vld1q_u8(s));
+    vst1q_u8(d, vcombine_u8(vget_high_u8(v), vget_low_u8(v)));
+}
+
+static inline void SplitUV8(const uint8_t *s, bool reverse, uint8_t *d0, uint8_t *d1) {
+    uint16x8_t v = vreinterpretq_u16_u8(vld1q_u8(s));
+    if (reverse) {
+        v = vrev64q_u16(v);
+        v = vcombine_u16(vget_high_u16(v), vget_low_u16(v));
+    }
+    vst1_u8(d0, vmovn_u16(v));
+    vst1_u8(d1, vshrn_n_u16(v, 8));
+}
+
+#elif defined(YUV_TRANSFORM_SSE2)
+
+static inline void Transpose8x8(const uint8_t *s, int ss, uint8_t *d, int ds) {
+    __m128i a0 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *) s),
+                                   _mm_loadl_epi64((const __m128i *) (s + ss)));
+    __m128i a1 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *) (s + 2 * ss)),
+                                   _mm_loadl_epi64((const __m128i *) (s + 3 * ss)));
+    __m128i a2 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *) (s + 4 * ss)),
+                                   _mm_loadl_epi64((const __m128i *) (s + 5 * ss)));
+    __m128i a3 = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *) (s + 6 * ss)),
+                                   _mm_loadl_epi64((const __m128i *) (s + 7 * ss)));
+
+    __m128i b0 = _mm_unpacklo_epi16(a0, a1);
+    __m128i b1 = _mm_unpackhi_epi16(a0, a1);
+    __m128i b2 = _mm_unpacklo_epi16(a2, a3);
+    __m128i b3 = _mm_unpackhi_epi16(a2, a3);
+
+    __m128i c0 = _mm_unpacklo_epi32(b0, b2);  // 第 0、1 列
+    __m128i c1 = _mm_unpackhi_epi32(b0, b2);  // 第 2、3 列
+    __m128i c2 = _mm_unpacklo_epi32(b1, b3);  // 第 4、5 列
+    __m128i c3 = _mm_unpackhi_epi32(b1, b3);  // 第 6、7 列
+
+    _mm_storel_epi64((__m128i *) d, c0);
+    _mm_storel_epi64((__m128i *) (d + ds), _mm_unpackhi_epi64(c0, c0));
+    _mm_storel_epi64((__m128i *) (d + 2 * ds), c1);
+    _mm_storel_epi64((__m128i *) (d + 3 * ds), _mm_unpackhi_epi64(c1, c1));
+    _mm_storel_epi64((__m128i *) (d + 4 * ds), c2);
+    _mm_storel_epi64((__m128i *) (d + 5 * ds), _mm_unpackhi_epi64(c2, c2));
+    _mm_storel_epi64((__m128i *) (d + 6 * ds), c3);
+    _mm_storel_epi64((__m128i *) (d + 7 * ds), _mm_unpackhi_epi64(c3, c3));
+}
+
+static inline void StoreSplitUV8(__m128i v, uint8_t *d0, uint8_t *d1) {
+    __m128i lo = _mm_and_si128(v, _mm_set1_epi16(0x00FF));
+    __m128i hi = _mm_srli_epi16(v, 8);
+    _mm_storel_epi64((__m128i *) d0, _mm_packus_epi16(lo, lo));
+    _mm_storel_epi64((__m128i *) d1, _mm_packus_epi16(hi, hi));
+}
+
+static inline void TransposeUV8x8(const uint8_t *s, int ss, uint8_t *d0, uint8_t *d1, int ds0, int ds1) {
+    __m128i r0 = _mm_loadu_si128((const __m128i *) s);
+    __m128i r1 = _mm_loadu_si128((const __m128i *) (s + ss));
+    __m128i r2 = _mm_loadu_si128((const __m128i *) (s + 2 * ss));
+    __m128i r3 = _mm_loadu_si128((const __m128i *) (s + 3 * ss));
+    __m128i r4 = _mm_loadu_si128((const __m128i *) (s + 4 * ss));
+    __m128i r5 = _mm_loadu_si128((const __m128i *) (s + 5 * ss));
+    __m128i r6 = _mm_loadu_si128((const __m128i *) (s + 6 * ss));
+    __m128i r7 = _mm_loadu_si128((const __m128i *) (s + 7 * ss));
+
+    __m128i a0 = _mm_unpacklo_epi16(r0, r1);
+    __m128i a1 = _mm_unpackhi_epi16(r0, r1);
+    __m128i a2 = _mm_unpacklo_epi16(r2, r3);
+    __m128i a3 = _mm_unpackhi_epi16(r2, r3);
+    __m128i a4 = _mm_unpacklo_epi16(r4, r5);
+    __m128i a5 = _mm_unpackhi_epi16(r4, r5);
+    __m128i a6 = _mm_unpacklo_epi16(r6, r7);
+    __m128i a7 = _mm_unpackhi_epi16(r6, r7);
+
+    __m128i b0 = _mm_unpacklo_epi32(a0, a2);  // 第 0、1 列的前 4 行
+    __m128i b1 = _mm_unpackhi_epi32(a0, a2);  // 第 2、3 列
+    __m128i b2 = _mm_unpacklo_epi32(a1, a3);  // 第 4、5 列
+    __m128i b3 = _mm_unpackhi_epi32(a1, a3);  // 第 6、7 列
+    __m128i b4 = _mm_unpacklo_epi32(a4, a6);  // 第 0、1 列的后 4 行
+    __m128i b5 = _mm_unpackhi_epi32(a4, a6);
+    __m128i b6 = _mm_unpacklo_epi32(a5, a7);
+    __m128i b7 = _mm_unpackhi_epi32(a5, a7);
+
+    StoreSplitUV8(_mm_unpacklo_epi64(b0, b4), d0,           d1);
+    StoreSplitUV8(_mm_unpackhi_epi64(b0, b4), d0 + ds0,     d1 + ds1);
+    StoreSplitUV8(_mm_unpacklo_epi64(b1, b5), d0 + 2 * ds0, d1 + 2 * ds1);
+    StoreSplitUV8(_mm_unpackhi_epi64(b1, b5), d0 + 3 * ds0, d1 + 3 * ds1);
+    StoreSplitUV8(_mm_unpacklo_epi64(b2, b6), d0 + 4 * ds0, d1 + 4 * ds1);
+    StoreSplitUV8(_mm_unpackhi_epi64(b2, b6), d0 + 5 * ds0, d1 + 5 * ds1);
+    StoreSplitUV8(_mm_unpacklo_epi64(b3, b7), d0 + 6 * ds0, d1 + 6 * ds1);
+    StoreSplitUV8(_mm_unpackhi_epi64(b3, b7), d0 + 7 * ds0, d1 + 7 * ds1);
+}
+
+static inline void ReverseRow16(const uint8_t *s, uint8_t *d) {
+    __m128i v = _mm_loadu_si128((const __m128i *) s);
+    v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+    v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+    v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+    v = _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+    _mm_storeu_si128((__m128i *) d, v);
+}
+
+static inline void SplitUV8(const uint8_t *s, bool reverse, uint8_t *d0, uint8_t *d1) {
+    __m128i v = _mm_loadu_si128((const __m128i *) s);
+    if (reverse) {
+        v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+        v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+        v = _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+    }
+    StoreSplitUV8(v, d0, d1);
+}
+
+#endif
+
+/**
+ * @brief 变换一个单字节平面
+ * @param w 源宽度
+ * @param h 源高度
+ */
+static void TransformPlane(const uint8_t *src, int srcStride, int w, int h,
+                           uint8_t *dst, int dstStride, const PlaneTransform &tf) {
+    int dstW = tf.transpose ? h : w;
+    int dstH = tf.transpose ? w : h;
+
+    if (!tf.transpose) {
+        for (int y = 0; y < dstH; ++y) {
+            const uint8_t *s = src + (tf.flipY ? h - 1 - y : y) * srcStride;
+            uint8_t *d = dst + y * dstStride;
+            if (!tf.flipX) {
+                memcpy(d, s, w);
+                continue;
+            }
+            int x = 0;
+#if defined(YUV_TRANSFORM_NEON) || defined(YUV_TRANSFORM_SSE2)
+            for (; x + 16 <= w; x += 16) {
+                ReverseRow16(s + w - x - 16, d + x);
+            }
+#endif
+            for (; x < w; ++x) {
+                d[x] = s[w - 1 - x];
+            }
+        }
+        return;
+    }
+
+    int blockW = 0, blockH = 0;
+#if defined(YUV_TRANSFORM_NEON) || defined(YUV_TRANSFORM_SSE2)
+    blockW = dstW & ~7;
+    blockH = dstH & ~7;
+    int srcStep = tf.flipX ? -srcStride : srcStride;
+    int dstStep = tf.flipY ? -dstStride : dstStride;
+    for (int y = 0; y < blockH; y += 8) {
+        // 输出第 y 行开始的 8 行对应源的 8 列
+        int srcCol = tf.flipY ? w - 8 - y : y;
+        uint8_t *d = dst + (tf.flipY ? y + 7 : y) * dstStride;
+        for (int x = 0; x < blockW; x += 8) {
+            int srcRow = tf.flipX ? h - 1 - x : x;
+            Transpose8x8(src + srcRow * srcStride + srcCol, srcStep, d + x, dstStep);
+        }
+    }
+#endif
+    // 块处理剩下的右侧和底部
+    TransformRegion_C(src, srcStride, w, h, dst, dstStride, tf, blockW, dstW, 0, dstH);
+    TransformRegion_C(src, srcStride, w, h, dst, dstStride, tf, 0, blockW, blockH, dstH);
+}
+
+/**
+ * @brief 变换一个交错的双字节色度平面并拆分
+ * @param w 源宽度（像素对数）
+ * @param h 源高度
+ * @param dst0 接收每对中第一个字节的平面
+ * @param dst1 接收每对中第二个字节的平面
+ */
+static void TransformPlaneUV(const uint8_t *src, int srcStride, int w, int h,
+                             uint8_t *dst0, int dst0Stride, uint8_t *dst1, int dst1Stride,
+                             const PlaneTransform &tf) {
+    int dstW = tf.transpose ? h : w;
+    int dstH = tf.transpose ? w : h;
+
+    if (!tf.transpose) {
+        for (int y = 0; y < dstH; ++y) {
+            const uint8_t *s = src + (tf.flipY ? h - 1 - y : y) * srcStride;
+            uint8_t *d0 = dst0 + y * dst0Stride;
+            uint8_t *d1 = dst1 + y * dst1Stride;
+            int x = 0;
+#if defined(YUV_TRANSFORM_NEON) || defined(YUV_TRANSFORM_SSE2)
+            for (; x + 8 <= w; x += 8) {
+                SplitUV8(s + (tf.flipX ? w - x - 8 : x) * 2, tf.flipX, d0 + x, d1 + x);
+            }
+#endif
+            for (; x < w; ++x) {
+                const uint8_t *p = s + (tf.flipX ? w - 1 - x : x) * 2;
+                d0[x] = p[0];
+                d1[x] = p[1];
+            }
+        }
+        return;
+    }
+
+    int blockW = 0, blockH = 0;
+#if defined(YUV_TRANSFORM_NEON) || defined(YUV_TRANSFORM_SSE2)
+    blockW = dstW & ~7;
+    blockH = dstH & ~7;
+    int srcStep = tf.flipX ? -srcStride : srcStride;
+    int dst0Step = tf.flipY ? -dst0Stride : dst0Stride;
+    int dst1Step = tf.flipY ? -dst1Stride : dst1Stride;
+    for (int y = 0; y < blockH; y += 8) {
+        int srcCol = tf.flipY ? w - 8 - y : y;
+        uint8_t *d0 = dst0 + (tf.flipY ? y + 7 : y) * dst0Stride;
+        uint8_t *d1 = dst1 + (tf.flipY ? y + 7 : y) * dst1Stride;
+        for (int x = 0; x < blockW; x += 8) {
+            int srcRow = tf.flipX ? h - 1 - x : x;
+            TransposeUV8x8(src + srcRow * srcStride + srcCol * 2, srcStep, d0 + x, d1 + x, dst0Step, dst1Step);
+        }
+    }
+#endif
+    TransformRegionUV_C(src, srcStride, w, h, dst0, dst0Stride, dst1, dst1Stride, tf, blockW, dstW, 0, dstH);
+    TransformRegionUV_C(src, srcStride, w, h, dst0, dst0Stride, dst1, dst1Stride, tf, 0, blockW, blockH, dstH);
+}
+
+int YuvTransform::ToI420(const NativeImage *pSrc, uint8_t *const ppDstPlane[3], const int pDstLineSize[3],
+                         int degree, int mirror) {
+    if (pSrc == nullptr || pSrc->ppPlane[0] == nullptr || (pSrc->width & 1) || (pSrc->height & 1))
+        return -1;
+    if (degree % 90 != 0)
+        return -1;
+
+    PlaneTransform tf = GetPlaneTransform(degree, mirror);
+    int w = pSrc->width;
+    int h = pSrc->height;
+    int lumaStride = pSrc->pLineSize[0] > 0 ? pSrc->pLineSize[0] : w;
+
+    switch (pSrc->format) {
+        case IMAGE_FORMAT_NV21:
+        case IMAGE_FORMAT_NV12: {
+            int chromaStride = pSrc->pLineSize[1] > 0 ? pSrc->pLineSize[1] : w;
+            const uint8_t *pChroma = pSrc->ppPlane[1] != nullptr ? pSrc->ppPlane[1] : pSrc->ppPlane[0] + lumaStride * h;
+            TransformPlane(pSrc->ppPlane[0], lumaStride, w, h, ppDstPlane[0], pDstLineSize[0], tf);
+            if (pSrc->format == IMAGE_FORMAT_NV21) {
+                // NV21 每对中 V 在前
+                TransformPlaneUV(pChroma, chromaStride, w / 2, h / 2,
+                                 ppDstPlane[2], pDstLineSize[2], ppDstPlane[1], pDstLineSize[1], tf);
+            } else {
+                TransformPlaneUV(pChroma, chromaStride, w / 2, h / 2,
+                                 ppDstPlane[1], pDstLineSize[1], ppDstPlane[2], pDstLineSize[2], tf);
+            }
+            break;
+        }
+        case IMAGE_FORMAT_I420: {
+            int uStride = pSrc->pLineSize[1] > 0 ? pSrc->pLineSize[1] : w / 2;
+            int vStride = pSrc->pLineSize[2] > 0 ? pSrc->pLineSize[2] : w / 2;
+            const uint8_t *pU = pSrc->ppPlane[1] != nullptr ? pSrc->ppPlane[1] : pSrc->ppPlane[0] + lumaStride * h;
+            const uint8_t *pV = pSrc->ppPlane[2] != nullptr ? pSrc->ppPlane[2] : pU + uStride * h / 2;
+            TransformPlane(pSrc->ppPlane[0], lumaStride, w, h, ppDstPlane[0], pDstLineSize[0], tf);
+            TransformPlane(pU, uStride, w / 2, h / 2, ppDstPlane[1], pDstLineSize[1], tf);
+            TransformPlane(pV, vStride, w / 2, h / 2, ppDstPlane[2], pDstLineSize[2], tf);
+            break;
+        }
+        default:
+            return -1;
+    }
+    return 0;
+}
+
+void YuvTransform::GetOutputSize(int srcWidth, int srcHeight, int degree, int *pDstWidth, int *pDstHeight) {
+    bool swap = ((degree % 180) + 180) % 180 == 90;
+    *pDstWidth = swap ? srcHeight : srcWidth;
+    *pDstHeight = swap ? srcWidth : srcHeight;
+}
+
+const char *YuvTransform::GetKernelName() {
+#if defined(YUV_TRANSFORM_NEON)
+    return "neon";
+#elif defined(YUV_TRANSFORM_SSE2)
+    return "sse2";
+#else
+    return "c";
+#endif
+}
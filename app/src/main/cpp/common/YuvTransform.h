@@ -0,0 +1,49 @@
+/**
+ *
+ * Created by 公众号：字节流动 on 2026/10/18.
+ * https://github.com/githubhaohao/LearnFFmpeg
+ * 最新文章首发于公众号：字节流动，有疑问或者技术交流可以添加微信 Byte-Flow ,领取视频教程, 拉你进技术交流群
+ *
+ * */
+
+#ifndef LEARNFFMPEG_YUVTRANSFORM_H
+#define LEARNFFMPEG_YUVTRANSFORM_H
+
+#include <ImageDef.h>
+
+// 镜像方式，与 TransformMatrix::mirror 一致
+#define YUV_MIRROR_NONE        0
+#define YUV_MIRROR_HORIZONTAL  1
+#define YUV_MIRROR_VERTICAL    2
+
+/**
+ * @brief CPU 上的 YUV 旋转、镜像和格式转换，一次遍历把 NV21/NV12/I420 帧转成 I420
+ * 角度和镜像的含义与 GLCameraRender::UpdateMVPMatrix 相同：mirror 为 0 时 degree 是顺时针角度，否则是逆时针角度
+ */
+class YuvTransform {
+public:
+    /**
+     * @brief 旋转、镜像并转换为 I420
+     * @param pSrc 源图像，支持 IMAGE_FORMAT_NV21/NV12/I420，宽高需为偶数
+     * @param ppDstPlane 目标 Y/U/V 平面
+     * @param pDstLineSize 目标各平面的行字节数
+     * @param degree 旋转角度，0/90/180/270
+     * @param mirror 镜像方式
+     * @return 0表示成功，负数表示不支持的格式或参数
+     */
+    static int ToI420(const NativeImage *pSrc, uint8_t *const ppDstPlane[3], const int pDstLineSize[3],
+                      int degree, int mirror);
+
+    /**
+     * @brief 计算旋转后的输出尺寸
+     */
+    static void GetOutputSize(int srcWidth, int srcHeight, int degree, int *pDstWidth, int *pDstHeight);
+
+    /**
+     * @brief 当前编译使用的 SIMD 实现，用于日志
+     */
+    static const char *GetKernelName();
+};
+
+
+#endif //LEARNFFMPEG_YUVTRANSFORM_H
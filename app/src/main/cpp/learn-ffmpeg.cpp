@@ -13,6 +13,8 @@
 #include <render/video/VRGLRender.h>
 #include <render/audio/OpenSLRender.h>
 #include <MediaRecorderContext.h>
+#include <HttpCache.h>
+#include <StreamInfoCache.h>
 #include "util/LogUtil.h"
 #include "jni.h"
 #include "ASanTestCase.h"
@@ -62,6 +64,21 @@ JNIEXPORT jstring JNICALL Java_com_byteflow_learnffmpeg_media_FFMediaPlayer_nati
     return env->NewStringUTF(strBuffer);
 }
 
+/*
+ * Class:     com_byteflow_learnffmpeg_media_FFMediaPlayer
+ * Method:    native_SetCacheDir
+ * Signature: (Ljava/lang/String;)V
+ */
+JNIEXPORT void JNICALL Java_com_byteflow_learnffmpeg_media_FFMediaPlayer_native_1SetCacheDir
+        (JNIEnv *env, jclass cls, jstring jcacheDir)
+{
+    if(jcacheDir == nullptr) return;
+    const char* cacheDir = env->GetStringUTFChars(jcacheDir, nullptr);
+    HttpCache::SetCacheDir(cacheDir);
+    StreamInfoCache::SetCacheDir(cacheDir);
+    env->ReleaseStringUTFChars(jcacheDir, cacheDir);
+}
+
 /*
  * Class:     com_byteflow_learnffmpeg_media_FFMediaPlayer
  * Method:    native_Init
@@ -103,6 +120,36 @@ Java_com_byteflow_learnffmpeg_media_FFMediaPlayer_native_1SeekToPosition(JNIEnv
     }
 }
 
+JNIEXPORT void JNICALL
+Java_com_byteflow_learnffmpeg_media_FFMediaPlayer_native_1ScrubToPosition(JNIEnv *env, jobject thiz,
+                                                                       jlong player_handle, jfloat position) {
+    if(player_handle != 0)
+    {
+        PlayerWrapper *ffMediaPlayer = reinterpret_cast<PlayerWrapper *>(player_handle);
+        ffMediaPlayer->ScrubToPosition(position);
+    }
+}
+
+JNIEXPORT void JNICALL
+Java_com_byteflow_learnffmpeg_media_FFMediaPlayer_native_1SetAccurateSeek(JNIEnv *env, jobject thiz,
+                                                                       jlong player_handle, jboolean accurate) {
+    if(player_handle != 0)
+    {
+        PlayerWrapper *ffMediaPlayer = reinterpret_cast<PlayerWrapper *>(player_handle);
+        ffMediaPlayer->SetAccurateSeek(accurate);
+    }
+}
+
+JNIEXPORT void JNICALL
+Java_com_byteflow_learnffmpeg_media_FFMediaPlayer_native_1SetLatencyTarget(JNIEnv *env, jobject thiz,
+                                                                        jlong player_handle, jint latency_ms) {
+    if(player_handle != 0)
+    {
+        PlayerWrapper *ffMediaPlayer = reinterpret_cast<PlayerWrapper *>(player_handle);
+        ffMediaPlayer->SetLatencyTarget(latency_ms);
+    }
+}
+
 JNIEXPORT jlong JNICALL
 Java_com_byteflow_learnffmpeg_media_FFMediaPlayer_native_1GetMediaParams(JNIEnv *env, jobject thiz,
                                                                          jlong player_handle,
@@ -367,6 +414,74 @@ Java_com_byteflow_learnffmpeg_media_MediaRecorderContext_native_1OnPreviewFrame(
     delete[] buf;
 }
 
+extern "C"
+JNIEXPORT jobjectArray JNICALL
+Java_com_byteflow_learnffmpeg_media_MediaRecorderContext_native_1CreateBufferPool(JNIEnv *env,
+                                                                                   jobject thiz,
+                                                                                   jint buffer_type,
+                                                                                   jint count,
+                                                                                   jint capacity) {
+    MediaRecorderContext *pContext = MediaRecorderContext::GetContext(env, thiz);
+    if(pContext == nullptr) return nullptr;
+    DirectBufferPool *pool = pContext->CreateBufferPool(buffer_type, count, capacity);
+    if(pool == nullptr) return nullptr;
+
+    jclass bufferCls = env->FindClass("java/nio/ByteBuffer");
+    jobjectArray buffers = env->NewObjectArray(pool->GetCount(), bufferCls, nullptr);
+    for (int i = 0; i < pool->GetCount(); ++i) {
+        jobject buffer = env->NewDirectByteBuffer(pool->GetBuffer(i), pool->GetCapacity());
+        env->SetObjectArrayElement(buffers, i, buffer);
+        env->DeleteLocalRef(buffer);
+    }
+    env->DeleteLocalRef(bufferCls);
+    return buffers;
+}
+
+extern "C"
+JNIEXPORT jint JNICALL
+Java_com_byteflow_learnffmpeg_media_MediaRecorderContext_native_1AcquireBuffer(JNIEnv *env,
+                                                                                jobject thiz,
+                                                                                jint buffer_type) {
+    MediaRecorderContext *pContext = MediaRecorderContext::GetContext(env, thiz);
+    if(pContext) return pContext->AcquireBuffer(buffer_type);
+    return -1;
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_byteflow_learnffmpeg_media_MediaRecorderContext_native_1ReleaseBuffer(JNIEnv *env,
+                                                                                jobject thiz,
+                                                                                jint buffer_type,
+                                                                                jobject buffer) {
+    uint8_t *pData = static_cast<uint8_t *>(env->GetDirectBufferAddress(buffer));
+    MediaRecorderContext *pContext = MediaRecorderContext::GetContext(env, thiz);
+    if(pContext) pContext->ReleaseBuffer(buffer_type, pData);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_byteflow_learnffmpeg_media_MediaRecorderContext_native_1OnAudioBuffer(JNIEnv *env,
+                                                                                jobject thiz,
+                                                                                jobject buffer,
+                                                                                jint size) {
+    uint8_t *pData = static_cast<uint8_t *>(env->GetDirectBufferAddress(buffer));
+    MediaRecorderContext *pContext = MediaRecorderContext::GetContext(env, thiz);
+    if(pContext) pContext->OnAudioBuffer(pData, size);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_byteflow_learnffmpeg_media_MediaRecorderContext_native_1OnPreviewBuffer(JNIEnv *env,
+                                                                                  jobject thiz,
+                                                                                  jint format,
+                                                                                  jobject buffer,
+                                                                                  jint width,
+                                                                                  jint height) {
+    uint8_t *pData = static_cast<uint8_t *>(env->GetDirectBufferAddress(buffer));
+    MediaRecorderContext *pContext = MediaRecorderContext::GetContext(env, thiz);
+    if(pContext) pContext->OnPreviewBuffer(format, pData, width, height);
+}
+
 extern "C"
 JNIEXPORT void JNICALL
 Java_com_byteflow_learnffmpeg_media_MediaRecorderContext_native_1SetTransformMatrix(JNIEnv *env,
@@ -381,6 +496,55 @@ Java_com_byteflow_learnffmpeg_media_MediaRecorderContext_native_1SetTransformMat
     if(pContext) pContext->SetTransformMatrix(translate_x, translate_y, scale_x, scale_y, degree, mirror);
 }
 
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_byteflow_learnffmpeg_media_MediaRecorderContext_native_1SetRotationMetadataEnabled(JNIEnv *env,
+                                                                                             jobject thiz,
+                                                                                             jboolean enable) {
+    MediaRecorderContext *pContext = MediaRecorderContext::GetContext(env, thiz);
+    if(pContext) pContext->SetRotationMetadataEnabled(enable);
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_byteflow_learnffmpeg_media_MediaRecorderContext_native_1SetEncoderConfig(JNIEnv *env,
+                                                                                   jobject thiz,
+                                                                                   jint codec,
+                                                                                   jstring preset,
+                                                                                   jstring tune,
+                                                                                   jint rate_control,
+                                                                                   jint crf,
+                                                                                   jlong bit_rate,
+                                                                                   jlong max_bit_rate,
+                                                                                   jlong buffer_size,
+                                                                                   jint thread_count,
+                                                                                   jboolean sliced_threads,
+                                                                                   jint lookahead,
+                                                                                   jint max_b_frames,
+                                                                                   jint key_interval_frames) {
+    EncoderConfig config;
+    config.codec = codec;
+    const char *pPreset = preset != nullptr ? env->GetStringUTFChars(preset, nullptr) : nullptr;
+    const char *pTune = tune != nullptr ? env->GetStringUTFChars(tune, nullptr) : nullptr;
+    config.preset = pPreset != nullptr ? pPreset : "";
+    config.tune = pTune != nullptr ? pTune : "";
+    if(pPreset != nullptr) env->ReleaseStringUTFChars(preset, pPreset);
+    if(pTune != nullptr) env->ReleaseStringUTFChars(tune, pTune);
+    config.rateControl = rate_control;
+    config.crf = crf;
+    config.bitRate = bit_rate;
+    config.maxBitRate = max_bit_rate;
+    config.bufferSize = buffer_size;
+    config.threadCount = thread_count;
+    config.slicedThreads = sliced_threads;
+    config.lookahead = lookahead;
+    config.maxBFrames = max_b_frames;
+    config.keyIntervalFrames = key_interval_frames;
+
+    MediaRecorderContext *pContext = MediaRecorderContext::GetContext(env, thiz);
+    if(pContext) pContext->SetEncoderConfig(config);
+}
+
 extern "C"
 JNIEXPORT void JNICALL
 Java_com_byteflow_learnffmpeg_media_MediaRecorderContext_native_1OnSurfaceCreated(JNIEnv *env,
@@ -0,0 +1,125 @@
+/**
+ *
+ * Created by 公众号：字节流动 on 2026/10/18.
+ * https://github.com/githubhaohao/LearnFFmpeg
+ * 最新文章首发于公众号：字节流动，有疑问或者技术交流可以添加微信 Byte-Flow ,领取视频教程, 拉你进技术交流群
+ *
+ * */
+
+#include <LogUtil.h>
+#include "EventDispatcher.h"
+#include "MediaPlayer.h"
+
+EventDispatcher::EventDispatcher(JavaVM *javaVm, jobject javaObj) : m_JavaVM(javaVm), m_JavaObj(javaObj) {
+    m_Thread = new std::thread(DispatchThreadProc, this);
+}
+
+EventDispatcher::~EventDispatcher() {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_Exit = true;
+    m_Cond.notify_all();
+    lock.unlock();
+
+    if (m_Thread != nullptr) {
+        m_Thread->join();
+        delete m_Thread;
+        m_Thread = nullptr;
+    }
+    LOGCATE("EventDispatcher::~EventDispatcher posted=%ld, delivered=%ld", m_PostCount, m_DeliverCount);
+}
+
+void EventDispatcher::SetCoalesce(int msgType, int intervalMs) {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    CoalescedEvent event = {intervalMs, false, 0, 0};
+    m_Coalesced[msgType] = event;
+}
+
+void EventDispatcher::Post(int msgType, float msgCode) {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    if (m_Exit) return;
+    m_PostCount++;
+    std::map<int, CoalescedEvent>::iterator it = m_Coalesced.find(msgType);
+    if (it != m_Coalesced.end()) {
+        //覆盖还没发送的旧值
+        it->second.pending = true;
+        it->second.msgCode = msgCode;
+    } else {
+        Event event = {msgType, msgCode};
+        m_Events.push_back(event);
+    }
+    m_Cond.notify_one();
+}
+
+void EventDispatcher::DispatchThreadProc(EventDispatcher *dispatcher) {
+    dispatcher->DispatchLoop();
+}
+
+void EventDispatcher::DispatchLoop() {
+    JNIEnv *env = nullptr;
+    if (m_JavaVM->AttachCurrentThread(&env, nullptr) != JNI_OK) {
+        LOGCATE("EventDispatcher::DispatchLoop AttachCurrentThread fail");
+        return;
+    }
+    //方法 ID 在对象存活期间不变，只查找一次
+    jclass clazz = env->GetObjectClass(m_JavaObj);
+    jmethodID mid = env->GetMethodID(clazz, JAVA_PLAYER_EVENT_CALLBACK_API_NAME, "(IF)V");
+    env->DeleteLocalRef(clazz);
+
+    std::deque<Event> events;
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    while (!m_Exit) {
+        long waitMs = TakeDueEvents(events, GetSysCurrentTime());
+        if (events.empty()) {
+            //只有限速中的合并事件时定时等待，否则一直等到有新事件
+            if (waitMs >= 0) {
+                m_Cond.wait_for(lock, std::chrono::milliseconds(waitMs));
+            } else {
+                m_Cond.wait(lock);
+            }
+            continue;
+        }
+
+        lock.unlock();
+        while (!events.empty()) {
+            Event event = events.front();
+            events.pop_front();
+            if (mid != nullptr) {
+                env->CallVoidMethod(m_JavaObj, mid, event.msgType, event.msgCode);
+                if (env->ExceptionCheck()) {
+                    env->ExceptionDescribe();
+                    env->ExceptionClear();
+                }
+            }
+        }
+        lock.lock();
+    }
+    lock.unlock();
+
+    m_JavaVM->DetachCurrentThread();
+}
+
+long EventDispatcher::TakeDueEvents(std::deque<Event> &out, long now) {
+    while (!m_Events.empty()) {
+        out.push_back(m_Events.front());
+        m_Events.pop_front();
+        m_DeliverCount++;
+    }
+
+    long waitMs = -1;
+    std::map<int, CoalescedEvent>::iterator it;
+    for (it = m_Coalesced.begin(); it != m_Coalesced.end(); ++it) {
+        CoalescedEvent &coalesced = it->second;
+        if (!coalesced.pending) continue;
+        long remain = coalesced.lastSendTime + coalesced.intervalMs - now;
+        if (remain <= 0) {
+            Event event = {it->first, coalesced.msgCode};
+            out.push_back(event);
+            coalesced.pending = false;
+            coalesced.lastSendTime = now;
+            m_DeliverCount++;
+        } else if (waitMs < 0 || remain < waitMs) {
+            waitMs = remain;
+        }
+    }
+    return waitMs;
+}
@@ -0,0 +1,93 @@
+/**
+ *
+ * Created by 公众号：字节流动 on 2026/10/18.
+ * https://github.com/githubhaohao/LearnFFmpeg
+ * 最新文章首发于公众号：字节流动，有疑问或者技术交流可以添加微信 Byte-Flow ,领取视频教程, 拉你进技术交流群
+ *
+ * */
+
+#ifndef LEARNFFMPEG_EVENTDISPATCHER_H
+#define LEARNFFMPEG_EVENTDISPATCHER_H
+
+#include <jni.h>
+#include <map>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+// 进度等高频事件的最小发送间隔（毫秒），约一个 UI 帧
+#define EVENT_COALESCE_INTERVAL 16
+
+/**
+ * @brief 播放器事件分发线程
+ *
+ * 解码线程直接回调 Java 时，每次都要 GetEnv、可能的 Attach/Detach、GetObjectClass 和 GetMethodID，
+ * 并且会阻塞在 Java 回调上。EventDispatcher 把事件放入队列后立即返回，由一个常驻并已 attach 的线程
+ * 统一回调 Java，方法 ID 只在线程启动时查找一次。
+ * - 普通事件按顺序逐个发送
+ * - 通过 SetCoalesce 注册的高频事件（渲染请求、播放进度）只保留最新的值，按最小间隔发送
+ *
+ * 停止时丢弃没有发送的事件，不在释放播放器的线程上等待 Java 回调
+ */
+class EventDispatcher {
+public:
+    /**
+     * @param javaVm Java 虚拟机
+     * @param javaObj Java 层播放器对象的全局引用，由播放器持有，须在 EventDispatcher 销毁之后释放
+     */
+    EventDispatcher(JavaVM *javaVm, jobject javaObj);
+
+    ~EventDispatcher();
+
+    /**
+     * @brief 注册需要合并的事件类型，在 Post 之前调用
+     * @param msgType 事件类型
+     * @param intervalMs 两次发送的最小间隔（毫秒），0 表示只合并不限速
+     */
+    void SetCoalesce(int msgType, int intervalMs);
+
+    /**
+     * @brief 投递事件，不阻塞
+     */
+    void Post(int msgType, float msgCode);
+
+private:
+    struct Event {
+        int   msgType;
+        float msgCode;
+    };
+
+    // 合并事件的状态
+    struct CoalescedEvent {
+        int   intervalMs;
+        bool  pending;
+        float msgCode;
+        long  lastSendTime;    // 上次发送的时间（毫秒）
+    };
+
+    static void DispatchThreadProc(EventDispatcher *dispatcher);
+
+    void DispatchLoop();
+
+    /**
+     * @brief 取出可以发送的合并事件，返回最近一个还需等待的合并事件的剩余时间（毫秒），没有时返回 -1
+     * 调用方持有 m_Mutex
+     */
+    long TakeDueEvents(std::deque<Event> &out, long now);
+
+private:
+    JavaVM                         *m_JavaVM;
+    jobject                         m_JavaObj;
+    std::thread                    *m_Thread = nullptr;
+    std::mutex                      m_Mutex;
+    std::condition_variable         m_Cond;
+    std::deque<Event>               m_Events;
+    std::map<int, CoalescedEvent>   m_Coalesced;
+    bool                            m_Exit = false;
+    long                            m_PostCount = 0;       // 投递的事件数
+    long                            m_DeliverCount = 0;    // 实际回调 Java 的次数
+};
+
+
+#endif //LEARNFFMPEG_EVENTDISPATCHER_H
@@ -26,6 +26,8 @@ void FFMediaPlayer::Init(JNIEnv *jniEnv, jobject obj, char *url, int videoRender
     jniEnv->GetJavaVM(&m_JavaVM);
     // 创建Java对象的全局引用，避免被GC回收
     m_JavaObj = jniEnv->NewGlobalRef(obj);
+    // 启动事件分发线程，解码线程的回调不再直接调用 Java
+    StartEventDispatcher();
 
     // 创建视频解码器和音频解码器
     m_VideoDecoder = new VideoDecoder(url);
@@ -86,6 +88,9 @@ void FFMediaPlayer::UnInit() {
     // 释放OpenGL渲染器单例
     VideoGLRender::ReleaseInstance();
 
+    // 解码线程已经结束，停止事件分发线程
+    StopEventDispatcher();
+
     // 删除Java对象的全局引用，并在需要时从线程分离
     bool isAttach = false;
     GetJNIEnv(&isAttach)->DeleteGlobalRef(m_JavaObj);
@@ -148,6 +153,55 @@ void FFMediaPlayer::SeekToPosition(float position) {
 
 }
 
+/**
+ * @brief 拖动预览
+ * @param position 目标位置（秒）
+ *
+ * 视频只解码并显示目标附近的关键帧，音频仅跳转不输出，
+ * 松手后由 SeekToPosition 精确跳转并恢复播放
+ */
+void FFMediaPlayer::ScrubToPosition(float position) {
+    LOGCATE("FFMediaPlayer::ScrubToPosition position=%f", position);
+    if(m_VideoDecoder)
+        m_VideoDecoder->ScrubToPosition(position);
+
+    if(m_AudioDecoder)
+        m_AudioDecoder->ScrubToPosition(position);
+
+}
+
+/**
+ * @brief 设置是否精确 seek
+ * @param accurate 是否精确 seek
+ *
+ * 开启时从目标之前的关键帧解码并丢弃目标之前的帧，关闭时直接显示关键帧，跳转更快
+ */
+void FFMediaPlayer::SetAccurateSeek(bool accurate) {
+    LOGCATE("FFMediaPlayer::SetAccurateSeek accurate=%d", accurate);
+    if(m_VideoDecoder)
+        m_VideoDecoder->SetAccurateSeek(accurate);
+
+    if(m_AudioDecoder)
+        m_AudioDecoder->SetAccurateSeek(accurate);
+
+}
+
+/**
+ * @brief 设置直播的目标延迟
+ * @param latencyMs 目标延迟（毫秒）
+ *
+ * 直播模式下延迟超过目标时音视频解码器各自加速或丢帧追赶，两者使用相同的目标
+ */
+void FFMediaPlayer::SetLatencyTarget(int latencyMs) {
+    LOGCATE("FFMediaPlayer::SetLatencyTarget latencyMs=%d", latencyMs);
+    if(m_VideoDecoder)
+        m_VideoDecoder->SetLatencyTarget(latencyMs);
+
+    if(m_AudioDecoder)
+        m_AudioDecoder->SetLatencyTarget(latencyMs);
+
+}
+
 /**
  * @brief 获取媒体参数
  * @param paramType 参数类型（视频宽度/高度/时长等）
@@ -159,10 +213,10 @@ long FFMediaPlayer::GetMediaParams(int paramType) {
     switch(paramType)
     {
         case MEDIA_PARAM_VIDEO_WIDTH:
-            value = m_VideoDecoder != nullptr ? m_VideoDecoder->GetVideoWidth() : 0;
+            value = m_VideoDecoder != nullptr ? m_VideoDecoder->GetDisplayWidth() : 0;
             break;
         case MEDIA_PARAM_VIDEO_HEIGHT:
-            value = m_VideoDecoder != nullptr ? m_VideoDecoder->GetVideoHeight() : 0;
+            value = m_VideoDecoder != nullptr ? m_VideoDecoder->GetDisplayHeight() : 0;
             break;
         case MEDIA_PARAM_VIDEO_DURATION:
             value = m_VideoDecoder != nullptr ? m_VideoDecoder->GetDuration() : 0;
@@ -229,21 +283,9 @@ void FFMediaPlayer::PostMessage(void *context, int msgType, float msgCode) {
     if(context != nullptr)
     {
         FFMediaPlayer *player = static_cast<FFMediaPlayer *>(context);
-        bool isAttach = false;
-        // 获取JNI环境，如果是新线程则附加到JVM
-        JNIEnv *env = player->GetJNIEnv(&isAttach);
-        LOGCATE("FFMediaPlayer::PostMessage env=%p", env);
-        if(env == nullptr)
-            return;
-        jobject javaObj = player->GetJavaObj();
-        // 获取Java层的回调方法ID（方法签名：void playerEventCallback(int msgType, float msgCode)）
-        jmethodID mid = env->GetMethodID(env->GetObjectClass(javaObj), JAVA_PLAYER_EVENT_CALLBACK_API_NAME, "(IF)V");
-        // 调用Java层的回调方法
-        env->CallVoidMethod(javaObj, mid, msgType, msgCode);
-        // 如果线程是新附加的，使用完后需要从JVM分离
-        if(isAttach)
-            player->GetJavaVM()->DetachCurrentThread();
-
+        // 放入事件队列，由事件分发线程回调Java层的 playerEventCallback(int msgType, float msgCode)
+        if(player->m_EventDispatcher)
+            player->m_EventDispatcher->Post(msgType, msgCode);
     }
 }
 
@@ -59,6 +59,24 @@ public:
      */
     virtual void SeekToPosition(float position);
 
+    /**
+     * @brief 拖动预览（只解码关键帧）
+     * @param position 目标位置
+     */
+    virtual void ScrubToPosition(float position);
+
+    /**
+     * @brief 设置是否精确 seek
+     * @param accurate 是否精确 seek，默认开启
+     */
+    virtual void SetAccurateSeek(bool accurate);
+
+    /**
+     * @brief 设置直播的目标延迟
+     * @param latencyMs 目标延迟（毫秒），默认 LIVE_LATENCY_TARGET
+     */
+    virtual void SetLatencyTarget(int latencyMs);
+
     /**
      * @brief 获取媒体参数
      * @param paramType 参数类型
@@ -53,6 +53,7 @@ void HWCodecPlayer::Init(JNIEnv *jniEnv, jobject obj, char *url, int videoRender
     // 保存JNI相关对象
     jniEnv->GetJavaVM(&m_JavaVM);
     m_JavaObj = jniEnv->NewGlobalRef(obj);
+    StartEventDispatcher();
 
 }
 
@@ -62,6 +63,7 @@ void HWCodecPlayer::Init(JNIEnv *jniEnv, jobject obj, char *url, int videoRender
 void HWCodecPlayer::UnInit() {
     LOGCATE("HWCodecPlayer::UnInit");
     // 先停止播放
+    long startTime = GetSysCurrentTime();
     Stop();
 
     // 等待解封装线程结束
@@ -70,6 +72,11 @@ void HWCodecPlayer::UnInit() {
         delete m_DeMuxThread;
         m_DeMuxThread = nullptr;
     }
+    StreamInfoCache::UnInit(m_Url);
+    LOGCATE("HWCodecPlayer::UnInit teardown cost=%lldms", (long long) (GetSysCurrentTime() - startTime));
+
+    // 所有线程已经结束，停止事件分发线程
+    StopEventDispatcher();
 
     // 释放数据包队列
     if(m_VideoPacketQueue) {
@@ -121,6 +128,8 @@ void HWCodecPlayer::Pause() {
     LOGCATE("HWCodecPlayer::Pause");
     std::unique_lock<std::mutex> lock(m_Mutex);
     m_PlayerState = PLAYER_STATE_PAUSE;
+    lock.unlock();
+    NotifyBufferWaiters();
 }
 
 /**
@@ -131,6 +140,11 @@ void HWCodecPlayer::Stop() {
     std::unique_lock<std::mutex> lock(m_Mutex);
     m_PlayerState = PLAYER_STATE_STOP;
     m_Cond.notify_all();  // 唤醒所有等待的线程
+    lock.unlock();
+    NotifyBufferWaiters();
+    // 唤醒阻塞在空队列上的解码线程
+    if(m_VideoPacketQueue) m_VideoPacketQueue->Abort();
+    if(m_AudioPacketQueue) m_AudioPacketQueue->Abort();
 }
 
 /**
@@ -140,9 +154,12 @@ void HWCodecPlayer::Stop() {
 void HWCodecPlayer::SeekToPosition(float position) {
     LOGCATE("HWCodecPlayer::SeekToPosition position=%f", position);
     std::unique_lock<std::mutex> lock(m_Mutex);
+    m_SeekRequestTime = GetSysCurrentTime();
     m_SeekPosition = position;
     m_PlayerState = PLAYER_STATE_PLAYING;
     m_Cond.notify_all();
+    lock.unlock();
+    NotifyBufferWaiters();
 }
 
 /**
@@ -213,17 +230,8 @@ void HWCodecPlayer::PostMessage(void *context, int msgType, float msgCode) {
     if(context != nullptr)
     {
         HWCodecPlayer *player = static_cast<HWCodecPlayer *>(context);
-        bool isAttach = false;
-        JNIEnv *env = player->GetJNIEnv(&isAttach);
-        LOGCATE("HWCodecPlayer::PostMessage env=%p", env);
-        if(env == nullptr)
-            return;
-        jobject javaObj = player->GetJavaObj();
-        jmethodID mid = env->GetMethodID(env->GetObjectClass(javaObj), JAVA_PLAYER_EVENT_CALLBACK_API_NAME, "(IF)V");
-        env->CallVoidMethod(javaObj, mid, msgType, msgCode);
-        if(isAttach)
-            player->GetJavaVM()->DetachCurrentThread();
-
+        if(player->m_EventDispatcher)
+            player->m_EventDispatcher->Post(msgType, msgCode);
     }
 }
 
@@ -271,18 +279,10 @@ int HWCodecPlayer::DoMuxLoop() {
     }
     int result = 0;
     AVPacket avPacket = {0};
+    WakeupCounter wakeups("HWCodecPlayer::DoMuxLoop");
     for(;;) {
-        // 处理暂停状态
-        double passTimes = 0;
-        while (m_PlayerState == PLAYER_STATE_PAUSE) {
-            double lastSysTime = GetSysCurrentTime();
-            std::unique_lock<std::mutex> lock(m_Mutex);
-            LOGCATE("HWCodecPlayer::DoMuxLoop waiting .......");
-            m_Cond.wait_for(lock, std::chrono::milliseconds(10));
-            // 计算暂停时间，调整时间基准
-            passTimes = GetSysCurrentTime() - lastSysTime;
-            m_CommonStartBase += passTimes;
-        }
+        // 处理暂停状态，暂停的时间计入时间基准
+        m_CommonStartBase += WaitWhilePaused(&wakeups);
 
         // 处理停止状态
         if(m_PlayerState == PLAYER_STATE_STOP) {
@@ -296,27 +296,37 @@ int HWCodecPlayer::DoMuxLoop() {
             int64_t seek_target = static_cast<int64_t>(m_SeekPosition * 1000000);
             int64_t seek_min = INT64_MIN;
             int64_t seek_max = INT64_MAX;
-            int seek_ret = avformat_seek_file(m_AVFormatContext, -1, seek_min, seek_target, seek_max, 0);
-            LOGCATE("HWCodecPlayer::DoMuxLoop seeking 11 m_SeekPosition=%f", m_SeekPosition);
+            // 优先按关键帧索引以字节位置 seek
+            int64_t seekStart = av_gettime_relative();
+            m_IODeadline = seekStart + IO_OPEN_TIMEOUT;
+            int seek_ret = -1;
+            if(m_KeyFrameIndex && m_KeyFrameIndex->IsReady()) {
+                seek_ret = m_KeyFrameIndex->Seek(m_AVFormatContext, m_VideoStreamIdx != -1 ? m_VideoStreamIdx : m_AudioStreamIdx, seek_target);
+            }
+            bool byIndex = seek_ret >= 0;
+            if(seek_ret < 0) {
+                seek_ret = avformat_seek_file(m_AVFormatContext, -1, seek_min, seek_target, seek_max, 0);
+            }
+            m_IODeadline = 0;
+            LOGCATE("HWCodecPlayer::DoMuxLoop seeking 11 m_SeekPosition=%f, cost=%lldus, byIndex=%d", m_SeekPosition,
+                    (long long) (av_gettime_relative() - seekStart), byIndex);
             if (seek_ret < 0) {
                 m_SeekSuccess = false;
                 LOGCATE("HWCodecPlayer::DoMuxLoop error while seeking");
             } else {
-                std::unique_lock<std::mutex> vBufLock(m_VideoBufMutex);
-                LOGCATE("HWCodecPlayer::DoMuxLoop seeking 22 m_SeekPosition=%f", m_SeekPosition);
-                avcodec_flush_buffers(m_VideoCodecCtx);
-                AMediaCodec_flush(m_MediaCodec);
+                //清空队列并入队刷新标记，解码线程取到标记后自己刷新解码器，丢弃 seek 之前的数据包和帧，这里不需要等待解码线程
                 m_VideoStartBase = 0;
-                m_VideoPacketQueue->Flush();
-                vBufLock.unlock();
-                LOGCATE("HWCodecPlayer::DoMuxLoop seeking 222 m_SeekPosition=%f", m_SeekPosition);
-                unique_lock<mutex> aBufLock(m_AudioBufMutex);
-                LOGCATE("HWCodecPlayer::DoMuxLoop seeking 33 m_SeekPosition=%f", m_SeekPosition);
-                avcodec_flush_buffers(m_AudioCodecCtx);
+                m_VideoPacketQueue->PushFlushPacket();
                 m_AudioStartBase = 0;
-                m_AudioPacketQueue->Flush();
-                aBufLock.unlock();
-                LOGCATE("HWCodecPlayer::DoMuxLoop seeking 333 m_SeekPosition=%f", m_SeekPosition);
+                m_AudioPacketQueue->PushFlushPacket();
+                LOGCATE("HWCodecPlayer::DoMuxLoop seeking 22 m_SeekPosition=%f, video serial=%d, audio serial=%d", m_SeekPosition,
+                        m_VideoPacketQueue->GetSerial(), m_AudioPacketQueue->GetSerial());
+                //seek 之后重新缓冲到低水位
+                std::unique_lock<std::mutex> bufLock(m_BufferMutex);
+                m_ReadEOF = false;
+                bool started = StartBuffering();
+                bufLock.unlock();
+                if(started) PostMessage(this, MSG_BUFFERING_START, 0);
                 m_SeekPosition = -1;
                 //ClearCache();
                 m_SeekSuccess = true;
@@ -324,16 +334,14 @@ int HWCodecPlayer::DoMuxLoop() {
             }
         }
 
+        int64_t readStart = av_gettime_relative();
+        m_IODeadline = readStart + IO_READ_TIMEOUT;
+        m_Reading = true;
         result = av_read_frame(m_AVFormatContext, &avPacket);
+        m_Reading = false;
+        m_IODeadline = 0;
+        int64_t readCost = av_gettime_relative() - readStart;
         if(result >= 0) {
-            double bufferDuration = m_VideoPacketQueue->GetDuration() * av_q2d(m_VideoTimeBase);
-            LOGCATE("HWCodecPlayer::DoMuxLoop bufferDuration=%lfs", bufferDuration);
-            //防止缓冲数据包过多
-            while (BUFF_MAX_VIDEO_DURATION < bufferDuration && m_PlayerState == PLAYER_STATE_PLAYING && m_SeekPosition < 0) {
-                bufferDuration = m_VideoPacketQueue->GetDuration() * av_q2d(m_VideoTimeBase);
-                usleep(10 * 1000);
-            }
-
             if(avPacket.stream_index == m_VideoStreamIdx) {
                 m_VideoPacketQueue->PushPacket(&avPacket);
             } else if(avPacket.stream_index == m_AudioStreamIdx) {
@@ -341,13 +349,126 @@ int HWCodecPlayer::DoMuxLoop() {
             } else {
                 av_packet_unref(&avPacket);
             }
+
+            {
+                std::unique_lock<std::mutex> bufLock(m_BufferMutex);
+                //读取卡顿用于调整水位
+                m_BufferingPolicy.OnRead(readCost);
+            }
+            UpdateBufferingState();
+
+            //缓冲超过高水位时等待解码线程消费，消费后由条件变量唤醒；
+            //字节数上限在缓冲中同样生效，达到上限时 UpdateBufferingState 会结束缓冲，不会互相等待
+            std::unique_lock<std::mutex> bufLock(m_BufferMutex);
+            while ((m_BufferingPolicy.IsOverMaxBytes() || (!m_Buffering && m_BufferingPolicy.IsFull())) &&
+                   m_PlayerState == PLAYER_STATE_PLAYING && m_SeekPosition < 0) {
+                m_BufferCond.wait(bufLock);
+                wakeups.OnWakeup();
+            }
+        } else if(result == AVERROR_EXIT) {
+            //I/O 被停止、seek 或超时中断，下一轮循环处理停止和 seek，超时则重试读取
+            LOGCATE("HWCodecPlayer::DoMuxLoop I/O interrupted");
         } else {
-            //解码结束，暂停解码器
-            std::unique_lock<std::mutex> lock(m_Mutex);
-            m_PlayerState = PLAYER_STATE_PAUSE;
+            //读到文件末尾，剩余的数据不足低水位也要播完
+            {
+                std::unique_lock<std::mutex> bufLock(m_BufferMutex);
+                m_ReadEOF = true;
+            }
+            UpdateBufferingState();
+            //解码线程继续播完队列中剩余的数据，这里等待 seek 或停止
+            std::unique_lock<std::mutex> bufLock(m_BufferMutex);
+            while (m_ReadEOF && m_PlayerState != PLAYER_STATE_STOP && m_SeekPosition < 0) {
+                m_BufferCond.wait(bufLock);
+                wakeups.OnWakeup();
+            }
         }
     }
-    LOGCATE("HWCodecPlayer::DoMuxLoop end");
+    LOGCATE("HWCodecPlayer::DoMuxLoop end, rebuffer count=%d", m_RebufferCount);
+    wakeups.Report();
+    return 0;
+}
+
+long HWCodecPlayer::WaitWhilePaused(WakeupCounter *wakeups) {
+    if(m_PlayerState != PLAYER_STATE_PAUSE) return 0;
+    long pauseStart = GetSysCurrentTime();
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    while (m_PlayerState == PLAYER_STATE_PAUSE) {
+        //Play、Stop、SeekToPosition 修改状态后通知
+        m_Cond.wait(lock);
+        wakeups->OnWakeup();
+    }
+    return GetSysCurrentTime() - pauseStart;
+}
+
+bool HWCodecPlayer::StartBuffering() {
+    if(m_Buffering) return false;
+    m_Buffering = true;
+    m_BufferingStartTime = av_gettime_relative();
+    return true;
+}
+
+void HWCodecPlayer::UpdateBufferingState() {
+    std::unique_lock<std::mutex> lock(m_BufferMutex);
+    //队列已经达到字节数上限时读取会停下来，只能结束缓冲
+    if(!m_Buffering || !(m_ReadEOF || m_BufferingPolicy.IsEnough() || m_BufferingPolicy.IsOverMaxBytes()))
+        return;
+    m_Buffering = false;
+    m_BufferCond.notify_all();
+    LOGCATE("HWCodecPlayer::UpdateBufferingState buffering end, cost=%lldms, low watermark=%.3fs, eof=%d",
+            (long long) (av_gettime_relative() - m_BufferingStartTime) / 1000, m_BufferingPolicy.GetLowDuration(), m_ReadEOF);
+    lock.unlock();
+    PostMessage(this, MSG_BUFFERING_END, 0);
+}
+
+bool HWCodecPlayer::WaitForBuffering(AVPacketQueue *queue, WakeupCounter *wakeups) {
+    std::unique_lock<std::mutex> lock(m_BufferMutex);
+    if(!m_Buffering && !m_ReadEOF && queue->GetPacketSize() == 0 && m_SeekPosition < 0) {
+        //队列读空：网络跟不上播放，进入缓冲
+        StartBuffering();
+        m_RebufferCount++;
+        LOGCATE("HWCodecPlayer::WaitForBuffering buffering start, rebuffer count=%d", m_RebufferCount);
+        lock.unlock();
+        PostMessage(this, MSG_BUFFERING_START, 0);
+        lock.lock();
+    }
+    while (m_Buffering && m_PlayerState == PLAYER_STATE_PLAYING && m_SeekPosition < 0) {
+        m_BufferCond.wait(lock);
+        wakeups->OnWakeup();
+    }
+    return !m_Buffering && m_PlayerState == PLAYER_STATE_PLAYING;
+}
+
+AudioRender *HWCodecPlayer::CreateAudioRender() {
+#if HW_PLAYER_AUDIO_SINK == AUDIO_SINK_NULL
+    return new FileAudioRender();
+#elif HW_PLAYER_AUDIO_SINK == AUDIO_SINK_FILE
+    return new FileAudioRender(HW_PLAYER_AUDIO_DUMP_PATH);
+#else
+    return new OpenSLRender();
+#endif
+}
+
+void HWCodecPlayer::NotifyBufferWaiters() {
+    //先获取一次锁，保证等待的线程要么还没检查条件，要么已经进入等待，不会丢失通知
+    {
+        std::unique_lock<std::mutex> lock(m_BufferMutex);
+    }
+    m_BufferCond.notify_all();
+}
+
+int HWCodecPlayer::InterruptCallback(void *ctx) {
+    HWCodecPlayer *player = static_cast<HWCodecPlayer *>(ctx);
+    if(player->m_PlayerState == PLAYER_STATE_STOP) {
+        return 1;
+    }
+    if(player->m_Reading && player->m_SeekPosition >= 0) {
+        return 1;
+    }
+    int64_t deadline = player->m_IODeadline;
+    if(deadline > 0 && av_gettime_relative() > deadline) {
+        LOGCATE("HWCodecPlayer::InterruptCallback I/O timeout");
+        return 1;
+    }
     return 0;
 }
 
@@ -360,42 +481,54 @@ void HWCodecPlayer::AudioDecodeThreadProc(HWCodecPlayer *player) {
     AVPacket *audioPacket = av_packet_alloc();
     AVFrame *audioFrame = av_frame_alloc();
 
-    uint8_t *audioOutBuffer = (uint8_t *)malloc(AUDIO_DST_SAMPLE_RATE * 2);
+    //重采样输出缓冲区，容纳 1 秒的双声道 16 位数据
+    uint8_t *audioOutBuffer = (uint8_t *)malloc(AUDIO_DST_SAMPLE_RATE * 4);
     int outChannelNb = av_get_channel_layout_nb_channels(AV_CH_LAYOUT_STEREO);
+    int bytesPerSecond = AUDIO_DST_SAMPLE_RATE * outChannelNb * 2;
+    AudioRender *audioRender = player->m_AudioRender;
+    int64_t writtenBytes = 0;
 
-    bool isAttach = false;
-    JNIEnv *env = player->GetJNIEnv(&isAttach);
-    JavaVM *javaVm = player->m_JavaVM;
-
-    jclass activityClass = env->GetObjectClass(player->m_JavaObj);
-    jmethodID createTrackMid = env->GetMethodID(activityClass, "createTrack", "(II)V");
-    jmethodID playTrackMid = env->GetMethodID(activityClass, "playTrack", "([BI)V");
-    env->CallVoidMethod(player->m_JavaObj, createTrackMid, AUDIO_DST_SAMPLE_RATE, outChannelNb);
-
+    int decoderSerial = audioPacketQueue->GetSerial();
+    long seekStartTime = -1;
+    WakeupCounter wakeups("HWCodecPlayer::AudioDecodeThreadProc");
     for(;;) {
-        while (player->m_PlayerState == PLAYER_STATE_PAUSE) {
-            std::unique_lock<std::mutex> lock(player->m_Mutex);
-            LOGCATE("HWCodecPlayer::AudioDecodeThreadProc waiting .......");
-            player->m_Cond.wait_for(lock, std::chrono::milliseconds(10));
-        }
+        player->WaitWhilePaused(&wakeups);
 
         if(player->m_PlayerState == PLAYER_STATE_STOP) {
             break;
         }
 
-        bool isLocked = true;
-        std::unique_lock<std::mutex> lock(player->m_AudioBufMutex);
-        if(audioPacketQueue->GetPacketSize() == 0) {
-            isLocked = false;
-            lock.unlock();
-        }
-        if(audioPacketQueue->GetPacket(audioPacket) < 0)
+        //缓冲中等待数据达到低水位
+        if(!player->WaitForBuffering(audioPacketQueue, &wakeups))
+            continue;
+
+        int serial = -1;
+        if(audioPacketQueue->GetPacket(audioPacket, 1, &serial) < 0)
             break;
+        player->NotifyBufferWaiters();
+
+        //seek 之后的刷新标记，在解码线程内刷新解码器
+        if(AVPacketQueue::IsFlushPacket(audioPacket)) {
+            avcodec_flush_buffers(audioCodecCtx);
+            //丢弃 sink 中还没播放的 seek 之前的数据
+            audioRender->ClearAudioCache();
+            decoderSerial = serial;
+            seekStartTime = player->m_SeekRequestTime;
+            av_packet_unref(audioPacket);
+            continue;
+        }
+
+        //seek 之前入队的过期数据包
+        if(serial != audioPacketQueue->GetSerial()) {
+            av_packet_unref(audioPacket);
+            continue;
+        }
 
         int ret = avcodec_send_packet(audioCodecCtx, audioPacket);
+        av_packet_unref(audioPacket);
         if (ret < 0) {
             LOGCATE("HWCodecPlayer::AudioDecodeThreadProc Error submitting a av_packet for audio decoding (%s)", av_err2str(ret));
-            return;
+            continue;
         }
 
         while (ret >= 0) {
@@ -405,9 +538,33 @@ void HWCodecPlayer::AudioDecodeThreadProc(HWCodecPlayer *player) {
                 break;
             }
 
-            SyncClock* audioClock = &player->m_AudioClock;
+            //解码器还没有取到最新的刷新标记，seek 之前的帧直接丢弃
+            if(decoderSerial != audioPacketQueue->GetSerial()) {
+                av_frame_unref(audioFrame);
+                continue;
+            }
+
+            if(seekStartTime != -1) {
+                LOGCATE("HWCodecPlayer::AudioDecodeThreadProc seek to first audio frame cost=%lldms", (long long) (GetSysCurrentTime() - seekStartTime));
+                seekStartTime = -1;
+            }
+
             double presentationNano = audioFrame->pts * av_q2d(player->m_AudioTimeBase) * 1000;
-            audioClock->SetClock(presentationNano, GetSysCurrentTime());
+            int outSamples = swr_convert(player->m_SwrCtx, &audioOutBuffer, AUDIO_DST_SAMPLE_RATE, (const uint8_t **)audioFrame->data, audioFrame->nb_samples);
+            av_frame_unref(audioFrame);
+            if(outSamples <= 0) continue;
+
+            //写入 sink，队列满时阻塞到有空间为止
+            int buffer_size = av_samples_get_buffer_size(NULL, outChannelNb, outSamples, AV_SAMPLE_FMT_S16, 1);
+            audioRender->RenderAudioFrame(audioOutBuffer, buffer_size);
+            writtenBytes += buffer_size;
+
+            //音频时钟取 sink 实际播放到的位置：本帧结束时间减去已写入但还没播放的数据时长
+            SyncClock* audioClock = &player->m_AudioClock;
+            double frameEndMs = presentationNano + outSamples * 1000.0 / AUDIO_DST_SAMPLE_RATE;
+            int64_t playedBytes = audioRender->GetPlayedBytes();
+            double playPosition = playedBytes >= 0 ? frameEndMs - (writtenBytes - playedBytes) * 1000.0 / bytesPerSecond : presentationNano;
+            audioClock->SetClock(playPosition, GetSysCurrentTime());
 //            player->AVSync();
 //            if(player->m_AudioStartBase <= 0)
 //                player->m_AudioStartBase = GetSysCurrentTime() - presentationNano;
@@ -422,19 +579,9 @@ void HWCodecPlayer::AudioDecodeThreadProc(HWCodecPlayer *player) {
 //            }
 
             if(player->m_SeekPosition < 0)
-                PostMessage(player, MSG_DECODING_TIME, presentationNano * 1.0f / 1000);
-            LOGCATE("HWCodecPlayer::AudioDecodeThreadProc sync audio curPts = %lf", presentationNano);
-
-            swr_convert(player->m_SwrCtx, &audioOutBuffer, AUDIO_DST_SAMPLE_RATE * 2, (const uint8_t **)audioFrame->data, audioFrame->nb_samples);
-            int buffer_size = av_samples_get_buffer_size(NULL, outChannelNb, audioFrame->nb_samples, AV_SAMPLE_FMT_S16, 1);
-            jbyteArray audio_sample_array = env->NewByteArray(buffer_size);
-            env->SetByteArrayRegion(audio_sample_array, 0, buffer_size, (const jbyte *)audioOutBuffer);
-            env->CallVoidMethod(player->m_JavaObj, playTrackMid, audio_sample_array, buffer_size);
-            env->DeleteLocalRef(audio_sample_array);
-            av_frame_unref(audioFrame);
-            av_packet_unref(audioPacket);
+                PostMessage(player, MSG_DECODING_TIME, playPosition * 1.0f / 1000);
+            LOGCATE("HWCodecPlayer::AudioDecodeThreadProc sync audio curPts = %lf, play position = %lf", presentationNano, playPosition);
         }
-        if(isLocked) lock.unlock();
     }
 
     if(audioPacket != nullptr) {
@@ -451,9 +598,7 @@ void HWCodecPlayer::AudioDecodeThreadProc(HWCodecPlayer *player) {
         free(audioOutBuffer);
     }
 
-    if(isAttach)
-        javaVm->DetachCurrentThread();
-
+    wakeups.Report();
     LOGCATE("HWCodecPlayer::AudioDecodeThreadProc end");
 }
 
@@ -462,82 +607,175 @@ void HWCodecPlayer::VideoDecodeThreadProc(HWCodecPlayer *player) {
     AVPacketQueue* videoPacketQueue = player->m_VideoPacketQueue;
     AMediaCodec* videoCodec = player->m_MediaCodec;
     AVPacket *packet = av_packet_alloc();
+    AVPacket *filtered = av_packet_alloc();
+    WakeupCounter wakeups("HWCodecPlayer::VideoDecodeThreadProc");
     for(;;) {
-        while (player->m_PlayerState == PLAYER_STATE_PAUSE) {
-            std::unique_lock<std::mutex> lock(player->m_Mutex);
-            LOGCATE("HWCodecPlayer::VideoDecodeThreadProc waiting .......");
-            player->m_Cond.wait_for(lock, std::chrono::milliseconds(10));
-        }
+        player->WaitWhilePaused(&wakeups);
 
         if(player->m_PlayerState == PLAYER_STATE_STOP) {
             break;
         }
 
-        bool isLocked = true;
-        std::unique_lock<std::mutex> lock(player->m_VideoBufMutex);
-        if(videoPacketQueue->GetPacketSize() == 0) {
-            isLocked = false;
-            lock.unlock();
-        }
-        if(videoPacketQueue->GetPacket(packet) < 0) {
+        //缓冲中等待数据达到低水位
+        if(!player->WaitForBuffering(videoPacketQueue, &wakeups))
+            continue;
+
+        int serial = -1;
+        if(videoPacketQueue->GetPacket(packet, 1, &serial) < 0) {
             break;
         }
+        player->NotifyBufferWaiters();
+
+        //seek 之后的刷新标记，等输出线程交还输出缓冲区后刷新解码器
+        if(AVPacketQueue::IsFlushPacket(packet)) {
+            std::unique_lock<std::mutex> codecLock(player->m_CodecMutex);
+            AMediaCodec_flush(videoCodec);
+            player->m_CodecFlushCount++;
+            player->m_VideoDecoderSerial = serial;
+            player->m_VideoSeekStartTime = player->m_SeekRequestTime;
+            codecLock.unlock();
+            if(player->m_BsfCtx) av_bsf_flush(player->m_BsfCtx);
+            av_packet_unref(packet);
+            continue;
+        }
+
+        //seek 之前入队的过期数据包
+        if(serial != videoPacketQueue->GetSerial()) {
+            av_packet_unref(packet);
+            continue;
+        }
         LOGCATI("HWCodecPlayer::VideoDecodeThreadProc packetSize=%d, buffTime=%lfs",videoPacketQueue->GetPacketSize(), videoPacketQueue->GetDuration()* av_q2d(player->m_VideoTimeBase));
-        ssize_t bufIdx = -1;
-        bufIdx = AMediaCodec_dequeueInputBuffer(videoCodec, 0);
-        if (bufIdx >= 0) {
-            size_t bufSize;
-            auto buf = AMediaCodec_getInputBuffer(videoCodec, bufIdx, &bufSize);
-            av_bitstream_filter_filter(player->m_Bsfc, player->m_VideoCodecCtx, NULL, &packet->data, &packet->size, packet->data, packet->size,
-                                       packet->flags & AV_PKT_FLAG_KEY);
-            LOGCATI("HWCodecPlayer::VideoDecodeThreadProc 0x%02X 0x%02X 0x%02X 0x%02X \n",packet->data[0],packet->data[1],packet->data[2],packet->data[3]);
-            memcpy(buf, packet->data, packet->size);
-            AMediaCodec_queueInputBuffer(videoCodec, bufIdx, 0, packet->size, packet->pts, 0);
-        }
-        av_packet_unref(packet);
+        int result = 0;
+        if(player->m_BsfCtx) {
+            //过滤器接管 packet 的引用，输出写入复用的 filtered，直通时不产生新的缓冲区
+            uint8_t *inData = packet->data;
+            if(av_bsf_send_packet(player->m_BsfCtx, packet) < 0) {
+                av_packet_unref(packet);
+            }
+            while (result == 0 && av_bsf_receive_packet(player->m_BsfCtx, filtered) == 0) {
+                result = player->QueueVideoInput(filtered, filtered->data != inData, serial, &wakeups);
+                av_packet_unref(filtered);
+            }
+        } else {
+            //Annex B 码流直接写入 MediaCodec 输入缓冲区
+            result = player->QueueVideoInput(packet, false, serial, &wakeups);
+            av_packet_unref(packet);
+        }
+
+        //丢掉一帧之后的帧都会花屏，停止送包并通知上层
+        if(result < 0) {
+            LOGCATE("HWCodecPlayer::VideoDecodeThreadProc queue input fail, result=%d, stop decoding", result);
+            PostMessage(player, MSG_DECODER_ERROR, result);
+            break;
+        }
+    }
+
+    if(packet != nullptr) {
+        av_packet_free(&packet);
+        packet = nullptr;
+    }
+    av_packet_free(&filtered);
+    wakeups.Report();
+    LOGCATE("HWCodecPlayer::VideoDecodeThreadProc end");
+}
+
+void HWCodecPlayer::VideoRenderThreadProc(HWCodecPlayer *player) {
+    LOGCATE("HWCodecPlayer::VideoRenderThreadProc start");
+    AVPacketQueue* videoPacketQueue = player->m_VideoPacketQueue;
+    AMediaCodec* videoCodec = player->m_MediaCodec;
+    WakeupCounter wakeups("HWCodecPlayer::VideoRenderThreadProc");
+    for(;;) {
+        player->WaitWhilePaused(&wakeups);
+
+        if(player->m_PlayerState == PLAYER_STATE_STOP) {
+            break;
+        }
+
+        //等待输出帧期间不持有锁，送包线程可以随时刷新解码器；用 flush 次数判断取出的缓冲区是否跨过了 flush
+        std::unique_lock<std::mutex> codecLock(player->m_CodecMutex);
+        int flushCount = player->m_CodecFlushCount;
+        codecLock.unlock();
+
         AMediaCodecBufferInfo info;
-        auto status = AMediaCodec_dequeueOutputBuffer(videoCodec, &info, 1000);
-        LOGCATI("HWCodecPlayer::VideoDecodeThreadProc status: %d\n", status);
-        uint8_t* buffer;
-        if (status >= 0) {
+        auto status = AMediaCodec_dequeueOutputBuffer(videoCodec, &info, VIDEO_OUTPUT_DEQUEUE_TIMEOUT);
+        LOGCATI("HWCodecPlayer::VideoRenderThreadProc status: %zd\n", status);
+        if (status >= 0) codecLock.lock();
+        if (status >= 0 && flushCount != player->m_CodecFlushCount) {
+            //等待期间发生了 flush，无法确定缓冲区属于 flush 之前还是之后：不渲染直接归还，
+            //属于 flush 之前时 MediaCodec 返回错误，不影响解码
+            AMediaCodec_releaseOutputBuffer(videoCodec, status, false);
+        } else if (status >= 0 && player->m_VideoDecoderSerial != videoPacketQueue->GetSerial()) {
+            //解码器还没有取到最新的刷新标记，seek 之前的帧不渲染
+            AMediaCodec_releaseOutputBuffer(videoCodec, status, false);
+        } else if (status >= 0) {
+            //同步休眠期间不持有锁，送包线程可以继续刷新解码器
+            codecLock.unlock();
+
+            long seekStartTime = player->m_VideoSeekStartTime;
+            if(seekStartTime != -1) {
+                LOGCATE("HWCodecPlayer::VideoRenderThreadProc seek to first video frame cost=%lldms", (long long) (GetSysCurrentTime() - seekStartTime));
+                player->m_VideoSeekStartTime = -1;
+            }
+            if(player->m_OpenStartTime != -1) {
+                LOGCATE("HWCodecPlayer::VideoRenderThreadProc open to first frame cost=%lldms", (long long) (GetSysCurrentTime() - player->m_OpenStartTime));
+                player->m_OpenStartTime = -1;
+            }
             SyncClock* videoClock = &player->m_VideoClock;
             double presentationNano = info.presentationTimeUs * av_q2d(player->m_VideoTimeBase) * 1000;
             videoClock->SetClock(presentationNano, GetSysCurrentTime());
             player->AVSync();
-//            if(player->m_VideoStartBase <= 0)
-//                player->m_VideoStartBase = GetSysCurrentTime() - presentationNano;
-//
-//            if(player->m_VideoStartBase > player->m_AudioStartBase)
-//                player->m_CommonStartBase = player->m_VideoStartBase;
-//
-//            int delay = player->m_CommonStartBase + presentationNano - GetSysCurrentTime();
-//            if(delay > 0) {
-//                int sleepMs = delay > MAX_SYNC_SLEEP_TIME ? MAX_SYNC_SLEEP_TIME : delay;
-//                usleep(sleepMs * 1000);
-//            }
+            LOGCATI("HWCodecPlayer::VideoRenderThreadProc sync video curPts = %lf", presentationNano);
 
-            size_t size;
-            LOGCATI("HWCodecPlayer::VideoDecodeThreadProc sync video curPts = %lf", presentationNano);
-            buffer = AMediaCodec_getOutputBuffer(videoCodec, status, &size);
-            LOGCATI("HWCodecPlayer::VideoDecodeThreadProc buffer: %p, buffer size: %d", buffer, size);
-            AMediaCodec_releaseOutputBuffer(videoCodec, status, info.size != 0);
+            codecLock.lock();
+            //休眠期间发生了 flush，输出缓冲区已经归还解码器
+            if(flushCount == player->m_CodecFlushCount)
+                AMediaCodec_releaseOutputBuffer(videoCodec, status, info.size != 0);
         } else if (status == AMEDIACODEC_INFO_OUTPUT_BUFFERS_CHANGED) {
-            LOGCATI("HWCodecPlayer::VideoDecodeThreadProc output buffers changed");
+            LOGCATI("HWCodecPlayer::VideoRenderThreadProc output buffers changed");
         } else if (status == AMEDIACODEC_INFO_OUTPUT_FORMAT_CHANGED) {
-            LOGCATI("HWCodecPlayer::VideoDecodeThreadProc output format changed");
+            LOGCATI("HWCodecPlayer::VideoRenderThreadProc output format changed");
         } else if (status == AMEDIACODEC_INFO_TRY_AGAIN_LATER) {
-            LOGCATI("HWCodecPlayer::VideoDecodeThreadProc no output buffer right now");
+            LOGCATI("HWCodecPlayer::VideoRenderThreadProc no output buffer right now");
+            wakeups.OnWakeup();
         } else {
-            LOGCATI("HWCodecPlayer::VideoDecodeThreadProc unexpected info code: %zd", status);
+            LOGCATI("HWCodecPlayer::VideoRenderThreadProc unexpected info code: %zd", status);
         }
-        if(isLocked) lock.unlock();
     }
+    wakeups.Report();
+    LOGCATE("HWCodecPlayer::VideoRenderThreadProc end");
+}
 
-    if(packet != nullptr) {
-        av_packet_free(&packet);
-        packet = nullptr;
+int HWCodecPlayer::QueueVideoInput(AVPacket *pkt, bool allocated, int serial, WakeupCounter *wakeups) {
+    ssize_t bufIdx;
+    for(;;) {
+        bufIdx = AMediaCodec_dequeueInputBuffer(m_MediaCodec, VIDEO_INPUT_DEQUEUE_TIMEOUT);
+        if (bufIdx >= 0) break;
+        //输入缓冲区都被占用，等待输出线程取走解码后的帧；停止或者 seek 之后这个数据包不再需要
+        wakeups->OnWakeup();
+        if (m_PlayerState == PLAYER_STATE_STOP || serial != m_VideoPacketQueue->GetSerial()) return 0;
+        WaitWhilePaused(wakeups);
     }
-    LOGCATE("HWCodecPlayer::VideoDecodeThreadProc end");
+
+    size_t bufSize = 0;
+    uint8_t *buf = AMediaCodec_getInputBuffer(m_MediaCodec, bufIdx, &bufSize);
+    if(buf == nullptr || (size_t) pkt->size > bufSize) {
+        //取出的输入缓冲区只能以空数据交还，这个数据包无法送入解码器
+        LOGCATE("HWCodecPlayer::QueueVideoInput packet too large, size=%d, bufSize=%zu", pkt->size, bufSize);
+        AMediaCodec_queueInputBuffer(m_MediaCodec, bufIdx, 0, 0, pkt->pts, 0);
+        return AVERROR(ENOBUFS);
+    }
+    memcpy(buf, pkt->data, pkt->size);
+    AMediaCodec_queueInputBuffer(m_MediaCodec, bufIdx, 0, pkt->size, pkt->pts, 0);
+
+    m_VideoInputPackets++;
+    m_VideoInputBytes += pkt->size;
+    if(allocated) m_VideoInputAllocs++;
+    if(m_VideoInputPackets % VIDEO_INPUT_STATS_INTERVAL == 0) {
+        LOGCATE("HWCodecPlayer::QueueVideoInput packets=%lld, bytes copied/packet=%.0f, allocations/packet=%.2f",
+                (long long) m_VideoInputPackets, (double) m_VideoInputBytes / m_VideoInputPackets,
+                (double) m_VideoInputAllocs / m_VideoInputPackets);
+    }
+    return 0;
 }
 
 void HWCodecPlayer::SetMediaParams(int paramType, jobject obj) {
@@ -560,22 +798,59 @@ void HWCodecPlayer::SetMediaParams(int paramType, jobject obj) {
 int HWCodecPlayer::InitDecoder() {
     LOGCATE("HWCodecPlayer::InitDecoder");
     int result = -1;
+    m_OpenStartTime = GetSysCurrentTime();
+    long openInputTime = -1, streamInfoTime = -1;
+    const char *streamInfoMode = "full";
     do {
-        //1.创建封装格式上下文
+        //1.创建封装格式上下文，设置 I/O 中断回调，停止时不必等网络超时
         m_AVFormatContext = avformat_alloc_context();
+        m_AVFormatContext->interrupt_callback.callback = InterruptCallback;
+        m_AVFormatContext->interrupt_callback.opaque = this;
+
+        //2.打开文件，本地文件和 asset 通过 mmap 读取
+        char url[MAX_PATH] = {0};
+        strncpy(url, m_Url, MAX_PATH - 1);
+        int assetFd = -1;
+        if(strncmp(m_Url, HW_PLAYER_ASSET_PREFIX, strlen(HW_PLAYER_ASSET_PREFIX)) == 0 && m_AssetMgr != nullptr) {
+            bool isAttach = false;
+            JNIEnv *env = GetJNIEnv(&isAttach);
+            AAsset *asset = AAssetManager_open(AAssetManager_fromJava(env, m_AssetMgr), m_Url + strlen(HW_PLAYER_ASSET_PREFIX), AASSET_MODE_RANDOM);
+            if(asset != nullptr) {
+                off_t outStart, outLen;
+                assetFd = AAsset_openFileDescriptor(asset, &outStart, &outLen);
+                if(assetFd >= 0) {
+                    MediaSource::MakeFdUrl(url, MAX_PATH, assetFd, outStart, outLen);
+                }
+                AAsset_close(asset);
+            }
+            if(isAttach)
+                GetJavaVM()->DetachCurrentThread();
+        }
 
-        //2.打开文件
-        if(avformat_open_input(&m_AVFormatContext, m_Url, nullptr, nullptr) != 0)
+        m_IODeadline = av_gettime_relative() + IO_OPEN_TIMEOUT;
+        int openResult = MediaSource::Open(&m_AVFormatContext, url, nullptr, &m_MediaSource);
+        m_IODeadline = 0;
+        //映射建立后 asset fd 不再需要
+        if(assetFd >= 0) close(assetFd);
+        if(openResult != 0)
         {
             LOGCATE("HWCodecPlayer::InitDecoder avformat_open_input fail.");
             break;
         }
 
-        //3.获取音视频流信息
-        if(avformat_find_stream_info(m_AVFormatContext, nullptr) < 0) {
+        openInputTime = GetSysCurrentTime();
+
+        //3.获取音视频流信息，优先使用上次打开时缓存的流信息，否则以最小的探测参数快速探测
+        int findResult = StreamInfoCache::FindStreamInfo(m_AVFormatContext, m_Url, &streamInfoMode);
+        m_IODeadline = 0;
+        if(findResult < 0) {
             LOGCATE("HWCodecPlayer::InitDecoder avformat_find_stream_info fail.");
             break;
         }
+        streamInfoTime = GetSysCurrentTime();
+
+        // 后台建立关键帧索引（本地文件）
+        m_KeyFrameIndex = KeyFrameIndex::Acquire(m_Url);
 
         //4.获取音视频流索引
         AVCodec *videoCodec = nullptr, *audioCodec = nullptr;
@@ -625,72 +900,80 @@ int HWCodecPlayer::InitDecoder() {
             break;
         }
 
-        m_Bsfc = av_bitstream_filter_init("h264_mp4toannexb");
-        if(m_Bsfc == nullptr) {
-            result = -1;
-            LOGCATE("HWCodecPlayer::InitDecoder av_bitstream_filter_init(\"h264_mp4toannexb\") fail.");
-            break;
+        //MP4/MKV 中 H.264/HEVC 是长度前缀格式，MediaCodec 需要 Annex B 起始码
+        AVStream *videoStream = m_AVFormatContext->streams[m_VideoStreamIdx];
+        const char *bsfName = nullptr;
+        if(videoStream->codecpar->codec_id == AV_CODEC_ID_H264) {
+            bsfName = "h264_mp4toannexb";
+        } else if(videoStream->codecpar->codec_id == AV_CODEC_ID_HEVC) {
+            bsfName = "hevc_mp4toannexb";
+        }
+        if(bsfName != nullptr && videoStream->codecpar->extradata_size > 0 &&
+           !MediaCodecFormat::IsAnnexB(videoStream->codecpar->extradata, videoStream->codecpar->extradata_size)) {
+            const AVBitStreamFilter *bsf = av_bsf_get_by_name(bsfName);
+            if(bsf == nullptr || av_bsf_alloc(bsf, &m_BsfCtx) < 0) {
+                result = -1;
+                LOGCATE("HWCodecPlayer::InitDecoder av_bsf_alloc(\"%s\") fail.", bsfName);
+                break;
+            }
+            avcodec_parameters_copy(m_BsfCtx->par_in, videoStream->codecpar);
+            m_BsfCtx->time_base_in = videoStream->time_base;
+            result = av_bsf_init(m_BsfCtx);
+            if(result < 0) {
+                LOGCATE("HWCodecPlayer::InitDecoder av_bsf_init(\"%s\") fail. result=%d", bsfName, result);
+                break;
+            }
         }
 
-        bool isAttach = false;
-        JNIEnv *env = GetJNIEnv(&isAttach);
-
-        off_t outStart, outLen;
-        const char *fileName = "byteflow/vr.mp4";
-        int fd = AAsset_openFileDescriptor(AAssetManager_open(AAssetManager_fromJava(env, m_AssetMgr), fileName, 0),&outStart, &outLen);
-
-        m_MediaExtractor = AMediaExtractor_new();
-        media_status_t err = AMediaExtractor_setDataSourceFd(m_MediaExtractor, fd,
-                                                             static_cast<off64_t>(outStart),static_cast<off64_t>(outLen));
-        close(fd);
-        if (err != AMEDIA_OK) {
+        //5.由 FFmpeg 解封装得到的编码参数配置 MediaCodec，不再用 AMediaExtractor 重复解析文件
+        MediaCodecFormat codecFormat;
+        if(!MediaCodecFormat::FromCodecParameters(m_AVFormatContext->streams[m_VideoStreamIdx]->codecpar, &codecFormat)) {
             result = -1;
-            LOGCATE("HWCodecPlayer::InitDecoder AMediaExtractor_setDataSourceFd fail. err=%d", err);
+            LOGCATE("HWCodecPlayer::InitDecoder unsupported video codec %s.", avcodec_get_name(m_AVFormatContext->streams[m_VideoStreamIdx]->codecpar->codec_id));
             break;
         }
 
-        int numTracks = AMediaExtractor_getTrackCount(m_MediaExtractor);
-
-        LOGCATE("HWCodecPlayer::InitDecoder AMediaExtractor_getTrackCount %d tracks", numTracks);
-        for (int i = 0; i < numTracks; i++) {
-            AMediaFormat *format = AMediaExtractor_getTrackFormat(m_MediaExtractor, i);
-            const char *s = AMediaFormat_toString(format);
-            LOGCATE("HWCodecPlayer::InitDecoder track %d format: %s", i, s);
-            const char *mime;
-            if (!AMediaFormat_getString(format, AMEDIAFORMAT_KEY_MIME, &mime)) {
-                LOGCATE("HWCodecPlayer::InitDecoder no mime type");
-                result = -1;
-                break;
-            } else if (!strncmp(mime, "video/", 6)) {
-                // Omitting most error handling for clarity.
-                // Production code should check for errors.
-                AMediaExtractor_selectTrack(m_MediaExtractor, i);
-                m_MediaCodec = AMediaCodec_createDecoderByType(mime);
-                AMediaCodec_configure(m_MediaCodec, format, m_ANativeWindow, NULL, 0);
-                AMediaCodec_start(m_MediaCodec);
-            }
-            AMediaFormat_delete(format);
+        AMediaFormat *format = AMediaFormat_new();
+        AMediaFormat_setString(format, AMEDIAFORMAT_KEY_MIME, codecFormat.mime.c_str());
+        AMediaFormat_setInt32(format, AMEDIAFORMAT_KEY_WIDTH, codecFormat.width);
+        AMediaFormat_setInt32(format, AMEDIAFORMAT_KEY_HEIGHT, codecFormat.height);
+        //默认的输入缓冲区按分辨率估算，码率很高的关键帧可能放不下
+        AMediaFormat_setInt32(format, AMEDIAFORMAT_KEY_MAX_INPUT_SIZE,
+                              FFMAX(codecFormat.width * codecFormat.height * 3 / 2, VIDEO_INPUT_MIN_BUFFER_SIZE));
+        if(!codecFormat.csd0.empty())
+            AMediaFormat_setBuffer(format, "csd-0", codecFormat.csd0.data(), codecFormat.csd0.size());
+        if(!codecFormat.csd1.empty())
+            AMediaFormat_setBuffer(format, "csd-1", codecFormat.csd1.data(), codecFormat.csd1.size());
+        LOGCATE("HWCodecPlayer::InitDecoder video format: %s", AMediaFormat_toString(format));
+
+        m_MediaCodec = AMediaCodec_createDecoderByType(codecFormat.mime.c_str());
+        media_status_t err = AMEDIA_ERROR_UNKNOWN;
+        if(m_MediaCodec != nullptr) {
+            err = AMediaCodec_configure(m_MediaCodec, format, m_ANativeWindow, NULL, 0);
+            if(err == AMEDIA_OK)
+                err = AMediaCodec_start(m_MediaCodec);
         }
+        AMediaFormat_delete(format);
 
-        if (m_MediaCodec == nullptr) {
-            LOGCATE("HWCodecPlayer::InitDecoder create media codec fail.");
+        if (err != AMEDIA_OK) {
+            LOGCATE("HWCodecPlayer::InitDecoder create media codec fail. mime=%s, err=%d", codecFormat.mime.c_str(), err);
             result = -1;
             break;
         }
 
-        if(isAttach)
-            GetJavaVM()->DetachCurrentThread();
-
         m_SwrCtx = swr_alloc();
         uint64_t out_ch_layout = AV_CH_LAYOUT_STEREO;
         enum AVSampleFormat out_format = AV_SAMPLE_FMT_S16;
-        int out_sample_rate = m_AudioCodecCtx->sample_rate;
+        //音频 sink 固定为 44100Hz 双声道 16 位
+        int out_sample_rate = AUDIO_DST_SAMPLE_RATE;
         swr_alloc_set_opts(m_SwrCtx, out_ch_layout, out_format, out_sample_rate, m_AudioCodecCtx->channel_layout,
                            m_AudioCodecCtx->sample_fmt, m_AudioCodecCtx->sample_rate, 0, NULL);
         swr_init(m_SwrCtx);
 
         m_VideoTimeBase = m_AVFormatContext->streams[m_VideoStreamIdx]->time_base;
         m_AudioTimeBase = m_AVFormatContext->streams[m_AudioStreamIdx]->time_base;
+        m_BufferingPolicy.AddStream(m_VideoPacketQueue, m_VideoTimeBase);
+        m_BufferingPolicy.AddStream(m_AudioPacketQueue, m_AudioTimeBase);
 
         m_Duration = m_AVFormatContext->duration / AV_TIME_BASE * 1000;//us to ms
 
@@ -698,8 +981,20 @@ int HWCodecPlayer::InitDecoder() {
     } while (false);
 
     if(result == 0) {
+        LOGCATE("HWCodecPlayer::InitDecoder open stages: open input=%lldms, stream info=%lldms(%s), codec open=%lldms",
+                (long long) (openInputTime - m_OpenStartTime), (long long) (streamInfoTime - openInputTime), streamInfoMode,
+                (long long) (GetSysCurrentTime() - streamInfoTime));
         PostMessage(this, MSG_DECODER_READY, 0);
+        //解码线程启动前进入缓冲，缓冲到低水位后才开始输出
+        {
+            std::unique_lock<std::mutex> bufLock(m_BufferMutex);
+            StartBuffering();
+        }
+        PostMessage(this, MSG_BUFFERING_START, 0);
+        m_AudioRender = CreateAudioRender();
+        m_AudioRender->Init();
         m_VDecodeThread = new thread(VideoDecodeThreadProc, this);
+        m_VRenderThread = new thread(VideoRenderThreadProc, this);
         m_ADecodeThread = new thread(AudioDecodeThreadProc, this);
     } else {
         PostMessage(this, MSG_DECODER_INIT_ERROR, 0);
@@ -722,6 +1017,18 @@ int HWCodecPlayer::UnInitDecoder() {
         m_VDecodeThread = nullptr;
     }
 
+    if(m_VRenderThread) {
+        m_VRenderThread->join();
+        delete m_VRenderThread;
+        m_VRenderThread = nullptr;
+    }
+
+    if(m_AudioRender) {
+        m_AudioRender->UnInit();
+        delete m_AudioRender;
+        m_AudioRender = nullptr;
+    }
+
     if(m_AudioPacketQueue) {
         m_AudioPacketQueue->Flush();
     }
@@ -730,10 +1037,11 @@ int HWCodecPlayer::UnInitDecoder() {
         m_VideoPacketQueue->Flush();
     }
 
-    if(m_Bsfc) {
-        av_bitstream_filter_close(m_Bsfc);
-        m_Bsfc = nullptr;
+    if(m_BsfCtx) {
+        av_bsf_free(&m_BsfCtx);
     }
+    LOGCATE("HWCodecPlayer::UnInitDecoder video input packets=%lld, bytes copied=%lld, allocations=%lld",
+            (long long) m_VideoInputPackets, (long long) m_VideoInputBytes, (long long) m_VideoInputAllocs);
 
     if(m_MediaCodec) {
         AMediaCodec_stop(m_MediaCodec);
@@ -741,11 +1049,6 @@ int HWCodecPlayer::UnInitDecoder() {
         m_MediaCodec = nullptr;
     }
 
-    if(m_MediaExtractor) {
-        AMediaExtractor_delete(m_MediaExtractor);
-        m_MediaExtractor = nullptr;
-    }
-
     if(m_VideoCodecCtx != nullptr) {
         avcodec_close(m_VideoCodecCtx);
         avcodec_free_context(&m_VideoCodecCtx);
@@ -758,12 +1061,19 @@ int HWCodecPlayer::UnInitDecoder() {
         m_AudioCodecCtx = nullptr;
     }
 
+    m_KeyFrameIndex.reset();
+
     if(m_AVFormatContext != nullptr) {
         avformat_close_input(&m_AVFormatContext);
         avformat_free_context(m_AVFormatContext);
         m_AVFormatContext = nullptr;
     }
 
+    if(m_MediaSource != nullptr) {
+        delete m_MediaSource;
+        m_MediaSource = nullptr;
+    }
+
     if(m_SwrCtx) {
         swr_close(m_SwrCtx);
         swr_free(&m_SwrCtx);
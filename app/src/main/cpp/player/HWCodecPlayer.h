@@ -15,15 +15,37 @@
 #include <android/native_window.h>
 #include <android/native_window_jni.h>
 #include <media/NdkMediaCodec.h>
-#include <media/NdkMediaExtractor.h>
 #include <android/asset_manager.h>
 #include <android/asset_manager_jni.h>
 #include <SyncClock.h>
+#include <KeyFrameIndex.h>
+#include <MediaSource.h>
+#include <StreamInfoCache.h>
+#include <BufferingPolicy.h>
+#include <MediaCodecFormat.h>
+#include <OpenSLRender.h>
+#include <FileAudioRender.h>
+#include <WakeupCounter.h>
 
-// 视频缓冲区最大时长（秒）- 防止缓冲过多数据包
-#define BUFF_MAX_VIDEO_DURATION   0.5
+// assets 中的媒体，url 形如 asset://byteflow/vr.mp4
+#define HW_PLAYER_ASSET_PREFIX    "asset://"
 // 音视频同步最大休眠时间（毫秒）
 #define MAX_SYNC_SLEEP_TIME       200
+// 音频输出：OpenSL ES（默认）、丢弃数据、写 PCM 文件（后两者不依赖 Android 音频设备，用于测试）
+#define AUDIO_SINK_OPENSL         0
+#define AUDIO_SINK_NULL           1
+#define AUDIO_SINK_FILE           2
+#define HW_PLAYER_AUDIO_SINK      AUDIO_SINK_OPENSL
+// AUDIO_SINK_FILE 的输出路径
+#define HW_PLAYER_AUDIO_DUMP_PATH "/sdcard/learnffmpeg_audio.pcm"
+// 每送入多少个视频数据包打印一次拷贝和分配统计
+#define VIDEO_INPUT_STATS_INTERVAL 300
+// MediaCodec 输入缓冲区的最小大小，按一帧 YUV420 的大小申请，不小于这个值
+#define VIDEO_INPUT_MIN_BUFFER_SIZE (1024 * 1024)
+// 等待 MediaCodec 空闲输入缓冲区的超时时间（微秒），超时后检查停止和 seek
+#define VIDEO_INPUT_DEQUEUE_TIMEOUT  10000
+// 等待 MediaCodec 输出帧的超时时间（微秒），也是 seek 刷新解码器最多等待的时间
+#define VIDEO_OUTPUT_DEQUEUE_TIMEOUT 10000
 // 视频帧默认延迟时间（毫秒）
 #define VIDEO_FRAME_DEFAULT_DELAY 25
 // 视频帧最大延迟时间（毫秒）
@@ -50,9 +72,10 @@ enum PlayerState {
  * @brief 硬件解码播放器类
  *
  * 使用Android MediaCodec进行硬件解码的播放器实现
- * 采用三线程架构：
+ * 采用四线程架构：
  * - 解封装线程(DeMux)：从媒体文件读取音视频数据包
- * - 视频解码线程(VideoDecode)：使用MediaCodec硬解视频
+ * - 视频解码线程(VideoDecode)：把数据包送入MediaCodec，输入缓冲区不足时等待，不丢包
+ * - 视频输出线程(VideoRender)：取出MediaCodec解码后的帧，音视频同步后渲染，休眠不阻塞送包
  * - 音频解码线程(AudioDecode)：使用FFmpeg软解音频
  *
  * 特点：
@@ -122,7 +145,61 @@ private:
     static void PostMessage(void *context, int msgType, float msgCode);
     static void DeMuxThreadProc(HWCodecPlayer* player);        // 解封装线程
     static void AudioDecodeThreadProc(HWCodecPlayer* player);  // 音频解码线程
-    static void VideoDecodeThreadProc(HWCodecPlayer* player);  // 视频解码线程
+    static void VideoDecodeThreadProc(HWCodecPlayer* player);  // 视频解码线程（送包）
+    static void VideoRenderThreadProc(HWCodecPlayer* player);  // 视频输出线程
+
+    /**
+     * @brief I/O 中断回调（AVIOInterruptCB）
+     * 停止、读取时有新的 seek 请求、或超过 I/O 截止时间时中断阻塞的网络读写
+     */
+    static int InterruptCallback(void *ctx);
+
+    /**
+     * @brief 解码线程取数据包之前调用
+     * 队列读空且未到文件末尾时进入缓冲状态，缓冲中等待解封装线程缓冲到低水位
+     * @param wakeups 调用线程的唤醒计数
+     * @return 是否可以取数据包；暂停、停止或 seek 时返回 false，由调用方回到循环开头处理
+     */
+    bool WaitForBuffering(AVPacketQueue *queue, WakeupCounter *wakeups);
+
+    /**
+     * @brief 按 HW_PLAYER_AUDIO_SINK 创建音频输出
+     */
+    static AudioRender *CreateAudioRender();
+
+    /**
+     * @brief 唤醒等待 m_BufferCond 的线程：解码线程取走数据包后，或者播放状态、seek 位置变化后调用
+     */
+    void NotifyBufferWaiters();
+
+    /**
+     * @brief 把一个视频数据包写入 MediaCodec 的输入缓冲区，没有空闲输入缓冲区时等待输出线程释放
+     * @param pkt Annex B 格式的数据包
+     * @param allocated 数据包是否由比特流过滤器新分配，用于统计
+     * @param serial 数据包的序号，等待期间发生 seek 时放弃这个过期的数据包
+     * @param wakeups 调用线程的唤醒计数
+     * @return 0 表示已送入或因停止、seek 放弃；数据包大于输入缓冲区时返回 AVERROR(ENOBUFS)，
+     *         MediaCodec 不能把一帧拆到多个输入缓冲区，调用方需要停止送包并上报错误
+     */
+    int QueueVideoInput(AVPacket *pkt, bool allocated, int serial, WakeupCounter *wakeups);
+
+    /**
+     * @brief 暂停时阻塞等待，直到恢复播放、停止或 seek
+     * @return 暂停的时长（毫秒）
+     */
+    long WaitWhilePaused(WakeupCounter *wakeups);
+
+    /**
+     * @brief 解封装线程读到数据包或文件末尾后更新缓冲状态，缓冲足够时结束缓冲
+     */
+    void UpdateBufferingState();
+
+    /**
+     * @brief 开始缓冲（启动、seek 之后以及队列读空时）
+     * 调用时需持有 m_BufferMutex
+     * @return 是否由不缓冲变为缓冲，是则调用方在释放锁后发送 MSG_BUFFERING_START
+     */
+    bool StartBuffering();
 
 private:
     // 音视频数据包队列
@@ -131,32 +208,46 @@ private:
 
     // FFmpeg相关
     AVFormatContext*   m_AVFormatContext = nullptr;  // 封装格式上下文
+    MediaSource*           m_MediaSource = nullptr;  // 本地文件/asset 的 mmap 输入源
     char                 m_Url[MAX_PATH] = {0};      // 媒体文件路径
-    AVBitStreamFilterContext*     m_Bsfc = nullptr;  // H264比特流过滤器（mp4toannexb）
+    AVBSFContext*               m_BsfCtx = nullptr;  // H.264/HEVC 比特流过滤器（mp4toannexb），Annex B 码流不需要
     AVCodecContext*      m_AudioCodecCtx = nullptr;  // 音频解码器上下文
     AVCodecContext*      m_VideoCodecCtx = nullptr;  // 视频解码器上下文（用于解封装，不用于解码）
     AVRational           m_VideoTimeBase = {0};      // 视频时间基
     AVRational           m_AudioTimeBase = {0};      // 音频时间基
     SwrContext*                 m_SwrCtx = nullptr;  // 音频重采样上下文
+    AudioRender*           m_AudioRender = nullptr;  // 音频输出，音频时钟取它的实际播放位置
     long                      m_Duration = 0;        // 媒体总时长（毫秒）
+    shared_ptr<KeyFrameIndex> m_KeyFrameIndex;       // 后台建立的关键帧索引，就绪后按字节位置 seek
 
     // Android MediaCodec相关
     AMediaCodec*            m_MediaCodec = nullptr;     // MediaCodec硬件解码器
-    AMediaExtractor*    m_MediaExtractor = nullptr;     // MediaExtractor（用于获取视频格式）
+    mutex                      m_CodecMutex;            // 保护 MediaCodec 的 flush 与输出缓冲区的状态检查、释放
+    int                        m_CodecFlushCount = 0;   // flush 次数，flush 之前取出的输出缓冲区已经失效
+    volatile int               m_VideoDecoderSerial = 0;      // MediaCodec 最近一次 flush 对应的队列序号
+    volatile long              m_VideoSeekStartTime = -1;     // 等待 seek 之后第一帧的 seek 请求时间（毫秒）
+    int64_t          m_VideoInputPackets = 0;           // 送入 MediaCodec 的数据包数
+    int64_t          m_VideoInputBytes = 0;             // 拷贝到输入缓冲区的字节数
+    int64_t          m_VideoInputAllocs = 0;            // 比特流过滤器新分配输出的次数
     ANativeWindow*       m_ANativeWindow = nullptr;     // Native窗口（用于视频渲染）
 
     // 线程
     thread*              m_DeMuxThread   = nullptr;  // 解封装线程
     thread*              m_ADecodeThread = nullptr;  // 音频解码线程
     thread*              m_VDecodeThread = nullptr;  // 视频解码线程
+    thread*              m_VRenderThread = nullptr;  // 视频输出线程
     jobject              m_AssetMgr      = nullptr;  // Asset管理器（用于读取assets资源）
 
     // 播放状态
     PlayerState            m_PlayerState = PLAYER_STATE_UNKNOWN;  // 播放器状态
     volatile float        m_SeekPosition = -1;       // Seek目标位置（-1表示无Seek请求）
     volatile bool          m_SeekSuccess = false;    // Seek是否成功
+    volatile long          m_SeekRequestTime = -1;   // Seek请求的时间（毫秒），用于统计 seek 到恢复出帧的耗时
     int                 m_VideoStreamIdx = -1;       // 视频流索引
     int                 m_AudioStreamIdx = -1;       // 音频流索引
+    long                m_OpenStartTime = -1;        // 开始打开媒体的时间（毫秒），用于统计打开到首帧的耗时
+    volatile int64_t    m_IODeadline = 0;            // 当前 I/O 操作的截止时间（微秒），0 表示不限
+    volatile bool       m_Reading = false;           // 是否正在读取数据包
 
     // 音视频同步相关
     double              m_VideoStartBase = -1.0;     // 视频起始时间基准
@@ -166,10 +257,17 @@ private:
 
     // 线程同步：锁和条件变量
     mutex               m_Mutex;          // 播放状态互斥锁
-    mutex               m_VideoBufMutex;  // 视频缓冲区互斥锁
-    mutex               m_AudioBufMutex;  // 音频缓冲区互斥锁
     condition_variable  m_Cond;           // 条件变量（用于暂停/恢复）
 
+    // 自适应缓冲
+    BufferingPolicy     m_BufferingPolicy;       // 按读取卡顿调整水位
+    mutex               m_BufferMutex;           // 缓冲状态互斥锁
+    condition_variable  m_BufferCond;            // 队列消费、缓冲结束、状态变化时通知
+    bool                m_Buffering = false;     // 是否正在缓冲
+    bool                m_ReadEOF = false;       // 是否已经读到文件末尾
+    int64_t             m_BufferingStartTime = 0;  // 本次缓冲开始的时间（微秒）
+    int                 m_RebufferCount = 0;     // 播放过程中的卡顿（队列读空）次数
+
     // 音视频同步时钟
     SyncClock           m_VideoClock;     // 视频时钟
     SyncClock           m_AudioClock;     // 音频时钟（作为主时钟）
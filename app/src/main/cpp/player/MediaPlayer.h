@@ -13,6 +13,7 @@
 #include <decoder/VideoDecoder.h>
 #include <decoder/AudioDecoder.h>
 #include <render/audio/AudioRender.h>
+#include "EventDispatcher.h"
 
 // Java层播放器事件回调API名称
 #define JAVA_PLAYER_EVENT_CALLBACK_API_NAME "playerEventCallback"
@@ -72,6 +73,29 @@ public:
      */
     virtual void SeekToPosition(float position) = 0;
 
+    /**
+     * @brief 拖动进度条过程中的快速预览，只显示目标附近的关键帧，松手后再调用 SeekToPosition 精确跳转
+     * 默认退化为普通跳转
+     * @param position 目标位置
+     */
+    virtual void ScrubToPosition(float position) {
+        SeekToPosition(position);
+    }
+
+    /**
+     * @brief 设置是否精确 seek，关闭后 SeekToPosition 直接显示目标位置之前的关键帧
+     * 默认空实现
+     * @param accurate 是否精确 seek
+     */
+    virtual void SetAccurateSeek(bool accurate) {}
+
+    /**
+     * @brief 设置直播的目标延迟，只在直播模式下生效
+     * 默认空实现
+     * @param latencyMs 目标延迟（毫秒）
+     */
+    virtual void SetLatencyTarget(int latencyMs) {}
+
     /**
      * @brief 获取媒体参数（纯虚函数）
      * @param paramType 参数类型
@@ -107,6 +131,28 @@ public:
 
     JavaVM *m_JavaVM = nullptr;                    // Java虚拟机指针
     jobject m_JavaObj = nullptr;                   // Java对象引用
+    EventDispatcher *m_EventDispatcher = nullptr;  // 事件分发线程，解码线程投递事件后立即返回
+
+protected:
+    /**
+     * @brief 启动事件分发线程，在 m_JavaVM、m_JavaObj 初始化之后调用
+     * 渲染请求只合并不限速，播放进度每个 UI 帧最多发送一次
+     */
+    void StartEventDispatcher() {
+        m_EventDispatcher = new EventDispatcher(m_JavaVM, m_JavaObj);
+        m_EventDispatcher->SetCoalesce(MSG_REQUEST_RENDER, 0);
+        m_EventDispatcher->SetCoalesce(MSG_DECODING_TIME, EVENT_COALESCE_INTERVAL);
+    }
+
+    /**
+     * @brief 停止事件分发线程，在所有解码线程结束之后、释放 m_JavaObj 之前调用
+     */
+    void StopEventDispatcher() {
+        if(m_EventDispatcher) {
+            delete m_EventDispatcher;
+            m_EventDispatcher = nullptr;
+        }
+    }
 };
 
 #endif //LEARNFFMPEG_MEDIAPLAYER_H
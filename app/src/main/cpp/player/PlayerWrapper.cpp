@@ -89,6 +89,39 @@ void PlayerWrapper::SeekToPosition(float position) {
 
 }
 
+/**
+ * @brief 拖动预览到指定位置（只显示关键帧）
+ * @param position 目标位置
+ */
+void PlayerWrapper::ScrubToPosition(float position) {
+    if(m_MediaPlayer) {
+        m_MediaPlayer->ScrubToPosition(position);
+    }
+
+}
+
+/**
+ * @brief 设置是否精确 seek
+ * @param accurate 是否精确 seek
+ */
+void PlayerWrapper::SetAccurateSeek(bool accurate) {
+    if(m_MediaPlayer) {
+        m_MediaPlayer->SetAccurateSeek(accurate);
+    }
+
+}
+
+/**
+ * @brief 设置直播的目标延迟
+ * @param latencyMs 目标延迟（毫秒）
+ */
+void PlayerWrapper::SetLatencyTarget(int latencyMs) {
+    if(m_MediaPlayer) {
+        m_MediaPlayer->SetLatencyTarget(latencyMs);
+    }
+
+}
+
 /**
  * @brief 获取媒体参数
  * @param paramType 参数类型
@@ -28,6 +28,9 @@ public:
     void Pause();
     void Stop();
     void SeekToPosition(float position);
+    void ScrubToPosition(float position);
+    void SetAccurateSeek(bool accurate);
+    void SetLatencyTarget(int latencyMs);
     long GetMediaParams(int paramType);
     void SetMediaParams(int paramType, jobject obj);
 
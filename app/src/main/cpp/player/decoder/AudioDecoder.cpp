@@ -77,8 +77,9 @@ void AudioDecoder::OnFrameAvailable(AVFrame *frame) {
         // 参数：输出缓冲区、输出缓冲区大小、输入数据、输入采样数
         int result = swr_convert(m_SwrContext, &m_AudioOutBuffer, m_DstFrameDataSze / 2, (const uint8_t **) frame->data, frame->nb_samples);
         if (result > 0 ) {
-            // 将重采样后的音频数据送给渲染器播放
-            m_AudioRender->RenderAudioFrame(m_AudioOutBuffer, m_DstFrameDataSze);
+            // 将重采样后的音频数据送给渲染器播放，精确 seek 时首帧会被裁剪，按实际输出的采样数计算大小
+            int dataSize = av_samples_get_buffer_size(NULL, AUDIO_DST_CHANNEL_COUNTS, result, DST_SAMPLT_FORMAT, 1);
+            m_AudioRender->RenderAudioFrame(m_AudioOutBuffer, dataSize);
         }
     }
 }
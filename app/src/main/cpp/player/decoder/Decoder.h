@@ -65,6 +65,15 @@ public:
      */
     virtual void SeekToPosition(float position) = 0;
 
+    /**
+     * @brief 拖动进度条时的快速预览，只解码关键帧
+     * 默认退化为普通跳转
+     * @param position 目标位置（秒）
+     */
+    virtual void ScrubToPosition(float position) {
+        SeekToPosition(position);
+    }
+
     /**
      * @brief 获取当前播放位置
      * @return 当前位置（秒）
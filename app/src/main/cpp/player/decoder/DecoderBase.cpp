@@ -36,11 +36,33 @@ void DecoderBase::Stop() {
 void DecoderBase::SeekToPosition(float position) {
     LOGCATE("DecoderBase::SeekToPosition position=%f", position);
     std::unique_lock<std::mutex> lock(m_Mutex);
+    if(m_SeekPending) m_SeekCoalescedCount++;
+    if(m_SeekRequestTime == -1) m_SeekRequestTime = GetSysCurrentTime();
     m_SeekPosition = position;
+    m_SeekPending = true;
+    m_Scrubbing = false;
     m_DecoderState = STATE_DECODING;
     m_Cond.notify_all();
 }
 
+void DecoderBase::ScrubToPosition(float position) {
+    LOGCATE("DecoderBase::ScrubToPosition position=%f", position);
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    //解码线程还没处理上一次请求，直接覆盖目标位置
+    if(m_SeekPending) m_SeekCoalescedCount++;
+    if(m_SeekRequestTime == -1) m_SeekRequestTime = GetSysCurrentTime();
+    m_SeekPosition = position;
+    m_SeekPending = true;
+    m_Scrubbing = true;
+    m_DecoderState = STATE_DECODING;
+    m_Cond.notify_all();
+}
+
+void DecoderBase::RequestLowres(int lowres) {
+    LOGCATE("DecoderBase::RequestLowres lowres=%d", lowres);
+    m_RequestLowres = lowres;
+}
+
 float DecoderBase::GetCurrentPosition() {
     //std::unique_lock<std::mutex> lock(m_Mutex);//读写保护
     //单位 ms
@@ -56,33 +78,64 @@ int DecoderBase::Init(const char *url, AVMediaType mediaType) {
 
 void DecoderBase::UnInit() {
     LOGCATE("DecoderBase::UnInit m_MediaType=%d", m_MediaType);
+    long startTime = GetSysCurrentTime();
     if(m_Thread) {
         Stop();
         m_Thread->join();
         delete m_Thread;
         m_Thread = nullptr;
     }
-    LOGCATE("DecoderBase::UnInit end, m_MediaType=%d", m_MediaType);
+    //后台完整探测同样要在释放时结束，不能比播放器活得更久
+    StreamInfoCache::UnInit(m_Url);
+    LOGCATE("DecoderBase::UnInit end, m_MediaType=%d, teardown cost=%lldms", m_MediaType, (long long) (GetSysCurrentTime() - startTime));
 }
 
 int DecoderBase::InitFFDecoder() {
     int result = -1;
+    m_OpenStartTime = GetSysCurrentTime();
     do {
-        //1.创建封装格式上下文
+        //1.创建封装格式上下文，设置 I/O 中断回调，停止时不必等网络超时
         m_AVFormatContext = avformat_alloc_context();
-
-        //2.打开文件
-        if(avformat_open_input(&m_AVFormatContext, m_Url, NULL, NULL) != 0)
+        m_AVFormatContext->interrupt_callback.callback = InterruptCallback;
+        m_AVFormatContext->interrupt_callback.opaque = this;
+
+        //2.打开文件，本地文件通过 mmap 读取，http 点播经磁盘缓存读取
+        m_LiveMode = IsLiveUrl(m_Url);
+        AVDictionary *formatOptions = nullptr;
+        av_dict_set(&formatOptions, "buffer_size", "1024000", 0);
+        av_dict_set(&formatOptions, "stimeout", "20000000", 0);
+        av_dict_set(&formatOptions, "rtsp_transport", "tcp", 0);
+        if(m_LiveMode) {
+            //直播：demuxer 不缓冲数据包，乱序重排最多等待 100ms
+            av_dict_set(&formatOptions, "fflags", "nobuffer", 0);
+            av_dict_set(&formatOptions, "max_delay", "100000", 0);
+        } else {
+            av_dict_set(&formatOptions, "max_delay", "30000000", 0);
+        }
+        m_IODeadline = av_gettime_relative() + IO_OPEN_TIMEOUT;
+        int openResult = MediaSource::Open(&m_AVFormatContext, m_Url, &formatOptions, &m_MediaSource);
+        av_dict_free(&formatOptions);
+        if(openResult != 0)
         {
             LOGCATE("DecoderBase::InitFFDecoder avformat_open_input fail.");
+            m_IODeadline = 0;
             break;
         }
 
-        //3.获取音视频流信息
-        if(avformat_find_stream_info(m_AVFormatContext, NULL) < 0) {
+        long openInputTime = GetSysCurrentTime();
+
+        //3.获取音视频流信息，优先使用上次打开时缓存的流信息，否则以最小的探测参数快速探测
+        const char *streamInfoMode = "full";
+        int findResult = StreamInfoCache::FindStreamInfo(m_AVFormatContext, m_Url, &streamInfoMode);
+        m_IODeadline = 0;
+        if(findResult < 0) {
             LOGCATE("DecoderBase::InitFFDecoder avformat_find_stream_info fail.");
             break;
         }
+        long streamInfoTime = GetSysCurrentTime();
+        //没有时长的流（如 http-flv、ts 直播）同样按直播处理
+        if(m_AVFormatContext->duration == AV_NOPTS_VALUE)
+            m_LiveMode = true;
 
         //4.获取音视频流索引
         for(int i=0; i < m_AVFormatContext->nb_streams; i++) {
@@ -113,19 +166,24 @@ int DecoderBase::InitFFDecoder() {
             break;
         }
 
-        AVDictionary *pAVDictionary = nullptr;
-        av_dict_set(&pAVDictionary, "buffer_size", "1024000", 0);
-        av_dict_set(&pAVDictionary, "stimeout", "20000000", 0);
-        av_dict_set(&pAVDictionary, "max_delay", "30000000", 0);
-        av_dict_set(&pAVDictionary, "rtsp_transport", "tcp", 0);
+        if(m_MediaType == AVMEDIA_TYPE_VIDEO) {
+            m_FrameBufferPool = new FrameBufferPool();
+        }
+        ConfigCodecContext(m_AVCodecContext);
 
         //8.打开解码器
-        result = avcodec_open2(m_AVCodecContext, m_AVCodec, &pAVDictionary);
+        result = avcodec_open2(m_AVCodecContext, m_AVCodec, nullptr);
         if(result < 0) {
             LOGCATE("DecoderBase::InitFFDecoder avcodec_open2 fail. result=%d", result);
             break;
         }
         result = 0;
+        LOGCATE("DecoderBase::InitFFDecoder open stages: open input=%lldms, stream info=%lldms(%s), codec open=%lldms, live=%d, m_MediaType=%d",
+                (long long) (openInputTime - m_OpenStartTime), (long long) (streamInfoTime - openInputTime), streamInfoMode,
+                (long long) (GetSysCurrentTime() - streamInfoTime), m_LiveMode, m_MediaType);
+
+        //后台建立关键帧索引（本地文件），同一文件的音视频解码器共享
+        m_KeyFrameIndex = KeyFrameIndex::Acquire(m_Url);
 
         m_Duration = m_AVFormatContext->duration / AV_TIME_BASE * 1000;//us to ms
         //创建 AVPacket 存放编码数据
@@ -159,12 +217,26 @@ void DecoderBase::UnInitDecoder() {
         m_AVCodec = nullptr;
     }
 
+    m_KeyFrameIndex.reset();
+
+    //缓冲池必须在解码器上下文和所有帧释放之后再销毁
+    if(m_FrameBufferPool != nullptr) {
+        delete m_FrameBufferPool;
+        m_FrameBufferPool = nullptr;
+    }
+
     if(m_AVFormatContext != nullptr) {
         avformat_close_input(&m_AVFormatContext);
         avformat_free_context(m_AVFormatContext);
         m_AVFormatContext = nullptr;
     }
 
+    //自定义 IO 不会随封装格式上下文释放
+    if(m_MediaSource != nullptr) {
+        delete m_MediaSource;
+        m_MediaSource = nullptr;
+    }
+
 }
 
 void DecoderBase::StartDecodingThread() {
@@ -179,11 +251,16 @@ void DecoderBase::DecodingLoop() {
         lock.unlock();
     }
 
+    WakeupCounter wakeups(m_MediaType == AVMEDIA_TYPE_VIDEO ? "DecoderBase::DecodingLoop video" : "DecoderBase::DecodingLoop audio");
     for(;;) {
-        while (m_DecoderState == STATE_PAUSE) {
+        if (m_DecoderState == STATE_PAUSE) {
             std::unique_lock<std::mutex> lock(m_Mutex);
             LOGCATE("DecoderBase::DecodingLoop waiting, m_MediaType=%d", m_MediaType);
-            m_Cond.wait_for(lock, std::chrono::milliseconds(10));
+            //Start、Stop、seek 修改状态后通知，暂停期间不再轮询
+            while (m_DecoderState == STATE_PAUSE) {
+                m_Cond.wait(lock);
+                wakeups.OnWakeup();
+            }
             m_StartTimeStamp = GetSysCurrentTime() - m_CurTimeStamp;
         }
 
@@ -191,15 +268,31 @@ void DecoderBase::DecodingLoop() {
             break;
         }
 
+        //拖动预览：目标关键帧已经显示，等待下一次拖动或者松手后的精确 seek
+        if(m_Scrubbing && !m_SeekPending) {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_Cond.wait(lock, [this] {
+                return m_SeekPending || !m_Scrubbing || m_DecoderState == STATE_STOP;
+            });
+            wakeups.OnWakeup();
+            continue;
+        }
+
         if(m_StartTimeStamp == -1)
             m_StartTimeStamp = GetSysCurrentTime();
 
-        if(DecodeOnePacket() != 0) {
-            //解码结束，暂停解码器
+        int result = DecodeOnePacket();
+        if(result == AVERROR_EXIT) {
+            //I/O 被停止、seek 或超时中断，下一轮循环处理停止和 seek，超时则重试读取
+            LOGCATE("DecoderBase::DecodingLoop I/O interrupted, m_MediaType=%d", m_MediaType);
+        } else if(result != 0) {
+            //解码结束，暂停解码器（已经停止则保持停止状态）
             std::unique_lock<std::mutex> lock(m_Mutex);
-            m_DecoderState = STATE_PAUSE;
+            if(m_DecoderState != STATE_STOP)
+                m_DecoderState = STATE_PAUSE;
         }
     }
+    wakeups.Report();
     LOGCATE("DecoderBase::DecodingLoop end");
 }
 
@@ -216,12 +309,21 @@ void DecoderBase::UpdateTimeStamp() {
 
     m_CurTimeStamp = (int64_t)((m_CurTimeStamp * av_q2d(m_AVFormatContext->streams[m_StreamIndex]->time_base)) * 1000);
 
-    if(m_SeekPosition > 0 && m_SeekSuccess)
+    //记录已显示到的位置，重新打开解码器后从这里继续
+    int64_t pts = m_Frame->best_effort_timestamp != AV_NOPTS_VALUE ? m_Frame->best_effort_timestamp : m_Frame->pts;
+    m_RenderedPtsEnd = pts == AV_NOPTS_VALUE ? AV_NOPTS_VALUE : pts + FFMAX(m_Frame->pkt_duration, 1);
+
+    if(m_SeekSuccess)
     {
         m_StartTimeStamp = GetSysCurrentTime() - m_CurTimeStamp;
-        m_SeekPosition = 0;
         m_SeekSuccess = false;
     }
+    else if(m_LiveMode && !m_LiveAnchored && m_ArrivalBase != -1)
+    {
+        //直播的起始时间戳不为 0，以到达时间基准加目标延迟作为播放时钟的起点
+        m_StartTimeStamp = m_ArrivalBase + m_LatencyTarget;
+        m_LiveAnchored = true;
+    }
 }
 
 long DecoderBase::AVSync() {
@@ -248,28 +350,216 @@ long DecoderBase::AVSync() {
     return delay;
 }
 
+int DecoderBase::ReopenDecoder(int lowres) {
+    LOGCATE("DecoderBase::ReopenDecoder lowres %d -> %d", m_Lowres, lowres);
+    //打印切换前的解码开销，用于对比不同 lowres 下的 CPU 和内存占用
+    if(m_DecodeFrameCount > 0) {
+        LOGCATE("DecoderBase::ReopenDecoder lowres=%d, frames=%lld, avg decode time=%.2fms",
+                m_Lowres, (long long) m_DecodeFrameCount, m_DecodeTimeUs / 1000.0 / m_DecodeFrameCount);
+    }
+    if(m_FrameBufferPool != nullptr) {
+        m_FrameBufferPool->DumpStats("DecoderBase::ReopenDecoder");
+    }
+
+    AVCodecParameters *codecParameters = m_AVFormatContext->streams[m_StreamIndex]->codecpar;
+    AVCodecContext *codecCtx = avcodec_alloc_context3(m_AVCodec);
+    int result = -1;
+    do {
+        if(codecCtx == nullptr) break;
+        if(avcodec_parameters_to_context(codecCtx, codecParameters) != 0) {
+            LOGCATE("DecoderBase::ReopenDecoder avcodec_parameters_to_context fail.");
+            break;
+        }
+        codecCtx->lowres = lowres;
+        codecCtx->skip_frame = m_AVCodecContext->skip_frame;
+        codecCtx->skip_loop_filter = m_AVCodecContext->skip_loop_filter;
+        ConfigCodecContext(codecCtx);
+        result = avcodec_open2(codecCtx, m_AVCodec, nullptr);
+        if(result < 0) {
+            LOGCATE("DecoderBase::ReopenDecoder avcodec_open2 fail. result=%d", result);
+            break;
+        }
+        result = 0;
+    } while (false);
+
+    if(result != 0) {
+        avcodec_free_context(&codecCtx);
+        //保持原解码器，不再重试
+        m_RequestLowres = m_Lowres;
+        return result;
+    }
+
+    //新解码器需要从关键帧开始，回退到已显示位置之前的关键帧；
+    //精确 seek 还没到达目标时继续以原目标为准，否则以最后显示帧的结束时间为目标，丢弃已经显示过的帧
+    AVStream *stream = m_AVFormatContext->streams[m_StreamIndex];
+    int64_t resumePts = m_SeekTargetPts != AV_NOPTS_VALUE ? m_SeekTargetPts : m_RenderedPtsEnd;
+    int64_t seekTarget = resumePts != AV_NOPTS_VALUE ? resumePts : av_rescale_q(m_CurTimeStamp, AVRational{1, 1000}, stream->time_base);
+    if(av_seek_frame(m_AVFormatContext, m_StreamIndex, seekTarget, AVSEEK_FLAG_BACKWARD) < 0) {
+        LOGCATE("DecoderBase::ReopenDecoder av_seek_frame fail.");
+    } else if(resumePts != AV_NOPTS_VALUE && !m_Scrubbing) {
+        //与精确 seek 相同：目标之前的帧解码后丢弃，到达目标后重新对齐播放时钟
+        m_SeekTargetPts = resumePts;
+        m_SeekKeyFrameCost = -1;
+        m_SeekDiscardCount = 0;
+        m_SeekSuccess = true;
+    }
+
+    //帧缓冲池仍被旧帧引用也没关系，它的生命周期跟随 DecoderBase
+    avcodec_free_context(&m_AVCodecContext);
+    m_AVCodecContext = codecCtx;
+    m_Lowres = lowres;
+    m_DecodeTimeUs = 0;
+    m_DecodeFrameCount = 0;
+    ClearCache();
+    LOGCATE("DecoderBase::ReopenDecoder done, output [w,h]=[%d, %d]", m_AVCodecContext->width, m_AVCodecContext->height);
+    return 0;
+}
+
+void DecoderBase::ConfigCodecContext(AVCodecContext *codecCtx) {
+    //视频解码输出使用帧缓冲池，行宽按 GL 上传要求对齐
+    if(m_FrameBufferPool != nullptr) {
+        m_FrameBufferPool->Attach(codecCtx);
+    }
+    //直播：解码器不为 B 帧重排等额外缓冲
+    if(m_LiveMode)
+        codecCtx->flags |= AV_CODEC_FLAG_LOW_DELAY;
+}
+
+void DecoderBase::DoSeek() {
+    float seekPosition = 0;
+    bool scrubbing = false;
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        seekPosition = m_SeekPosition;
+        scrubbing = m_Scrubbing;
+        m_SeekPending = false;
+    }
+
+    //拖动预览只解码关键帧
+    m_AVCodecContext->skip_frame = scrubbing ? AVDISCARD_NONKEY : AVDISCARD_DEFAULT;
+
+    //seek to frame
+    int64_t seek_target = static_cast<int64_t>(seekPosition * 1000000);//微秒
+    int64_t seek_min = INT64_MIN;
+    int64_t seek_max = INT64_MAX;
+    m_SeekTargetPts = AV_NOPTS_VALUE;
+    m_SeekKeyFrameCost = -1;
+    m_SeekDiscardCount = 0;
+    if(m_AccurateSeek && !scrubbing) {
+        //精确 seek 必须落在目标之前的关键帧上，再向后解码到目标时间
+        seek_max = seek_target;
+        m_SeekTargetPts = av_rescale_q(seek_target, AV_TIME_BASE_Q, m_AVFormatContext->streams[m_StreamIndex]->time_base);
+    }
+    //优先使用关键帧索引按字节位置 seek，索引点总是在目标之前，精确 seek 同样适用
+    int64_t seekStart = av_gettime_relative();
+    int seek_ret = -1;
+    bool byIndex = false;
+    m_IODeadline = av_gettime_relative() + IO_OPEN_TIMEOUT;
+    if (m_KeyFrameIndex && m_KeyFrameIndex->IsReady()) {
+        seek_ret = m_KeyFrameIndex->Seek(m_AVFormatContext, m_StreamIndex, seek_target);
+        byIndex = seek_ret >= 0;
+    }
+    if (seek_ret < 0) {
+        seek_ret = avformat_seek_file(m_AVFormatContext, -1, seek_min, seek_target, seek_max, 0);
+    }
+    m_IODeadline = 0;
+    LOGCATE("DecoderBase::DoSeek seek cost=%lldus, byIndex=%d, m_MediaType=%d",
+            (long long) (av_gettime_relative() - seekStart), byIndex, m_MediaType);
+    if (seek_ret < 0) {
+        m_SeekSuccess = false;
+        m_SeekTargetPts = AV_NOPTS_VALUE;
+        LOGCATE("BaseDecoder::DecodeOneFrame error while seeking m_MediaType=%d", m_MediaType);
+    } else {
+        if (-1 != m_StreamIndex) {
+            avcodec_flush_buffers(m_AVCodecContext);
+        }
+        ClearCache();
+        m_SeekSuccess = true;
+        m_RenderedPtsEnd = AV_NOPTS_VALUE;
+        LOGCATE("BaseDecoder::DecodeOneFrame seekFrame pos=%f, scrubbing=%d, m_MediaType=%d", seekPosition, scrubbing, m_MediaType);
+    }
+}
+
+bool DecoderBase::DiscardBeforeSeekTarget(AVFrame *frame) {
+    if(m_SeekTargetPts == AV_NOPTS_VALUE) return false;
+
+    if(m_SeekKeyFrameCost == -1 && m_SeekRequestTime != -1) {
+        m_SeekKeyFrameCost = GetSysCurrentTime() - m_SeekRequestTime;
+    }
+
+    int64_t pts = frame->best_effort_timestamp;
+    if(pts == AV_NOPTS_VALUE) pts = frame->pts;
+    if(pts == AV_NOPTS_VALUE) {
+        m_SeekTargetPts = AV_NOPTS_VALUE;
+        return false;
+    }
+
+    AVRational timeBase = m_AVFormatContext->streams[m_StreamIndex]->time_base;
+    int64_t duration = frame->pkt_duration;
+    if(m_MediaType == AVMEDIA_TYPE_AUDIO && frame->sample_rate > 0) {
+        duration = av_rescale_q(frame->nb_samples, AVRational{1, frame->sample_rate}, timeBase);
+    }
+
+    //帧的显示区间完全在目标之前，丢弃
+    if(pts + duration <= m_SeekTargetPts || (duration <= 0 && pts < m_SeekTargetPts)) {
+        m_SeekDiscardCount++;
+        return true;
+    }
+
+    //音频帧跨越目标时间，裁掉目标之前的采样
+    if(m_MediaType == AVMEDIA_TYPE_AUDIO && pts < m_SeekTargetPts && frame->sample_rate > 0) {
+        int skipSamples = static_cast<int>(av_rescale_q(m_SeekTargetPts - pts, timeBase, AVRational{1, frame->sample_rate}));
+        skipSamples = FFMIN(skipSamples, frame->nb_samples);
+        int channels = frame->channels;
+        int bytesPerSample = av_get_bytes_per_sample(static_cast<AVSampleFormat>(frame->format));
+        if(av_sample_fmt_is_planar(static_cast<AVSampleFormat>(frame->format))) {
+            for (int i = 0; i < channels; ++i) {
+                frame->extended_data[i] += skipSamples * bytesPerSample;
+                if(frame->extended_data != frame->data && i < AV_NUM_DATA_POINTERS)
+                    frame->data[i] += skipSamples * bytesPerSample;
+            }
+        } else {
+            frame->extended_data[0] += skipSamples * bytesPerSample * channels;
+            if(frame->extended_data != frame->data)
+                frame->data[0] += skipSamples * bytesPerSample * channels;
+        }
+        frame->nb_samples -= skipSamples;
+        LOGCATE("DecoderBase::DiscardBeforeSeekTarget trim %d audio samples", skipSamples);
+    }
+
+    LOGCATE("DecoderBase::DiscardBeforeSeekTarget reach target, keyframe cost=%ldms, total cost=%lldms, discard frames=%d, m_MediaType=%d",
+            m_SeekKeyFrameCost, m_SeekRequestTime != -1 ? (long long) (GetSysCurrentTime() - m_SeekRequestTime) : -1LL, m_SeekDiscardCount, m_MediaType);
+    m_SeekTargetPts = AV_NOPTS_VALUE;
+    m_AVCodecContext->skip_frame = AVDISCARD_DEFAULT;
+    return false;
+}
+
 int DecoderBase::DecodeOnePacket() {
     LOGCATE("DecoderBase::DecodeOnePacket m_MediaType=%d", m_MediaType);
-    if(m_SeekPosition > 0) {
-        //seek to frame
-        int64_t seek_target = static_cast<int64_t>(m_SeekPosition * 1000000);//微秒
-        int64_t seek_min = INT64_MIN;
-        int64_t seek_max = INT64_MAX;
-        int seek_ret = avformat_seek_file(m_AVFormatContext, -1, seek_min, seek_target, seek_max, 0);
-        if (seek_ret < 0) {
-            m_SeekSuccess = false;
-            LOGCATE("BaseDecoder::DecodeOneFrame error while seeking m_MediaType=%d", m_MediaType);
-        } else {
-            if (-1 != m_StreamIndex) {
-                avcodec_flush_buffers(m_AVCodecContext);
-            }
-            ClearCache();
-            m_SeekSuccess = true;
-            LOGCATE("BaseDecoder::DecodeOneFrame seekFrame pos=%f, m_MediaType=%d", m_SeekPosition, m_MediaType);
+    if(m_RequestLowres != m_Lowres) {
+        ReopenDecoder(m_RequestLowres);
+    }
+    if(m_SeekPending) {
+        DoSeek();
+        //拖动预览时音频只跳转不输出，等待松手后的精确 seek
+        if(m_Scrubbing && m_MediaType == AVMEDIA_TYPE_AUDIO) {
+            m_SeekRequestTime = -1;
+            return 0;
         }
     }
-    int result = av_read_frame(m_AVFormatContext, m_Packet);
+    int result = ReadPacket();
     while(result == 0) {
+        //拖动预览或精确 seek 的过程中来了新的目标位置，放弃当前的解码，优先处理最新请求
+        if(m_SeekPending && (m_Scrubbing || m_SeekTargetPts != AV_NOPTS_VALUE)) {
+            result = 0;
+            goto __EXIT;
+        }
+        //拖动预览时非关键帧不送解码器
+        if(m_Scrubbing && !(m_Packet->flags & AV_PKT_FLAG_KEY)) {
+            av_packet_unref(m_Packet);
+            result = ReadPacket();
+            continue;
+        }
         if(m_Packet->stream_index == m_StreamIndex) {
 //            UpdateTimeStamp(m_Packet);
 //            if(AVSync() > DELAY_THRESHOLD && m_CurTimeStamp > DELAY_THRESHOLD)
@@ -278,6 +568,12 @@ int DecoderBase::DecodeOnePacket() {
 //                goto __EXIT;
 //            }
 
+            //精确 seek 过程中，目标之前的非参考帧不需要解码
+            if(m_SeekTargetPts != AV_NOPTS_VALUE && m_MediaType == AVMEDIA_TYPE_VIDEO) {
+                bool beforeTarget = m_Packet->pts != AV_NOPTS_VALUE && m_Packet->pts + m_Packet->duration <= m_SeekTargetPts;
+                m_AVCodecContext->skip_frame = beforeTarget ? AVDISCARD_NONREF : AVDISCARD_DEFAULT;
+            }
+            int64_t decodeStart = av_gettime_relative();
             if(avcodec_send_packet(m_AVCodecContext, m_Packet) == AVERROR_EOF) {
                 //解码结束
                 result = -1;
@@ -287,15 +583,40 @@ int DecoderBase::DecodeOnePacket() {
             //一个 packet 包含多少 frame?
             int frameCount = 0;
             while (avcodec_receive_frame(m_AVCodecContext, m_Frame) == 0) {
+                m_DecodeTimeUs += av_gettime_relative() - decodeStart;
+                m_DecodeFrameCount++;
+                //精确 seek：目标之前的帧直接丢弃，不做格式转换和渲染
+                if(DiscardBeforeSeekTarget(m_Frame)) {
+                    decodeStart = av_gettime_relative();
+                    continue;
+                }
                 //更新时间戳
                 UpdateTimeStamp();
+                //直播：延迟超过目标时加速或丢帧追赶
+                if(LiveCatchUp()) {
+                    decodeStart = av_gettime_relative();
+                    continue;
+                }
                 //同步
                 AVSync();
                 //渲染
                 LOGCATE("DecoderBase::DecodeOnePacket 000 m_MediaType=%d", m_MediaType);
                 OnFrameAvailable(m_Frame);
                 LOGCATE("DecoderBase::DecodeOnePacket 0001 m_MediaType=%d", m_MediaType);
+                if(m_OpenStartTime != -1) {
+                    LOGCATE("DecoderBase::DecodeOnePacket open to first frame cost=%lldms, m_MediaType=%d",
+                            (long long) (GetSysCurrentTime() - m_OpenStartTime), m_MediaType);
+                    m_OpenStartTime = -1;
+                }
+                if(m_SeekRequestTime != -1) {
+                    LOGCATE("DecoderBase::DecodeOnePacket seek to first frame cost=%lldms, scrubbing=%d, coalesced=%d, m_MediaType=%d",
+                            (long long) (GetSysCurrentTime() - m_SeekRequestTime), m_Scrubbing, m_SeekCoalescedCount, m_MediaType);
+                    m_SeekRequestTime = -1;
+                    m_SeekCoalescedCount = 0;
+                }
                 frameCount ++;
+                //同步等待和渲染不计入解码耗时
+                decodeStart = av_gettime_relative();
             }
             LOGCATE("BaseDecoder::DecodeOneFrame frameCount=%d", frameCount);
             //判断一个 packet 是否解码完成
@@ -305,7 +626,7 @@ int DecoderBase::DecodeOnePacket() {
             }
         }
         av_packet_unref(m_Packet);
-        result = av_read_frame(m_AVFormatContext, m_Packet);
+        result = ReadPacket();
     }
 
 __EXIT:
@@ -313,6 +634,110 @@ __EXIT:
     return result;
 }
 
+int DecoderBase::InterruptCallback(void *ctx) {
+    DecoderBase *decoder = static_cast<DecoderBase *>(ctx);
+    if(decoder->m_DecoderState == STATE_STOP) {
+        return 1;
+    }
+    if(decoder->m_Reading && decoder->m_SeekPending) {
+        return 1;
+    }
+    int64_t deadline = decoder->m_IODeadline;
+    if(deadline > 0 && av_gettime_relative() > deadline) {
+        LOGCATE("DecoderBase::InterruptCallback I/O timeout, m_MediaType=%d", decoder->m_MediaType);
+        return 1;
+    }
+    return 0;
+}
+
+int DecoderBase::ReadPacket() {
+    m_IODeadline = av_gettime_relative() + IO_READ_TIMEOUT;
+    m_Reading = true;
+    int result = av_read_frame(m_AVFormatContext, m_Packet);
+    m_Reading = false;
+    m_IODeadline = 0;
+    if(result == 0 && m_LiveMode && m_Packet->stream_index == m_StreamIndex)
+        UpdateArrivalBase(m_Packet);
+    return result;
+}
+
+bool DecoderBase::IsLiveUrl(const char *url) {
+    static const char *LIVE_PROTOCOLS[] = {"rtsp://", "rtmp://", "rtp://", "udp://", "srt://"};
+    for(size_t i = 0; i < sizeof(LIVE_PROTOCOLS) / sizeof(LIVE_PROTOCOLS[0]); i++) {
+        if(strncmp(url, LIVE_PROTOCOLS[i], strlen(LIVE_PROTOCOLS[i])) == 0)
+            return true;
+    }
+    return false;
+}
+
+void DecoderBase::UpdateArrivalBase(AVPacket *packet) {
+    int64_t timestamp = packet->dts != AV_NOPTS_VALUE ? packet->dts : packet->pts;
+    if(timestamp == AV_NOPTS_VALUE) return;
+    long timestampMs = (long)(timestamp * av_q2d(m_AVFormatContext->streams[m_StreamIndex]->time_base) * 1000);
+    long offset = GetSysCurrentTime() - timestampMs;
+
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    if(m_ArrivalBase == -1 || labs(offset - m_ArrivalBase) > LIVE_TIMESTAMP_JUMP) {
+        //第一个数据包或者时间戳跳变（推流端重启等），重新建立基准并对齐播放时钟
+        LOGCATE("DecoderBase::UpdateArrivalBase reset, offset=%ld, base=%ld, m_MediaType=%d", offset, m_ArrivalBase, m_MediaType);
+        m_ArrivalBase = offset;
+        m_LiveAnchored = false;
+    } else if(offset < m_ArrivalBase) {
+        m_ArrivalBase = offset;
+    }
+}
+
+bool DecoderBase::LiveCatchUp() {
+    if(!m_LiveMode || !m_LiveAnchored) return false;
+
+    long now = GetSysCurrentTime();
+    long renderTime = FFMAX(now, m_StartTimeStamp + m_CurTimeStamp);
+    long latency = renderTime - m_CurTimeStamp - m_ArrivalBase;
+    long excess = latency - m_LatencyTarget;
+    bool drop = false;
+
+    if(excess > LIVE_CATCHUP_DROP_THRESHOLD) {
+        //积压太多，时钟直接跳到目标延迟，积压的帧在下面按迟到丢弃
+        m_StartTimeStamp -= excess;
+        LOGCATE("DecoderBase::LiveCatchUp jump, latency=%ldms, target=%dms, m_MediaType=%d", latency, m_LatencyTarget, m_MediaType);
+    } else if(excess > LIVE_LATENCY_TOLERANCE) {
+        long frameDuration = 0;
+        if(m_Frame->pkt_duration > 0) {
+            frameDuration = (long)(m_Frame->pkt_duration * av_q2d(m_AVFormatContext->streams[m_StreamIndex]->time_base) * 1000);
+        } else if(m_MediaType == AVMEDIA_TYPE_AUDIO && m_Frame->sample_rate > 0) {
+            frameDuration = m_Frame->nb_samples * 1000L / m_Frame->sample_rate;
+        }
+        if(m_MediaType == AVMEDIA_TYPE_VIDEO) {
+            //视频加快播放时钟
+            m_StartTimeStamp -= FFMIN(excess, FFMAX(1L, frameDuration * LIVE_CATCHUP_SPEED_PERCENT / 100));
+        } else if(++m_LiveCatchUpCounter >= 100 / LIVE_CATCHUP_SPEED_PERCENT) {
+            //音频没有变速，每隔若干帧丢一帧，时钟前移一帧
+            m_LiveCatchUpCounter = 0;
+            m_StartTimeStamp -= FFMIN(excess, frameDuration);
+            drop = true;
+        }
+        m_LiveSpeedUpCount++;
+    }
+
+    //已经迟到的帧直接丢弃，连续丢弃太多时至少显示一帧
+    if(now - (m_StartTimeStamp + m_CurTimeStamp) > LIVE_LATENCY_TOLERANCE)
+        drop = true;
+    if(drop && ++m_LiveConsecutiveDrop > LIVE_MAX_CONSECUTIVE_DROP)
+        drop = false;
+    if(drop) {
+        m_LiveDropCount++;
+    } else {
+        m_LiveConsecutiveDrop = 0;
+    }
+
+    if(now - m_LiveLogTime >= 1000) {
+        LOGCATE("DecoderBase::LiveCatchUp latency=%ldms, target=%dms, [speedUp, drop]=[%d, %d], m_MediaType=%d",
+                latency, m_LatencyTarget, m_LiveSpeedUpCount, m_LiveDropCount, m_MediaType);
+        m_LiveLogTime = now;
+    }
+    return drop;
+}
+
 void DecoderBase::DoAVDecoding(DecoderBase *decoder) {
     LOGCATE("DecoderBase::DoAVDecoding");
     do {
@@ -24,10 +24,23 @@ extern "C" {
 };
 
 #include <thread>
+#include <FrameBufferPool.h>
+#include <KeyFrameIndex.h>
+#include <MediaSource.h>
+#include <StreamInfoCache.h>
+#include <WakeupCounter.h>
 #include "Decoder.h"
 
 #define MAX_PATH   2048                        // 最大路径长度
 #define DELAY_THRESHOLD 100                   // 延迟阈值（100ms）
+#define IO_OPEN_TIMEOUT 15000000              // 打开媒体、seek 的 I/O 超时（微秒）
+#define IO_READ_TIMEOUT 10000000              // 读取一个数据包的 I/O 超时（微秒）
+#define LIVE_LATENCY_TARGET 300               // 直播默认目标延迟（毫秒）
+#define LIVE_LATENCY_TOLERANCE 50             // 直播延迟超过目标这么多时开始追赶（毫秒）
+#define LIVE_CATCHUP_DROP_THRESHOLD 1000      // 直播延迟超过目标这么多时直接跳到目标延迟，丢弃积压的帧（毫秒）
+#define LIVE_CATCHUP_SPEED_PERCENT 10         // 直播追赶时的加速比例（%）
+#define LIVE_MAX_CONSECUTIVE_DROP 10          // 直播连续丢弃的最大帧数，之后至少显示一帧
+#define LIVE_TIMESTAMP_JUMP 10000             // 时间戳跳变阈值，超过时重新建立到达时间基准（毫秒）
 
 using namespace std;
 
@@ -49,7 +62,10 @@ enum DecoderMsg {
     MSG_DECODER_READY,                        // 解码器准备就绪
     MSG_DECODER_DONE,                         // 解码完成
     MSG_REQUEST_RENDER,                       // 请求渲染
-    MSG_DECODING_TIME                         // 解码时间
+    MSG_DECODING_TIME,                        // 解码时间
+    MSG_BUFFERING_START,                      // 开始缓冲（数据不足，暂停输出）
+    MSG_BUFFERING_END,                        // 缓冲结束（达到低水位，恢复输出）
+    MSG_DECODER_ERROR                         // 播放过程中解码出错，无法继续
 };
 
 /**
@@ -106,6 +122,33 @@ public:
      */
     virtual void SeekToPosition(float position);
 
+    /**
+     * @brief 拖动预览到指定位置
+     * 只解码关键帧并立即显示，显示后停在该帧等待下一次拖动；
+     * 解码线程来不及处理的请求会被合并，只处理最新的目标位置
+     * @param position 目标播放位置（秒）
+     */
+    virtual void ScrubToPosition(float position);
+
+    /**
+     * @brief 设置是否精确 seek
+     * 开启后从目标位置之前的关键帧开始解码，丢弃目标时间之前的帧（不做格式转换和渲染），
+     * 音频裁剪到相同的时间点；关闭时直接显示关键帧
+     * @param accurate 是否精确 seek，默认开启
+     */
+    void SetAccurateSeek(bool accurate) {
+        m_AccurateSeek = accurate;
+    }
+
+    /**
+     * @brief 设置直播的目标延迟
+     * 直播模式（rtsp/rtmp 等协议，或没有时长的流）下，延迟超过目标时加速或丢帧追赶
+     * @param latencyMs 目标延迟（毫秒），默认 LIVE_LATENCY_TARGET
+     */
+    void SetLatencyTarget(int latencyMs) {
+        m_LatencyTarget = latencyMs;
+    }
+
     /**
      * @brief 获取当前播放位置
      * 用于更新进度条和音视频同步
@@ -189,6 +232,30 @@ protected:
         return m_AVCodecContext;
     }
 
+    /**
+     * @brief 获取当前解码的数据流
+     * @return AVStream指针，包含流级别的信息（如显示矩阵），未打开时返回 nullptr
+     */
+    AVStream *GetStream() {
+        if(m_AVFormatContext == nullptr || m_StreamIndex < 0) return nullptr;
+        return m_AVFormatContext->streams[m_StreamIndex];
+    }
+
+    /**
+     * @brief 获取解码器支持的最大降分辨率系数
+     * @return 0 表示解码器不支持 lowres
+     */
+    int GetMaxLowres() {
+        return m_AVCodec != nullptr ? m_AVCodec->max_lowres : 0;
+    }
+
+    /**
+     * @brief 请求切换降分辨率解码
+     * 解码输出尺寸为原尺寸 >> lowres，实际切换在解码线程中进行（重新打开解码器并回到当前位置）
+     * @param lowres 降分辨率系数，0 表示全分辨率
+     */
+    void RequestLowres(int lowres);
+
 private:
     /**
      * @brief 初始化FFmpeg解码器
@@ -229,6 +296,20 @@ private:
      */
     long AVSync();
 
+    /**
+     * @brief 执行待处理的 seek 请求
+     * 在解码线程中调用，只处理最新的一次请求
+     */
+    void DoSeek();
+
+    /**
+     * @brief 精确 seek 时判断解码出来的帧是否需要丢弃
+     * 完全在目标时间之前的帧丢弃；音频帧跨越目标时间时裁掉前面的采样
+     * @param frame 解码后的帧
+     * @return true 表示丢弃该帧
+     */
+    bool DiscardBeforeSeekTarget(AVFrame *frame);
+
     /**
      * @brief 解码一个packet编码数据
      * 发送packet到解码器并接收解码后的frame
@@ -236,6 +317,20 @@ private:
      */
     int DecodeOnePacket();
 
+    /**
+     * @brief 以新的 lowres 重新打开解码器
+     * 在解码线程中调用，打开失败时保留原解码器
+     * @param lowres 降分辨率系数
+     * @return 0表示成功，负数表示失败
+     */
+    int ReopenDecoder(int lowres);
+
+    /**
+     * @brief 设置解码器上下文的帧缓冲池和标志位，打开和重新打开解码器时共用
+     * @param codecCtx 尚未打开的解码器上下文
+     */
+    void ConfigCodecContext(AVCodecContext *codecCtx);
+
     /**
      * @brief 解码线程函数（静态函数）
      * @param decoder 解码器实例指针
@@ -243,13 +338,49 @@ private:
      */
     static void DoAVDecoding(DecoderBase *decoder);
 
+    /**
+     * @brief I/O 中断回调（AVIOInterruptCB）
+     * 停止、读取过程中有新的 seek 请求、或者超过 I/O 截止时间时返回 1，
+     * 让阻塞在网络读写中的 avformat_open_input/av_read_frame 立即返回 AVERROR_EXIT
+     * @param ctx 解码器实例指针
+     * @return 1 中断，0 继续
+     */
+    static int InterruptCallback(void *ctx);
+
+    /**
+     * @brief 读取一个数据包，带超时，可被停止和 seek 中断
+     * @return av_read_frame 的返回值
+     */
+    int ReadPacket();
+
+    /**
+     * @brief 是否为直播协议
+     */
+    static bool IsLiveUrl(const char *url);
+
+    /**
+     * @brief 直播：根据读到的数据包更新到达时间基准
+     * 基准取（读取时间 - 时间戳）的最小值，对应读取最及时的数据包
+     */
+    void UpdateArrivalBase(AVPacket *packet);
+
+    /**
+     * @brief 直播延迟控制，在同步之前调用
+     * 延迟 = 预计显示时间 - 时间戳 - 到达时间基准；略高于目标时加速，远高于目标时时钟直接跳到目标延迟
+     * @return 当前帧是否丢弃
+     */
+    bool LiveCatchUp();
+
 private:
     // FFmpeg 核心组件
     AVFormatContext *m_AVFormatContext = nullptr;      // 封装格式上下文，用于读取媒体文件
+    MediaSource     *m_MediaSource = nullptr;          // 本地文件的 mmap 输入源，网络流为空
     AVCodecContext  *m_AVCodecContext = nullptr;       // 解码器上下文，包含解码参数
     AVCodec         *m_AVCodec = nullptr;              // 解码器实例
     AVPacket        *m_Packet = nullptr;               // 编码的数据包，从媒体文件读取的压缩数据
     AVFrame         *m_Frame = nullptr;                // 解码后的帧数据
+    FrameBufferPool *m_FrameBufferPool = nullptr;      // 视频帧缓冲池（get_buffer2），复用解码输出内存
+    shared_ptr<KeyFrameIndex> m_KeyFrameIndex;         // 后台建立的关键帧索引，就绪后按字节位置 seek
 
     // 媒体信息
     AVMediaType      m_MediaType = AVMEDIA_TYPE_UNKNOWN;  // 数据流的类型（音频/视频）
@@ -261,6 +392,21 @@ private:
     long             m_StartTimeStamp = -1;            // 播放的起始时间戳（毫秒）
     long             m_Duration = 0;                   // 总时长（毫秒）
 
+    // I/O 中断
+    volatile int64_t    m_IODeadline = 0;              // 当前 I/O 操作的截止时间（av_gettime_relative，微秒），0 表示不限
+    // 直播
+    bool                m_LiveMode = false;            // 是否为直播模式
+    volatile int        m_LatencyTarget = LIVE_LATENCY_TARGET; // 目标延迟（毫秒）
+    long                m_ArrivalBase = -1;            // 到达时间基准：读取时间 - 时间戳 的最小值（毫秒）
+    bool                m_LiveAnchored = false;        // 播放时钟是否已按到达时间基准对齐
+    int                 m_LiveConsecutiveDrop = 0;     // 连续丢弃的帧数
+    int                 m_LiveCatchUpCounter = 0;      // 音频加速追赶时的帧计数，每隔若干帧丢一帧
+    int                 m_LiveDropCount = 0;           // 追赶丢弃的帧数
+    int                 m_LiveSpeedUpCount = 0;        // 加速追赶的帧数
+    long                m_LiveLogTime = 0;             // 上次打印延迟的时间（毫秒）
+
+    volatile bool       m_Reading = false;             // 是否正在读取数据包，读取时新的 seek 请求可以中断它
+
     // 线程同步
     mutex               m_Mutex;                       // 互斥锁，保护共享数据
     condition_variable  m_Cond;                        // 条件变量，用于线程间通信
@@ -269,6 +415,22 @@ private:
     // Seek 相关
     volatile float      m_SeekPosition = 0;            // 目标 seek 位置（秒）
     volatile bool       m_SeekSuccess = false;         // seek 操作是否成功
+    volatile bool       m_SeekPending = false;         // 是否有待处理的 seek 请求
+    volatile bool       m_Scrubbing = false;           // 是否处于拖动预览（只解码关键帧）
+    long                m_OpenStartTime = -1;          // 开始打开媒体的时间（毫秒），用于统计打开到首帧的耗时
+    long                m_SeekRequestTime = -1;        // 最早未显示的 seek 请求时间（毫秒），用于统计 seek 到首帧的耗时
+    int                 m_SeekCoalescedCount = 0;      // 被合并掉的 seek 请求数
+    volatile bool       m_AccurateSeek = true;         // 是否精确 seek
+    int64_t             m_SeekTargetPts = AV_NOPTS_VALUE; // 精确 seek 的目标时间戳（流时间基），到达后重置
+    long                m_SeekKeyFrameCost = -1;       // 精确 seek 解出关键帧的耗时（毫秒），对比关键帧 seek 的开销
+    int                 m_SeekDiscardCount = 0;        // 精确 seek 丢弃的帧数
+    int64_t             m_RenderedPtsEnd = AV_NOPTS_VALUE; // 最后显示帧的结束时间戳（流时间基），重新打开解码器后从这里继续
+
+    // 降分辨率解码
+    volatile int        m_RequestLowres = 0;           // 请求的 lowres 系数
+    int                 m_Lowres = 0;                  // 当前解码器使用的 lowres 系数
+    int64_t             m_DecodeTimeUs = 0;            // 当前 lowres 下累计解码耗时（微秒）
+    int64_t             m_DecodeFrameCount = 0;        // 当前 lowres 下累计解码帧数
 
     // 状态和回调
     volatile int        m_DecoderState = STATE_UNKNOWN;   // 解码器当前状态
@@ -15,15 +15,24 @@
  * 在解码器初始化完成后被调用，用于：
  * 1. 获取视频宽高信息
  * 2. 初始化视频渲染器，获取渲染目标尺寸
- * 3. 创建SwsContext用于视频格式转换（YUV->RGBA等）
- * 4. 分配RGBA帧缓冲区
- * 5. 可选：初始化视频录制器（仅在NativeWindow渲染模式下）
+ * 3. 创建SwsContext用于视频格式转换（YUV->RGBA等），10bit 内容在 GL 渲染下不创建
+ * 4. 向渲染器传递色彩空间信息（BT.601/709/2020, PQ/HLG）
+ * 5. 分配RGBA帧缓冲区
+ * 6. 可选：初始化视频录制器（仅在NativeWindow渲染模式下）
+ * 7. 根据显示区域大小选择解码分辨率
  */
 void VideoDecoder::OnDecoderReady() {
     LOGCATE("VideoDecoder::OnDecoderReady");
     // 获取视频原始宽高
     m_VideoWidth = GetCodecContext()->width;
     m_VideoHeight = GetCodecContext()->height;
+    // 读取显示矩阵，旋转在渲染时完成，目前只有 GL 渲染支持
+    if(DisplayMatrix::ReadFromStream(GetStream(), &m_DisplayRotation, &m_DisplayHFlip) &&
+       (m_VideoRender == nullptr || m_VideoRender->GetRenderType() != VIDEO_RENDER_OPENGL)) {
+        LOGCATE("VideoDecoder::OnDecoderReady display matrix ignored, rotation=%d", m_DisplayRotation);
+        m_DisplayRotation = 0;
+        m_DisplayHFlip = false;
+    }
 
     // 通知播放器解码器已就绪
     if(m_MsgContext && m_MsgCallback)
@@ -31,11 +40,34 @@ void VideoDecoder::OnDecoderReady() {
 
     if(m_VideoRender != nullptr) {
         // 初始化渲染器，获取渲染目标尺寸
+        m_VideoRender->SetDisplayOrientation(m_DisplayRotation, m_DisplayHFlip);
         int dstSize[2] = {0};
         m_VideoRender->Init(m_VideoWidth, m_VideoHeight, dstSize);
         m_RenderWidth = dstSize[0];
         m_RenderHeight = dstSize[1];
 
+        // 传递色彩信息，GL 渲染器据此选择 YUV 矩阵并对 HDR 做色调映射
+        AVCodecContext *codecCtx = GetCodecContext();
+        int colorSpace = m_VideoHeight >= 720 ? VIDEO_COLOR_SPACE_BT709 : VIDEO_COLOR_SPACE_BT601;
+        if(codecCtx->colorspace == AVCOL_SPC_BT2020_NCL || codecCtx->colorspace == AVCOL_SPC_BT2020_CL) {
+            colorSpace = VIDEO_COLOR_SPACE_BT2020;
+        } else if(codecCtx->colorspace == AVCOL_SPC_BT709) {
+            colorSpace = VIDEO_COLOR_SPACE_BT709;
+        } else if(codecCtx->colorspace == AVCOL_SPC_BT470BG || codecCtx->colorspace == AVCOL_SPC_SMPTE170M) {
+            colorSpace = VIDEO_COLOR_SPACE_BT601;
+        }
+        int colorTransfer = VIDEO_COLOR_TRC_SDR;
+        if(codecCtx->color_trc == AVCOL_TRC_SMPTE2084) {
+            colorTransfer = VIDEO_COLOR_TRC_PQ;
+        } else if(codecCtx->color_trc == AVCOL_TRC_ARIB_STD_B67) {
+            colorTransfer = VIDEO_COLOR_TRC_HLG;
+        }
+        m_VideoRender->SetColorInfo(colorSpace, colorTransfer, codecCtx->color_range == AVCOL_RANGE_JPEG);
+
+        m_NativeHighBitDepth = m_VideoRender->GetRenderType() == VIDEO_RENDER_OPENGL &&
+                               (codecCtx->pix_fmt == AV_PIX_FMT_P010LE || codecCtx->pix_fmt == AV_PIX_FMT_YUV420P10LE);
+        LOGCATE("VideoDecoder::OnDecoderReady pix_fmt=%d, m_NativeHighBitDepth=%d", codecCtx->pix_fmt, m_NativeHighBitDepth);
+
         // 如果是NativeWindow渲染模式，初始化视频录制器
         if(m_VideoRender->GetRenderType() == VIDEO_RENDER_ANWINDOW) {
             int fps = 25;
@@ -44,24 +76,76 @@ void VideoDecoder::OnDecoderReady() {
             m_pVideoRecorder->StartRecord();
         }
 
-        // 分配RGBA帧和缓冲区
-        m_RGBAFrame = av_frame_alloc();
-        int bufferSize = av_image_get_buffer_size(DST_PIXEL_FORMAT, m_RenderWidth, m_RenderHeight, 1);
-        m_FrameBuffer = (uint8_t *) av_malloc(bufferSize * sizeof(uint8_t));
-        // 为RGBA帧填充数据指针和行大小信息
-        av_image_fill_arrays(m_RGBAFrame->data, m_RGBAFrame->linesize,
-                             m_FrameBuffer, DST_PIXEL_FORMAT, m_RenderWidth, m_RenderHeight, 1);
-
-        // 创建视频格式转换上下文（Sws: Software Scale）
-        // 用于将解码后的视频帧转换为RGBA格式
-        m_SwsContext = sws_getContext(m_VideoWidth, m_VideoHeight, GetCodecContext()->pix_fmt,
-                                      m_RenderWidth, m_RenderHeight, DST_PIXEL_FORMAT,
-                                      SWS_FAST_BILINEAR, NULL, NULL, NULL);
+        // 10bit 帧在 GL 渲染器中由 shader 完成转换，不需要 RGBA 缓冲区和 SwsContext
+        if(!m_NativeHighBitDepth) {
+            // 分配RGBA帧和缓冲区
+            m_RGBAFrame = av_frame_alloc();
+            int bufferSize = av_image_get_buffer_size(DST_PIXEL_FORMAT, m_RenderWidth, m_RenderHeight, 1);
+            m_FrameBuffer = (uint8_t *) av_malloc(bufferSize * sizeof(uint8_t));
+            // 为RGBA帧填充数据指针和行大小信息
+            av_image_fill_arrays(m_RGBAFrame->data, m_RGBAFrame->linesize,
+                                 m_FrameBuffer, DST_PIXEL_FORMAT, m_RenderWidth, m_RenderHeight, 1);
+
+            // 创建视频格式转换上下文（Sws: Software Scale）
+            // 用于将解码后的视频帧转换为RGBA格式
+            m_SwsContext = sws_getContext(m_VideoWidth, m_VideoHeight, GetCodecContext()->pix_fmt,
+                                          m_RenderWidth, m_RenderHeight, DST_PIXEL_FORMAT,
+                                          SWS_FAST_BILINEAR, NULL, NULL, NULL);
+        }
+
+        UpdateDecodeResolution();
     } else {
         LOGCATE("VideoDecoder::OnDecoderReady m_VideoRender == null");
     }
 }
 
+/**
+ * @brief 根据显示区域大小选择解码分辨率
+ *
+ * 显示区域远小于视频尺寸时（如 4K 视频显示在 540p 的 View 中），全分辨率解码后再缩小是浪费：
+ * - 支持 lowres 的解码器（mjpeg、mpeg2、mpeg4 等）直接按 1/2、1/4、1/8 分辨率解码，
+ *   选择解码输出仍不小于显示区域的最大系数，切换时重新打开解码器
+ * - 不支持 lowres 的解码器（h264、hevc 等）在显示区域不超过视频的一半时跳过非参考帧的环路滤波，
+ *   缩小显示后几乎不可见，可降低一部分解码开销
+ */
+void VideoDecoder::UpdateDecodeResolution() {
+    if(m_VideoRender == nullptr || m_VideoWidth <= 0 || m_VideoHeight <= 0) return;
+
+    int surfaceSize[2] = {0};
+    m_VideoRender->GetSurfaceSize(surfaceSize);
+    if(surfaceSize[0] == m_SurfaceWidth && surfaceSize[1] == m_SurfaceHeight) return;
+    m_SurfaceWidth = surfaceSize[0];
+    m_SurfaceHeight = surfaceSize[1];
+
+    int lowres = 0;
+    bool halfSize = false;
+    if(m_LowresDecodeEnable && m_SurfaceWidth > 0 && m_SurfaceHeight > 0) {
+        //按宽高比适配后的显示尺寸，旋转 90/270 度显示时换算回编码方向
+        int dstWidth = m_DisplayRotation % 180 == 0 ? m_SurfaceWidth : m_SurfaceHeight;
+        int dstHeight = m_DisplayRotation % 180 == 0 ? m_SurfaceHeight : m_SurfaceWidth;
+        int surfaceWidth = dstWidth;
+        int surfaceHeight = dstHeight;
+        if (surfaceWidth * m_VideoHeight > surfaceHeight * m_VideoWidth) {
+            dstWidth = surfaceHeight * m_VideoWidth / m_VideoHeight;
+        } else {
+            dstHeight = surfaceWidth * m_VideoHeight / m_VideoWidth;
+        }
+        while (lowres < GetMaxLowres() && (m_VideoWidth >> (lowres + 1)) >= dstWidth &&
+               (m_VideoHeight >> (lowres + 1)) >= dstHeight) {
+            lowres++;
+        }
+        halfSize = (m_VideoWidth >> 1) >= dstWidth && (m_VideoHeight >> 1) >= dstHeight;
+    }
+
+    LOGCATE("VideoDecoder::UpdateDecodeResolution video[w,h]=[%d, %d], surface[w,h]=[%d, %d], lowres=%d, maxLowres=%d",
+            m_VideoWidth, m_VideoHeight, m_SurfaceWidth, m_SurfaceHeight, lowres, GetMaxLowres());
+    if(GetMaxLowres() > 0) {
+        RequestLowres(lowres);
+    } else {
+        GetCodecContext()->skip_loop_filter = halfSize ? AVDISCARD_NONREF : AVDISCARD_DEFAULT;
+    }
+}
+
 /**
  * @brief 视频解码器完成回调
  *
@@ -118,12 +202,19 @@ void VideoDecoder::OnDecoderDone() {
 void VideoDecoder::OnFrameAvailable(AVFrame *frame) {
     LOGCATE("VideoDecoder::OnFrameAvailable frame=%p", frame);
     if(m_VideoRender != nullptr && frame != nullptr) {
+        //显示区域可能随时变化，检查是否需要切换解码分辨率
+        UpdateDecodeResolution();
+
         NativeImage image;
         LOGCATE("VideoDecoder::OnFrameAvailable frame[w,h]=[%d, %d],format=%d,[line0,line1,line2]=[%d, %d, %d]", frame->width, frame->height, GetCodecContext()->pix_fmt, frame->linesize[0], frame->linesize[1],frame->linesize[2]);
         if(m_VideoRender->GetRenderType() == VIDEO_RENDER_ANWINDOW)
         {
+            //降分辨率解码时输入尺寸会变化，按帧尺寸获取转换上下文
+            m_SwsContext = sws_getCachedContext(m_SwsContext, frame->width, frame->height, GetCodecContext()->pix_fmt,
+                                                m_RenderWidth, m_RenderHeight, DST_PIXEL_FORMAT,
+                                                SWS_FAST_BILINEAR, NULL, NULL, NULL);
             sws_scale(m_SwsContext, frame->data, frame->linesize, 0,
-                      m_VideoHeight, m_RGBAFrame->data, m_RGBAFrame->linesize);
+                      frame->height, m_RGBAFrame->data, m_RGBAFrame->linesize);
 
             image.format = IMAGE_FORMAT_RGBA;
             image.width = m_RenderWidth;
@@ -160,20 +251,45 @@ void VideoDecoder::OnFrameAvailable(AVFrame *frame) {
             image.pLineSize[1] = frame->linesize[1];
             image.ppPlane[0] = frame->data[0];
             image.ppPlane[1] = frame->data[1];
+        } else if (m_NativeHighBitDepth && GetCodecContext()->pix_fmt == AV_PIX_FMT_P010LE) {
+            image.format = IMAGE_FORMAT_P010;
+            image.width = frame->width;
+            image.height = frame->height;
+            image.pLineSize[0] = frame->linesize[0];
+            image.pLineSize[1] = frame->linesize[1];
+            image.ppPlane[0] = frame->data[0];
+            image.ppPlane[1] = frame->data[1];
+        } else if (m_NativeHighBitDepth && GetCodecContext()->pix_fmt == AV_PIX_FMT_YUV420P10LE) {
+            image.format = IMAGE_FORMAT_I010;
+            image.width = frame->width;
+            image.height = frame->height;
+            image.pLineSize[0] = frame->linesize[0];
+            image.pLineSize[1] = frame->linesize[1];
+            image.pLineSize[2] = frame->linesize[2];
+            image.ppPlane[0] = frame->data[0];
+            image.ppPlane[1] = frame->data[1];
+            image.ppPlane[2] = frame->data[2];
         } else if (GetCodecContext()->pix_fmt == AV_PIX_FMT_RGBA) {
             image.format = IMAGE_FORMAT_RGBA;
             image.width = frame->width;
             image.height = frame->height;
             image.pLineSize[0] = frame->linesize[0];
             image.ppPlane[0] = frame->data[0];
-        } else {
+        } else if (m_RGBAFrame != nullptr) {
+            //降分辨率解码时输入尺寸会变化，按帧尺寸获取转换上下文
+            m_SwsContext = sws_getCachedContext(m_SwsContext, frame->width, frame->height, GetCodecContext()->pix_fmt,
+                                                m_RenderWidth, m_RenderHeight, DST_PIXEL_FORMAT,
+                                                SWS_FAST_BILINEAR, NULL, NULL, NULL);
             sws_scale(m_SwsContext, frame->data, frame->linesize, 0,
-                      m_VideoHeight, m_RGBAFrame->data, m_RGBAFrame->linesize);
+                      frame->height, m_RGBAFrame->data, m_RGBAFrame->linesize);
             image.format = IMAGE_FORMAT_RGBA;
             image.width = m_RenderWidth;
             image.height = m_RenderHeight;
             image.ppPlane[0] = m_RGBAFrame->data[0];
             image.pLineSize[0] = image.width * 4;
+        } else {
+            LOGCATE("VideoDecoder::OnFrameAvailable unexpected format=%d", GetCodecContext()->pix_fmt);
+            return;
         }
 
         m_VideoRender->RenderVideoFrame(&image);
@@ -24,6 +24,7 @@ extern "C" {
 #include <render/video/VideoRender.h>
 #include <SingleVideoRecorder.h>
 #include "DecoderBase.h"
+#include "DisplayMatrix.h"
 
 class VideoDecoder : public DecoderBase {
 
@@ -45,16 +46,42 @@ public:
         return m_VideoHeight;
     }
 
+    /**
+     * 按显示矩阵旋转后的显示尺寸，用于适配显示区域的宽高比
+     */
+    int GetDisplayWidth()
+    {
+        return m_DisplayRotation % 180 == 0 ? m_VideoWidth : m_VideoHeight;
+    }
+    int GetDisplayHeight()
+    {
+        return m_DisplayRotation % 180 == 0 ? m_VideoHeight : m_VideoWidth;
+    }
+
     void SetVideoRender(VideoRender *videoRender)
     {
         m_VideoRender = videoRender;
     }
 
+    /**
+     * 显示区域明显小于视频时，按显示尺寸降分辨率解码（lowres），默认开启
+     * @param enable 是否开启
+     */
+    void SetLowresDecodeEnable(bool enable)
+    {
+        m_LowresDecodeEnable = enable;
+    }
+
 private:
     virtual void OnDecoderReady();
     virtual void OnDecoderDone();
     virtual void OnFrameAvailable(AVFrame *frame);
 
+    /**
+     * 根据当前显示区域大小选择解码分辨率，显示区域变化时动态切换
+     */
+    void UpdateDecodeResolution();
+
     const AVPixelFormat DST_PIXEL_FORMAT = AV_PIX_FMT_RGBA;
 
     int m_VideoWidth = 0;
@@ -63,6 +90,18 @@ private:
     int m_RenderWidth = 0;
     int m_RenderHeight = 0;
 
+    //视频流显示矩阵描述的旋转和镜像，如按传感器方向录制的视频
+    int m_DisplayRotation = 0;
+    bool m_DisplayHFlip = false;
+
+    //降分辨率解码
+    bool m_LowresDecodeEnable = true;
+    int m_SurfaceWidth = 0;
+    int m_SurfaceHeight = 0;
+
+    //10bit(P010/YUV420P10LE) 直接以 16bit 纹理送 GL 渲染，不经过 sws
+    bool m_NativeHighBitDepth = false;
+
     AVFrame *m_RGBAFrame = nullptr;
     uint8_t *m_FrameBuffer = nullptr;
 
@@ -5,6 +5,9 @@
 #ifndef LEARNFFMPEG_AUDIORENDER_H
 #define LEARNFFMPEG_AUDIORENDER_H
 
+// 非 hardCopy 的音频帧析构时归还数据的回调，opaque 为数据的所有者
+typedef void (*AudioFrameReleaseFunc)(void *opaque, uint8_t *data);
+
 class AudioFrame {
 public:
     AudioFrame(uint8_t * data, int dataSize, bool hardCopy = true) {
@@ -12,6 +15,7 @@ public:
         this->data = data;
         this->hardCopy = hardCopy;
         if(hardCopy) {
+            this->capacity = dataSize;
             this->data = static_cast<uint8_t *>(malloc(this->dataSize));
             memcpy(this->data, data, dataSize);
         }
@@ -20,12 +24,17 @@ public:
     ~AudioFrame() {
         if(hardCopy && this->data)
             free(this->data);
+        else if(releaseFunc != nullptr)
+            releaseFunc(releaseOpaque, this->data);
         this->data = nullptr;
     }
 
     uint8_t * data = nullptr;
     int dataSize = 0;
+    int capacity = 0;   // hardCopy 时分配的大小，复用时不超过它即可直接拷贝
     bool hardCopy = true;
+    AudioFrameReleaseFunc releaseFunc = nullptr; // 非 hardCopy 时数据的归还方式
+    void *releaseOpaque = nullptr;
 };
 
 
@@ -37,6 +46,8 @@ public:
     virtual void ClearAudioCache() = 0;
     virtual void RenderAudioFrame(uint8_t *pData, int dataSize) = 0;
     virtual void UnInit() = 0;
+    // 已经播放完的字节数（ClearAudioCache 丢弃的数据也计入），调用方据此以实际播放位置作为音频时钟，不支持时返回 -1
+    virtual int64_t GetPlayedBytes() { return -1; }
 
 };
 
@@ -0,0 +1,77 @@
+/**
+ *
+ * Created by 公众号：字节流动 on 2026/10/18.
+ * https://github.com/githubhaohao/LearnFFmpeg
+ * 最新文章首发于公众号：字节流动，有疑问或者技术交流可以添加微信 Byte-Flow ,领取视频教程, 拉你进技术交流群
+ *
+ * */
+
+#include <LogUtil.h>
+#include "FileAudioRender.h"
+
+extern "C" {
+#include <libavutil/time.h>
+#include <libavutil/common.h>
+};
+
+void FileAudioRender::Init() {
+    LOGCATE("FileAudioRender::Init path=%s", m_Path.c_str());
+    if (!m_Path.empty()) {
+        m_File = fopen(m_Path.c_str(), "wb");
+        if (m_File == nullptr) {
+            LOGCATE("FileAudioRender::Init open %s fail, discard audio data", m_Path.c_str());
+        }
+    }
+}
+
+void FileAudioRender::ClearAudioCache() {
+    //丢弃还没"播放"的数据：以当前时间重新对齐播放位置
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_StartTime = av_gettime_relative() - m_WrittenBytes * 1000000 / FILE_AUDIO_BYTES_PER_SECOND;
+}
+
+void FileAudioRender::RenderAudioFrame(uint8_t *pData, int dataSize) {
+    if (pData == nullptr || dataSize <= 0) return;
+
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    int64_t now = av_gettime_relative();
+    //首帧或者断流之后以当前时间为起点
+    if (m_StartTime == -1 || GetPlayedBytesLocked(now) >= m_WrittenBytes) {
+        m_StartTime = now - m_WrittenBytes * 1000000 / FILE_AUDIO_BYTES_PER_SECOND;
+    }
+
+    if (m_File != nullptr) {
+        fwrite(pData, 1, dataSize, m_File);
+    }
+    m_WrittenBytes += dataSize;
+
+    //超前一帧以上时休眠，模拟设备按实际速率消费数据
+    int64_t queuedUs = (m_WrittenBytes - GetPlayedBytesLocked(now)) * 1000000 / FILE_AUDIO_BYTES_PER_SECOND;
+    int64_t frameUs = (int64_t) dataSize * 1000000 / FILE_AUDIO_BYTES_PER_SECOND;
+    lock.unlock();
+    if (queuedUs > frameUs) {
+        av_usleep(queuedUs - frameUs);
+    }
+}
+
+void FileAudioRender::UnInit() {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    LOGCATE("FileAudioRender::UnInit written bytes=%lld", (long long) m_WrittenBytes);
+    if (m_File != nullptr) {
+        fclose(m_File);
+        m_File = nullptr;
+    }
+}
+
+int64_t FileAudioRender::GetPlayedBytes() {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    return GetPlayedBytesLocked(av_gettime_relative());
+}
+
+int64_t FileAudioRender::GetPlayedBytesLocked(int64_t now) {
+    if (m_StartTime == -1) return 0;
+    int64_t played = (now - m_StartTime) * FILE_AUDIO_BYTES_PER_SECOND / 1000000;
+    //按 4 字节（一个采样点）对齐
+    played -= played % 4;
+    return FFMIN(played, m_WrittenBytes);
+}
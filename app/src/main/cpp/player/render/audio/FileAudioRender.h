@@ -0,0 +1,52 @@
+/**
+ *
+ * Created by 公众号：字节流动 on 2026/10/18.
+ * https://github.com/githubhaohao/LearnFFmpeg
+ * 最新文章首发于公众号：字节流动，有疑问或者技术交流可以添加微信 Byte-Flow ,领取视频教程, 拉你进技术交流群
+ *
+ * */
+
+#ifndef LEARNFFMPEG_FILEAUDIORENDER_H
+#define LEARNFFMPEG_FILEAUDIORENDER_H
+
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <mutex>
+#include "AudioRender.h"
+
+// 输入 PCM 的字节率：44100Hz、双声道、16 位，与 OpenSLRender 一致
+#define FILE_AUDIO_BYTES_PER_SECOND (44100 * 2 * 2)
+
+/**
+ * @brief 写文件或丢弃数据的音频输出，不依赖 OpenSL ES，用于 Linux 上测试和导出 PCM
+ *
+ * 路径为空时丢弃数据（null sink）。按实际时长节流：写入的数据超前于墙上时钟时 RenderAudioFrame 休眠，
+ * 播放位置按墙上时钟推进，行为和真实的音频设备一致，播放器的音视频同步可以正常工作。
+ * 数据断流（暂停、缓冲）后重新以当前时间为起点，不会在恢复时一次性冲出大量数据。
+ */
+class FileAudioRender : public AudioRender {
+public:
+    FileAudioRender(const char *path = nullptr) : m_Path(path ? path : "") {}
+    virtual ~FileAudioRender() {}
+    virtual void Init();
+    virtual void ClearAudioCache();
+    virtual void RenderAudioFrame(uint8_t *pData, int dataSize);
+    virtual void UnInit();
+    virtual int64_t GetPlayedBytes();
+
+private:
+    // 墙上时钟对应的播放位置，调用方持有 m_Mutex
+    int64_t GetPlayedBytesLocked(int64_t now);
+
+    std::string m_Path;
+    FILE       *m_File = nullptr;
+    std::mutex  m_Mutex;
+    int64_t     m_StartTime = -1;      // 播放位置 0 对应的时间（微秒）
+    int64_t     m_WrittenBytes = 0;    // 已经写入的字节数
+};
+
+
+#endif //LEARNFFMPEG_FILEAUDIORENDER_H
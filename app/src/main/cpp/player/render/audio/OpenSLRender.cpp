@@ -53,14 +53,16 @@ void OpenSLRender::RenderAudioFrame(uint8_t *pData, int dataSize) {
     if(m_AudioPlayerPlay) {
         if (pData != nullptr && dataSize > 0) {
 
-            //temp resolution, when queue size is too big.
-            while(GetAudioFrameQueueSize() >= MAX_QUEUE_BUFFER_SIZE && !m_Exit)
+            //队列满时阻塞，播放回调取走数据后唤醒
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            while(m_AudioFrameQueue.size() >= MAX_QUEUE_BUFFER_SIZE && !m_Exit)
             {
-                std::this_thread::sleep_for(std::chrono::milliseconds(15));
+                m_Cond.wait(lock);
+                m_ProducerWakeups.OnWakeup();
             }
+            if(m_Exit) return;
 
-            std::unique_lock<std::mutex> lock(m_Mutex);
-            AudioFrame *audioFrame = new AudioFrame(pData, dataSize);
+            AudioFrame *audioFrame = ObtainFrame(pData, dataSize);
             m_AudioFrameQueue.push(audioFrame);
             m_Cond.notify_all();
             lock.unlock();
@@ -81,6 +83,9 @@ void OpenSLRender::UnInit() {
     m_Exit = true;
     m_Cond.notify_all();
     lock.unlock();
+    m_ProducerWakeups.Report();
+    m_RenderWakeups.Report();
+    LOGCATE("OpenSLRender::UnInit played bytes=%lld, frame allocations=%d", (long long) m_PlayedBytes, m_FrameAllocCount);
 
     if (m_AudioPlayerObj) {
         (*m_AudioPlayerObj)->Destroy(m_AudioPlayerObj);
@@ -100,11 +105,19 @@ void OpenSLRender::UnInit() {
     }
 
     lock.lock();
-    for (int i = 0; i < m_AudioFrameQueue.size(); ++i) {
-        AudioFrame *audioFrame = m_AudioFrameQueue.front();
+    while (!m_AudioFrameQueue.empty()) {
+        delete m_AudioFrameQueue.front();
         m_AudioFrameQueue.pop();
-        delete audioFrame;
     }
+    for (size_t i = 0; i < m_FramePool.size(); ++i) {
+        delete m_FramePool[i];
+    }
+    m_FramePool.clear();
+    if (m_PlayingFrame) {
+        delete m_PlayingFrame;
+        m_PlayingFrame = nullptr;
+    }
+    m_Cond.notify_all();
     lock.unlock();
 
     if(m_thread != nullptr)
@@ -243,12 +256,11 @@ int OpenSLRender::CreateAudioPlayer() {
 
 void OpenSLRender::StartRender() {
 
-    while (GetAudioFrameQueueSize() < MAX_QUEUE_BUFFER_SIZE && !m_Exit) {
-        std::unique_lock<std::mutex> lock(m_Mutex);
-        m_Cond.wait_for(lock, std::chrono::milliseconds(10));
-        //m_Cond.wait(lock);
-        lock.unlock();
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    while (m_AudioFrameQueue.size() < MAX_QUEUE_BUFFER_SIZE && !m_Exit) {
+        m_Cond.wait(lock);
     }
+    lock.unlock();
 
     (*m_AudioPlayerPlay)->SetPlayState(m_AudioPlayerPlay, SL_PLAYSTATE_PLAYING);
     AudioPlayerCallback(m_BufferQueue, this);
@@ -258,19 +270,31 @@ void OpenSLRender::HandleAudioFrameQueue() {
     LOGCATE("OpenSLRender::HandleAudioFrameQueue QueueSize=%lu", m_AudioFrameQueue.size());
     if (m_AudioPlayerPlay == nullptr) return;
 
-    while (GetAudioFrameQueueSize() < MAX_QUEUE_BUFFER_SIZE && !m_Exit) {
-        std::unique_lock<std::mutex> lock(m_Mutex);
-        m_Cond.wait_for(lock, std::chrono::milliseconds(10));
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    //缓冲队列中只有一个缓冲区，回调时上一帧已经播放完，可以回收
+    if (m_PlayingFrame) {
+        m_PlayedBytes += m_PlayingFrame->dataSize;
+        RecycleFrame(m_PlayingFrame);
+        m_PlayingFrame = nullptr;
+    }
+
+    //等待解码线程填满队列，暂停时阻塞在这里
+    while (m_AudioFrameQueue.size() < MAX_QUEUE_BUFFER_SIZE && !m_Exit) {
+        m_Cond.wait(lock);
+        m_RenderWakeups.OnWakeup();
     }
+    if (m_AudioFrameQueue.empty()) return;
 
-    std::unique_lock<std::mutex> lock(m_Mutex);
     AudioFrame *audioFrame = m_AudioFrameQueue.front();
     if (nullptr != audioFrame && m_AudioPlayerPlay) {
         SLresult result = (*m_BufferQueue)->Enqueue(m_BufferQueue, audioFrame->data, (SLuint32) audioFrame->dataSize);
         if (result == SL_RESULT_SUCCESS) {
             AudioGLRender::GetInstance()->UpdateAudioFrame(audioFrame);
             m_AudioFrameQueue.pop();
-            delete audioFrame;
+            //OpenSL 不拷贝数据，播放完之前不能释放
+            m_PlayingFrame = audioFrame;
+            //唤醒等待队列有空间的解码线程
+            m_Cond.notify_all();
         }
 
     }
@@ -294,10 +318,39 @@ int OpenSLRender::GetAudioFrameQueueSize() {
 
 void OpenSLRender::ClearAudioCache() {
     std::unique_lock<std::mutex> lock(m_Mutex);
-    for (int i = 0; i < m_AudioFrameQueue.size(); ++i) {
+    while (!m_AudioFrameQueue.empty()) {
         AudioFrame *audioFrame = m_AudioFrameQueue.front();
         m_AudioFrameQueue.pop();
-        delete audioFrame;
+        m_PlayedBytes += audioFrame->dataSize;
+        RecycleFrame(audioFrame);
     }
+    //唤醒等待队列有空间的解码线程
+    m_Cond.notify_all();
+}
+
+int64_t OpenSLRender::GetPlayedBytes() {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    return m_PlayedBytes;
+}
 
+AudioFrame *OpenSLRender::ObtainFrame(uint8_t *pData, int dataSize) {
+    for (size_t i = 0; i < m_FramePool.size(); ++i) {
+        AudioFrame *audioFrame = m_FramePool[i];
+        if (audioFrame->capacity >= dataSize) {
+            m_FramePool.erase(m_FramePool.begin() + i);
+            memcpy(audioFrame->data, pData, dataSize);
+            audioFrame->dataSize = dataSize;
+            return audioFrame;
+        }
+    }
+    m_FrameAllocCount++;
+    return new AudioFrame(pData, dataSize);
+}
+
+void OpenSLRender::RecycleFrame(AudioFrame *audioFrame) {
+    if (m_FramePool.size() < AUDIO_FRAME_POOL_SIZE) {
+        m_FramePool.push_back(audioFrame);
+    } else {
+        delete audioFrame;
+    }
 }
@@ -9,21 +9,26 @@
 #include <SLES/OpenSLES.h>
 #include <SLES/OpenSLES_Android.h>
 #include <queue>
+#include <vector>
 #include <string>
 #include <thread>
 #include "AudioRender.h"
 #include "AudioGLRender.h"
+#include <WakeupCounter.h>
 
 #define MAX_QUEUE_BUFFER_SIZE 3
+// 复用的音频帧个数上限
+#define AUDIO_FRAME_POOL_SIZE (MAX_QUEUE_BUFFER_SIZE + 2)
 
 class OpenSLRender : public AudioRender {
 public:
-    OpenSLRender(){}
+    OpenSLRender() : m_ProducerWakeups("OpenSLRender::RenderAudioFrame"), m_RenderWakeups("OpenSLRender::HandleAudioFrameQueue") {}
     virtual ~OpenSLRender(){}
     virtual void Init();
     virtual void ClearAudioCache();
     virtual void RenderAudioFrame(uint8_t *pData, int dataSize);
     virtual void UnInit();
+    virtual int64_t GetPlayedBytes();
 
 private:
     int CreateEngine();
@@ -32,6 +37,10 @@ private:
     int GetAudioFrameQueueSize();
     void StartRender();
     void HandleAudioFrameQueue();
+    // 从复用池取一个音频帧并拷贝数据，调用方持有 m_Mutex
+    AudioFrame *ObtainFrame(uint8_t *pData, int dataSize);
+    // 把音频帧放回复用池，调用方持有 m_Mutex
+    void RecycleFrame(AudioFrame *audioFrame);
     static void CreateSLWaitingThread(OpenSLRender *openSlRender);
     static void AudioPlayerCallback(SLAndroidSimpleBufferQueueItf bufferQueue, void *context);
 
@@ -44,11 +53,18 @@ private:
     SLAndroidSimpleBufferQueueItf m_BufferQueue;
 
     std::queue<AudioFrame *> m_AudioFrameQueue;
+    std::vector<AudioFrame *> m_FramePool;         // 播放完的音频帧，复用避免每帧分配
+    AudioFrame *m_PlayingFrame = nullptr;          // 已经送入 OpenSL 缓冲队列的帧，下一次回调时播放完成
+    int64_t m_PlayedBytes = 0;                     // 已经播放完的字节数
+    int m_FrameAllocCount = 0;                     // 分配音频帧的次数
 
     std::thread *m_thread = nullptr;
     std::mutex   m_Mutex;
     std::condition_variable m_Cond;
     volatile bool m_Exit = false;
+
+    WakeupCounter m_ProducerWakeups;   // 解码线程等待队列有空间的唤醒次数
+    WakeupCounter m_RenderWakeups;     // 播放回调等待队列填满的唤醒次数
 };
 
 
@@ -27,12 +27,16 @@ public:
      */
     virtual void RenderVideoFrame(NativeImage *pImage);
     virtual void UnInit();
+    virtual void GetSurfaceSize(int *size) {
+        size[0] = m_DstWidth;
+        size[1] = m_DstHeight;
+    }
 
 private:
     ANativeWindow_Buffer m_NativeWindowBuffer;
     ANativeWindow *m_NativeWindow = nullptr;
-    int m_DstWidth;
-    int m_DstHeight;
+    int m_DstWidth = 0;
+    int m_DstHeight = 0;
 };
 
 
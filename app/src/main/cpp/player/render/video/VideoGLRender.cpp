@@ -83,6 +83,142 @@ static char fShaderStr[] =
         "    }\n"
         "}";
 
+static char fHDRShaderStr[] =
+        "//10bit YUV 渲染，支持 BT.2020 及 PQ/HLG 色调映射到 SDR\n"
+        "#version 300 es\n"
+        "precision highp float;\n"
+        "precision highp usampler2D;\n"
+        "in vec2 v_texCoord;\n"
+        "layout(location = 0) out vec4 outColor;\n"
+        "uniform usampler2D s_texture0;\n"
+        "uniform usampler2D s_texture1;\n"
+        "uniform usampler2D s_texture2;\n"
+        "uniform int u_nImgType;// 5:P010, 6:I010\n"
+        "uniform float u_SampleScale;// 16bit 采样值归一化系数\n"
+        "uniform int u_ColorSpace;// 0:BT.601, 1:BT.709, 2:BT.2020\n"
+        "uniform int u_Transfer;// 0:SDR, 1:PQ, 2:HLG\n"
+        "uniform int u_FullRange;\n"
+        "\n"
+        "const float SDR_WHITE_NITS = 203.0;\n"
+        "const float HDR_PEAK_NITS = 1000.0;\n"
+        "\n"
+        "//整型纹理不支持线性过滤，手动双线性插值\n"
+        "vec4 sampleBilinear(usampler2D tex, vec2 uv) {\n"
+        "    ivec2 size = textureSize(tex, 0);\n"
+        "    ivec2 maxPos = size - 1;\n"
+        "    vec2 pos = uv * vec2(size) - 0.5;\n"
+        "    ivec2 p0 = ivec2(floor(pos));\n"
+        "    vec2 f = fract(pos);\n"
+        "    vec4 c00 = vec4(texelFetch(tex, clamp(p0, ivec2(0), maxPos), 0));\n"
+        "    vec4 c10 = vec4(texelFetch(tex, clamp(p0 + ivec2(1, 0), ivec2(0), maxPos), 0));\n"
+        "    vec4 c01 = vec4(texelFetch(tex, clamp(p0 + ivec2(0, 1), ivec2(0), maxPos), 0));\n"
+        "    vec4 c11 = vec4(texelFetch(tex, clamp(p0 + ivec2(1, 1), ivec2(0), maxPos), 0));\n"
+        "    return mix(mix(c00, c10, f.x), mix(c01, c11, f.x), f.y) * u_SampleScale;\n"
+        "}\n"
+        "\n"
+        "vec3 pqToLinear(vec3 e) {\n"
+        "    const float m1 = 0.1593017578125;\n"
+        "    const float m2 = 78.84375;\n"
+        "    const float c1 = 0.8359375;\n"
+        "    const float c2 = 18.8515625;\n"
+        "    const float c3 = 18.6875;\n"
+        "    vec3 p = pow(max(e, 0.0), vec3(1.0 / m2));\n"
+        "    return pow(max(p - c1, 0.0) / (c2 - c3 * p), vec3(1.0 / m1)) * 10000.0;\n"
+        "}\n"
+        "\n"
+        "vec3 hlgToLinear(vec3 e) {\n"
+        "    const float a = 0.17883277;\n"
+        "    const float b = 0.28466892;\n"
+        "    const float c = 0.55991073;\n"
+        "    vec3 lo = e * e / 3.0;\n"
+        "    vec3 hi = (exp((e - c) / a) + b) / 12.0;\n"
+        "    vec3 scene = mix(lo, hi, step(0.5, e));\n"
+        "    //OOTF，系统 gamma 1.2\n"
+        "    float ys = dot(scene, vec3(0.2627, 0.6780, 0.0593));\n"
+        "    return scene * pow(max(ys, 1e-6), 0.2) * HDR_PEAK_NITS;\n"
+        "}\n"
+        "\n"
+        "void main()\n"
+        "{\n"
+        "    vec3 yuv;\n"
+        "    yuv.x = sampleBilinear(s_texture0, v_texCoord).r;\n"
+        "    if(u_nImgType == 5) //P010\n"
+        "    {\n"
+        "        yuv.yz = sampleBilinear(s_texture1, v_texCoord).rg;\n"
+        "    }\n"
+        "    else //I010\n"
+        "    {\n"
+        "        yuv.y = sampleBilinear(s_texture1, v_texCoord).r;\n"
+        "        yuv.z = sampleBilinear(s_texture2, v_texCoord).r;\n"
+        "    }\n"
+        "\n"
+        "    if(u_FullRange == 1)\n"
+        "    {\n"
+        "        yuv.yz -= 512.0 / 1023.0;\n"
+        "    }\n"
+        "    else\n"
+        "    {\n"
+        "        yuv.x = (yuv.x * 1023.0 - 64.0) / 876.0;\n"
+        "        yuv.yz = (yuv.yz * 1023.0 - 512.0) / 896.0;\n"
+        "    }\n"
+        "\n"
+        "    highp vec3 rgb;\n"
+        "    if(u_ColorSpace == 2) //BT.2020\n"
+        "    {\n"
+        "        rgb = mat3(1.0,     1.0,      1.0,\n"
+        "                   0.0,    -0.16455,  1.8814,\n"
+        "                   1.4746, -0.57135,  0.0) * yuv;\n"
+        "    }\n"
+        "    else if(u_ColorSpace == 1) //BT.709\n"
+        "    {\n"
+        "        rgb = mat3(1.0,     1.0,      1.0,\n"
+        "                   0.0,    -0.1873,   1.8556,\n"
+        "                   1.5748, -0.4681,   0.0) * yuv;\n"
+        "    }\n"
+        "    else //BT.601\n"
+        "    {\n"
+        "        rgb = mat3(1.0,     1.0,      1.0,\n"
+        "                   0.0,    -0.344,    1.772,\n"
+        "                   1.402,  -0.714,    0.0) * yuv;\n"
+        "    }\n"
+        "    rgb = clamp(rgb, 0.0, 1.0);\n"
+        "\n"
+        "    if(u_Transfer == 0 && u_ColorSpace != 2)\n"
+        "    {\n"
+        "        outColor = vec4(rgb, 1.0);\n"
+        "        return;\n"
+        "    }\n"
+        "\n"
+        "    //转到线性光，单位为 SDR 参考白\n"
+        "    vec3 linear;\n"
+        "    if(u_Transfer == 1)\n"
+        "        linear = pqToLinear(rgb) / SDR_WHITE_NITS;\n"
+        "    else if(u_Transfer == 2)\n"
+        "        linear = hlgToLinear(rgb) / SDR_WHITE_NITS;\n"
+        "    else\n"
+        "        linear = pow(rgb, vec3(2.2));\n"
+        "\n"
+        "    //BT.2020 色域转 BT.709 色域\n"
+        "    if(u_ColorSpace == 2)\n"
+        "    {\n"
+        "        linear = mat3( 1.6605, -0.1246, -0.0182,\n"
+        "                      -0.5876,  1.1329, -0.1006,\n"
+        "                      -0.0728, -0.0083,  1.1187) * linear;\n"
+        "        linear = max(linear, 0.0);\n"
+        "    }\n"
+        "\n"
+        "    //基于亮度的扩展 Reinhard 色调映射，保持色相\n"
+        "    if(u_Transfer != 0)\n"
+        "    {\n"
+        "        float maxWhite = HDR_PEAK_NITS / SDR_WHITE_NITS;\n"
+        "        float l = dot(linear, vec3(0.2126, 0.7152, 0.0722));\n"
+        "        float lm = l * (1.0 + l / (maxWhite * maxWhite)) / (1.0 + l);\n"
+        "        linear = linear * (lm / max(l, 1e-6));\n"
+        "    }\n"
+        "\n"
+        "    outColor = vec4(pow(clamp(linear, 0.0, 1.0), vec3(1.0 / 2.2)), 1.0);\n"
+        "}";
+
 static char fMeshShaderStr[] =
         "//dynimic mesh 动态网格\n"
         "#version 300 es\n"
@@ -219,7 +355,10 @@ void VideoGLRender::RenderVideoFrame(NativeImage *pImage) {
     if(pImage == nullptr || pImage->ppPlane[0] == nullptr)
         return;
     std::unique_lock<std::mutex> lock(m_Mutex);
-    if (pImage->width != m_RenderImage.width || pImage->height != m_RenderImage.height) {
+    //保持与解码帧相同的行宽，拷贝时按平面整体 memcpy，上传时用 GL_UNPACK_ROW_LENGTH 跳过行尾填充
+    if (pImage->width != m_RenderImage.width || pImage->height != m_RenderImage.height ||
+        pImage->format != m_RenderImage.format ||
+        memcmp(pImage->pLineSize, m_RenderImage.pLineSize, sizeof(m_RenderImage.pLineSize)) != 0) {
         if (m_RenderImage.ppPlane[0] != nullptr) {
             NativeImageUtil::FreeNativeImage(&m_RenderImage);
         }
@@ -227,7 +366,7 @@ void VideoGLRender::RenderVideoFrame(NativeImage *pImage) {
         m_RenderImage.format = pImage->format;
         m_RenderImage.width = pImage->width;
         m_RenderImage.height = pImage->height;
-        NativeImageUtil::AllocNativeImage(&m_RenderImage);
+        NativeImageUtil::AllocNativeImage(&m_RenderImage, pImage->pLineSize);
     }
 
     NativeImageUtil::CopyNativeImage(pImage, &m_RenderImage);
@@ -238,6 +377,20 @@ void VideoGLRender::UnInit() {
 
 }
 
+void VideoGLRender::SetColorInfo(int colorSpace, int transfer, bool fullRange) {
+    LOGCATE("VideoGLRender::SetColorInfo [colorSpace, transfer, fullRange]=[%d, %d, %d]", colorSpace, transfer, fullRange);
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_ColorSpace = colorSpace;
+    m_ColorTransfer = transfer;
+    m_FullRange = fullRange;
+}
+
+void VideoGLRender::SetDisplayOrientation(int clockwise, bool hflip) {
+    LOGCATE("VideoGLRender::SetDisplayOrientation [clockwise, hflip]=[%d, %d]", clockwise, hflip);
+    m_DisplayRotation = clockwise;
+    m_DisplayHFlip = hflip;
+}
+
 void VideoGLRender::UpdateMVPMatrix(int angleX, int angleY, float scaleX, float scaleY)
 {
     angleX = angleX % 360;
@@ -263,6 +416,9 @@ void VideoGLRender::UpdateMVPMatrix(int angleX, int angleY, float scaleX, float
     Model = glm::scale(Model, glm::vec3(scaleX, scaleY, 1.0f));
     Model = glm::rotate(Model, radiansX, glm::vec3(1.0f, 0.0f, 0.0f));
     Model = glm::rotate(Model, radiansY, glm::vec3(0.0f, 1.0f, 0.0f));
+    //显示矩阵：先顺时针旋转再镜像，裁剪空间 [-1, 1] 内旋转 90 度的整数倍正好铺满，宽高比由 SurfaceView 按显示尺寸适配
+    Model = glm::scale(Model, glm::vec3(m_DisplayHFlip ? -1.0f : 1.0f, 1.0f, 1.0f));
+    Model = glm::rotate(Model, static_cast<float>(-MATH_PI / 180.0f * m_DisplayRotation), glm::vec3(0.0f, 0.0f, 1.0f));
     Model = glm::translate(Model, glm::vec3(0.0f, 0.0f, 0.0f));
 
     m_MVPMatrix = Projection * View * Model;
@@ -342,6 +498,22 @@ void VideoGLRender::OnSurfaceCreated() {
         glBindTexture(GL_TEXTURE_2D, GL_NONE);
     }
 
+    m_HDRProgramObj = GLUtils::CreateProgram(vShaderStr, fHDRShaderStr);
+    if (!m_HDRProgramObj)
+    {
+        LOGCATE("VideoGLRender::OnSurfaceCreated create hdr program fail");
+    }
+
+    glGenTextures(TEXTURE_NUM, m_HDRTextureIds);
+    for (int i = 0; i < TEXTURE_NUM ; ++i) {
+        glBindTexture(GL_TEXTURE_2D, m_HDRTextureIds[i]);
+        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glBindTexture(GL_TEXTURE_2D, GL_NONE);
+    }
+
     // Generate VBO Ids and load the VBOs with data
     glGenBuffers(3, m_VboIds);
     glBindBuffer(GL_ARRAY_BUFFER, m_VboIds[0]);
@@ -393,11 +565,14 @@ void VideoGLRender::OnDrawFrame() {
 
     // upload image data
     std::unique_lock<std::mutex> lock(m_Mutex);
+    //行宽可能大于图像宽度（帧缓冲池对齐填充），按行宽直接上传
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
     switch (m_RenderImage.format)
     {
         case IMAGE_FORMAT_RGBA:
             glActiveTexture(GL_TEXTURE0);
             glBindTexture(GL_TEXTURE_2D, m_TextureIds[0]);
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, m_RenderImage.pLineSize[0] / 4);
             glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_RenderImage.width, m_RenderImage.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, m_RenderImage.ppPlane[0]);
             glBindTexture(GL_TEXTURE_2D, GL_NONE);
             break;
@@ -406,6 +581,7 @@ void VideoGLRender::OnDrawFrame() {
             //upload Y plane data
             glActiveTexture(GL_TEXTURE0);
             glBindTexture(GL_TEXTURE_2D, m_TextureIds[0]);
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, m_RenderImage.pLineSize[0]);
             glTexImage2D(GL_TEXTURE_2D, 0, GL_LUMINANCE, m_RenderImage.width,
                          m_RenderImage.height, 0, GL_LUMINANCE, GL_UNSIGNED_BYTE,
                          m_RenderImage.ppPlane[0]);
@@ -414,6 +590,7 @@ void VideoGLRender::OnDrawFrame() {
             //update UV plane data
             glActiveTexture(GL_TEXTURE1);
             glBindTexture(GL_TEXTURE_2D, m_TextureIds[1]);
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, m_RenderImage.pLineSize[1] / 2);
             glTexImage2D(GL_TEXTURE_2D, 0, GL_LUMINANCE_ALPHA, m_RenderImage.width >> 1,
                          m_RenderImage.height >> 1, 0, GL_LUMINANCE_ALPHA, GL_UNSIGNED_BYTE,
                          m_RenderImage.ppPlane[1]);
@@ -423,6 +600,7 @@ void VideoGLRender::OnDrawFrame() {
             //upload Y plane data
             glActiveTexture(GL_TEXTURE0);
             glBindTexture(GL_TEXTURE_2D, m_TextureIds[0]);
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, m_RenderImage.pLineSize[0]);
             glTexImage2D(GL_TEXTURE_2D, 0, GL_LUMINANCE, m_RenderImage.width,
                          m_RenderImage.height, 0, GL_LUMINANCE, GL_UNSIGNED_BYTE,
                          m_RenderImage.ppPlane[0]);
@@ -431,6 +609,7 @@ void VideoGLRender::OnDrawFrame() {
             //update U plane data
             glActiveTexture(GL_TEXTURE1);
             glBindTexture(GL_TEXTURE_2D, m_TextureIds[1]);
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, m_RenderImage.pLineSize[1]);
             glTexImage2D(GL_TEXTURE_2D, 0, GL_LUMINANCE, m_RenderImage.width >> 1,
                          m_RenderImage.height >> 1, 0, GL_LUMINANCE, GL_UNSIGNED_BYTE,
                          m_RenderImage.ppPlane[1]);
@@ -439,39 +618,90 @@ void VideoGLRender::OnDrawFrame() {
             //update V plane data
             glActiveTexture(GL_TEXTURE2);
             glBindTexture(GL_TEXTURE_2D, m_TextureIds[2]);
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, m_RenderImage.pLineSize[2]);
             glTexImage2D(GL_TEXTURE_2D, 0, GL_LUMINANCE, m_RenderImage.width >> 1,
                          m_RenderImage.height >> 1, 0, GL_LUMINANCE, GL_UNSIGNED_BYTE,
                          m_RenderImage.ppPlane[2]);
             glBindTexture(GL_TEXTURE_2D, GL_NONE);
             break;
+        case IMAGE_FORMAT_P010:
+            //upload Y plane data, 16bit 整型纹理
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, m_HDRTextureIds[0]);
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, m_RenderImage.pLineSize[0] / 2);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_R16UI, m_RenderImage.width,
+                         m_RenderImage.height, 0, GL_RED_INTEGER, GL_UNSIGNED_SHORT,
+                         m_RenderImage.ppPlane[0]);
+            glBindTexture(GL_TEXTURE_2D, GL_NONE);
+
+            //update UV plane data
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, m_HDRTextureIds[1]);
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, m_RenderImage.pLineSize[1] / 4);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RG16UI, (m_RenderImage.width + 1) >> 1,
+                         (m_RenderImage.height + 1) >> 1, 0, GL_RG_INTEGER, GL_UNSIGNED_SHORT,
+                         m_RenderImage.ppPlane[1]);
+            glBindTexture(GL_TEXTURE_2D, GL_NONE);
+            break;
+        case IMAGE_FORMAT_I010:
+            for (int i = 0; i < TEXTURE_NUM; ++i) {
+                int planeWidth = i == 0 ? m_RenderImage.width : (m_RenderImage.width + 1) >> 1;
+                int planeHeight = i == 0 ? m_RenderImage.height : (m_RenderImage.height + 1) >> 1;
+                glActiveTexture(GL_TEXTURE0 + i);
+                glBindTexture(GL_TEXTURE_2D, m_HDRTextureIds[i]);
+                glPixelStorei(GL_UNPACK_ROW_LENGTH, m_RenderImage.pLineSize[i] / 2);
+                glTexImage2D(GL_TEXTURE_2D, 0, GL_R16UI, planeWidth, planeHeight, 0,
+                             GL_RED_INTEGER, GL_UNSIGNED_SHORT, m_RenderImage.ppPlane[i]);
+                glBindTexture(GL_TEXTURE_2D, GL_NONE);
+            }
+            break;
         default:
             break;
     }
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+
+    //10bit 格式走 16bit 整型纹理程序，不经过 sws 转换
+    bool isHighBitDepth = m_RenderImage.format == IMAGE_FORMAT_P010 || m_RenderImage.format == IMAGE_FORMAT_I010;
+    GLuint programObj = isHighBitDepth ? m_HDRProgramObj : m_ProgramObj;
+    GLuint *textureIds = isHighBitDepth ? m_HDRTextureIds : m_TextureIds;
+    int colorSpace = m_ColorSpace;
+    int colorTransfer = m_ColorTransfer;
+    bool fullRange = m_FullRange;
     lock.unlock();
 
+    if(programObj == GL_NONE) return;
 
     // Use the program object
-    glUseProgram (m_ProgramObj);
+    glUseProgram (programObj);
 
     glBindVertexArray(m_VaoId);
 
-    GLUtils::setMat4(m_ProgramObj, "u_MVPMatrix", m_MVPMatrix);
+    GLUtils::setMat4(programObj, "u_MVPMatrix", m_MVPMatrix);
 
     for (int i = 0; i < TEXTURE_NUM; ++i) {
         glActiveTexture(GL_TEXTURE0 + i);
-        glBindTexture(GL_TEXTURE_2D, m_TextureIds[i]);
+        glBindTexture(GL_TEXTURE_2D, textureIds[i]);
         char samplerName[64] = {0};
         sprintf(samplerName, "s_texture%d", i);
-        GLUtils::setInt(m_ProgramObj, samplerName, i);
+        GLUtils::setInt(programObj, samplerName, i);
     }
 
     //float time = static_cast<float>(fmod(m_FrameIndex, 60) / 50);
     //GLUtils::setFloat(m_ProgramObj, "u_Time", time);
 
-    float offset = (sin(m_FrameIndex * MATH_PI / 40) + 1.0f) / 2.0f;
-    GLUtils::setFloat(m_ProgramObj, "u_Offset", offset);
-    GLUtils::setVec2(m_ProgramObj, "u_TexSize", vec2(m_RenderImage.width, m_RenderImage.height));
-    GLUtils::setInt(m_ProgramObj, "u_nImgType", m_RenderImage.format);
+    if(isHighBitDepth) {
+        //P010 有效位在高 10 位，I010 有效位在低 10 位
+        float sampleScale = m_RenderImage.format == IMAGE_FORMAT_P010 ? 1.0f / (1023 << 6) : 1.0f / 1023;
+        GLUtils::setFloat(programObj, "u_SampleScale", sampleScale);
+        GLUtils::setInt(programObj, "u_ColorSpace", colorSpace);
+        GLUtils::setInt(programObj, "u_Transfer", colorTransfer);
+        GLUtils::setInt(programObj, "u_FullRange", fullRange ? 1 : 0);
+    } else {
+        float offset = (sin(m_FrameIndex * MATH_PI / 40) + 1.0f) / 2.0f;
+        GLUtils::setFloat(programObj, "u_Offset", offset);
+        GLUtils::setVec2(programObj, "u_TexSize", vec2(m_RenderImage.width, m_RenderImage.height));
+    }
+    GLUtils::setInt(programObj, "u_nImgType", m_RenderImage.format);
 
     glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, (const void *)0);
 
@@ -27,6 +27,12 @@ public:
     virtual void Init(int videoWidth, int videoHeight, int *dstSize);
     virtual void RenderVideoFrame(NativeImage *pImage);
     virtual void UnInit();
+    virtual void SetColorInfo(int colorSpace, int transfer, bool fullRange);
+    virtual void SetDisplayOrientation(int clockwise, bool hflip);
+    virtual void GetSurfaceSize(int *size) {
+        size[0] = static_cast<int>(m_ScreenSize.x);
+        size[1] = static_cast<int>(m_ScreenSize.y);
+    }
 
     virtual void OnSurfaceCreated();
     virtual void OnSurfaceChanged(int w, int h);
@@ -49,13 +55,20 @@ private:
     static std::mutex m_Mutex;
     static VideoGLRender* s_Instance;
     GLuint m_ProgramObj = GL_NONE;
+    GLuint m_HDRProgramObj = GL_NONE;       //10bit(P010/I010) 渲染程序，16bit 整型纹理采样
     GLuint m_TextureIds[TEXTURE_NUM];
+    GLuint m_HDRTextureIds[TEXTURE_NUM];    //16bit 整型纹理只能使用 GL_NEAREST 过滤，单独创建
     GLuint m_VaoId;
     GLuint m_VboIds[3];
     NativeImage m_RenderImage;
     glm::mat4 m_MVPMatrix;
 
     int m_FrameIndex;
+    int m_ColorSpace = VIDEO_COLOR_SPACE_BT709;
+    int m_ColorTransfer = VIDEO_COLOR_TRC_SDR;
+    bool m_FullRange = false;
+    int m_DisplayRotation = 0;              //显示矩阵的顺时针旋转角度
+    bool m_DisplayHFlip = false;            //显示矩阵旋转后是否水平镜像
     vec2 m_TouchXY;
     vec2 m_ScreenSize;
 };
@@ -9,6 +9,16 @@
 #define VIDEO_RENDER_ANWINDOW           1
 #define VIDEO_RENDER_3D_VR              2
 
+//YUV 转 RGB 所用的色彩空间矩阵
+#define VIDEO_COLOR_SPACE_BT601         0
+#define VIDEO_COLOR_SPACE_BT709         1
+#define VIDEO_COLOR_SPACE_BT2020        2
+
+//传输特性（EOTF），PQ/HLG 需要色调映射到 SDR
+#define VIDEO_COLOR_TRC_SDR             0
+#define VIDEO_COLOR_TRC_PQ              1
+#define VIDEO_COLOR_TRC_HLG             2
+
 #include "ImageDef.h"
 
 class VideoRender {
@@ -25,6 +35,31 @@ public:
     virtual void RenderVideoFrame(NativeImage *pImage) = 0;
     virtual void UnInit() = 0;
 
+    /**
+     * 设置视频的色彩信息，供 GPU 端做 YUV 转换和 HDR 色调映射
+     * @param colorSpace VIDEO_COLOR_SPACE_XXX
+     * @param transfer VIDEO_COLOR_TRC_XXX
+     * @param fullRange 是否为全范围（JPEG range）
+     */
+    virtual void SetColorInfo(int colorSpace, int transfer, bool fullRange) {}
+
+    /**
+     * 设置显示方向，来自视频流的显示矩阵，需在 Init 之前调用
+     * 默认不支持，画面按编码方向显示
+     * @param clockwise 顺时针旋转角度，0/90/180/270
+     * @param hflip 旋转后是否水平镜像
+     */
+    virtual void SetDisplayOrientation(int clockwise, bool hflip) {}
+
+    /**
+     * 获取当前实际显示区域的大小，解码端据此选择降分辨率解码
+     * @param size 输出 [width, height]，未知时为 0
+     */
+    virtual void GetSurfaceSize(int *size) {
+        size[0] = 0;
+        size[1] = 0;
+    }
+
     int GetRenderType() {
         return m_RenderType;
     }
@@ -10,6 +10,10 @@
 #include <GLUtils.h>
 #include <gtc/matrix_transform.hpp>
 
+extern "C" {
+#include <libavutil/time.h>
+}
+
 GLCameraRender* GLCameraRender::s_Instance = nullptr;
 std::mutex GLCameraRender::m_Mutex;
 
@@ -109,7 +113,7 @@ static GLushort indices[] = { 0, 1, 2, 0, 2, 3 };
  * 初始化GLCameraRender实例
  */
 GLCameraRender::GLCameraRender():VideoRender(VIDEO_RENDER_OPENGL) {
-
+    m_PendingSlot = 2;
 }
 
 /**
@@ -117,8 +121,9 @@ GLCameraRender::GLCameraRender():VideoRender(VIDEO_RENDER_OPENGL) {
  * 释放渲染图像资源
  */
 GLCameraRender::~GLCameraRender() {
-    NativeImageUtil::FreeNativeImage(&m_RenderImage);
-
+    for (int i = 0; i < FRAME_SLOT_NUM; ++i) {
+        NativeImageUtil::FreeNativeImage(&m_FrameSlots[i]);
+    }
 }
 
 /**
@@ -143,28 +148,69 @@ void GLCameraRender::Init(int videoWidth, int videoHeight, int *dstSize) {
  * @brief 接收视频帧用于渲染
  * @param pImage 输入的视频帧
  *
- * 将输入的视频帧复制到内部缓冲区
- * 如果尺寸变化，重新分配缓冲区
+ * 相机线程把帧复制到自己独占的缓冲，再与交换槽互换，不会等待 GL 线程。
+ * 换出来的缓冲如果带有 FRAME_SLOT_FRESH，说明上一帧还没被渲染就被覆盖了，计为跳帧
  */
 void GLCameraRender::RenderVideoFrame(NativeImage *pImage) {
-    LOGCATE("GLCameraRender::RenderVideoFrame pImage=%p", pImage);
     if(pImage == nullptr || pImage->ppPlane[0] == nullptr)
         return;
-    std::unique_lock<std::mutex> lock(m_Mutex);
-    // 检测尺寸变化，重新分配缓冲区
-    if (pImage->width != m_RenderImage.width || pImage->height != m_RenderImage.height) {
-        if (m_RenderImage.ppPlane[0] != nullptr) {
-            NativeImageUtil::FreeNativeImage(&m_RenderImage);
+    NativeImage *pSlot = &m_FrameSlots[m_WriteSlot];
+    // 检测尺寸变化，重新分配缓冲区，写缓冲只属于相机线程
+    if (pImage->width != pSlot->width || pImage->height != pSlot->height || pImage->format != pSlot->format) {
+        if (pSlot->ppPlane[0] != nullptr) {
+            NativeImageUtil::FreeNativeImage(pSlot);
         }
-        memset(&m_RenderImage, 0, sizeof(NativeImage));
-        m_RenderImage.format = pImage->format;
-        m_RenderImage.width = pImage->width;
-        m_RenderImage.height = pImage->height;
-        NativeImageUtil::AllocNativeImage(&m_RenderImage);
+        memset(pSlot, 0, sizeof(NativeImage));
+        pSlot->format = pImage->format;
+        pSlot->width = pImage->width;
+        pSlot->height = pImage->height;
+        NativeImageUtil::AllocNativeImage(pSlot);
     }
 
-    NativeImageUtil::CopyNativeImage(pImage, &m_RenderImage);
-    //NativeImageUtil::DumpNativeImage(&m_RenderImage, "/sdcard", "camera");
+    NativeImageUtil::CopyNativeImage(pImage, pSlot);
+    //NativeImageUtil::DumpNativeImage(pSlot, "/sdcard", "camera");
+    m_SlotReadback[m_WriteSlot] = m_ReadbackEnabled;
+    if (m_ReadbackEnabled) {
+        std::unique_lock<std::mutex> lock(m_ReadbackMutex);
+        m_PendingReadbacks++;
+    }
+
+    int prev = m_PendingSlot.exchange(m_WriteSlot | FRAME_SLOT_FRESH, std::memory_order_acq_rel);
+    m_WriteSlot = prev & FRAME_SLOT_MASK;
+    m_ReceivedFrames++;
+    if (prev & FRAME_SLOT_FRESH) {
+        m_SkippedFrames++;
+        if (m_SlotReadback[m_WriteSlot]) FinishReadback();
+    }
+    LOGCATE("GLCameraRender::RenderVideoFrame pImage=%p, received=%ld, skipped=%ld", pImage, m_ReceivedFrames, m_SkippedFrames);
+}
+
+/**
+ * @brief GL 线程取最新的完整帧
+ * @return 有新帧返回true
+ *
+ * 交换槽中有新帧时，用读缓冲换出来；否则继续渲染上一帧
+ */
+bool GLCameraRender::AcquireLatestFrame() {
+    if ((m_PendingSlot.load(std::memory_order_acquire) & FRAME_SLOT_FRESH) == 0)
+        return false;
+    int prev = m_PendingSlot.exchange(m_ReadSlot, std::memory_order_acq_rel);
+    m_ReadSlot = prev & FRAME_SLOT_MASK;
+    m_RenderImage = m_FrameSlots[m_ReadSlot];
+    m_ReadbackPending = m_SlotReadback[m_ReadSlot];
+    return true;
+}
+
+void GLCameraRender::FinishReadback() {
+    std::unique_lock<std::mutex> lock(m_ReadbackMutex);
+    if (m_PendingReadbacks > 0) m_PendingReadbacks--;
+    m_ReadbackCond.notify_all();
+}
+
+bool GLCameraRender::WaitReadbackDrained(int timeoutMs) {
+    std::unique_lock<std::mutex> lock(m_ReadbackMutex);
+    return m_ReadbackCond.wait_for(lock, std::chrono::milliseconds(timeoutMs),
+                                   [this] { return m_PendingReadbacks == 0; });
 }
 
 /**
@@ -172,6 +218,7 @@ void GLCameraRender::RenderVideoFrame(NativeImage *pImage) {
  * 释放扩展图像和着色器缓冲区资源
  */
 void GLCameraRender::UnInit() {
+    LOGCATE("GLCameraRender::UnInit received=%ld, skipped=%ld", m_ReceivedFrames, m_SkippedFrames);
     NativeImageUtil::FreeNativeImage(&m_ExtImage);
 
     if(m_pFragShaderBuffer != nullptr) {
@@ -384,9 +431,16 @@ void GLCameraRender::OnDrawFrame() {
     }
 
     glClear(GL_COLOR_BUFFER_BIT);
-    if(m_ProgramObj == GL_NONE || m_RenderImage.ppPlane[0] == nullptr) return;
+    // 重绘上一帧时不再读回，每帧最多交给录制器一次
+    m_ReadbackPending = false;
+    AcquireLatestFrame();
+    if(m_ProgramObj == GL_NONE || m_RenderImage.ppPlane[0] == nullptr) {
+        if(m_ReadbackPending) FinishReadback();
+        return;
+    }
     if(m_SrcFboId == GL_NONE && CreateFrameBufferObj()) {
         LOGCATE("GLCameraRender::OnDrawFrame CreateFrameBufferObj fail");
+        if(m_ReadbackPending) FinishReadback();
         return;
     }
     LOGCATE("GLCameraRender::OnDrawFrame [w, h]=[%d, %d], format=%d", m_RenderImage.width, m_RenderImage.height, m_RenderImage.format);
@@ -395,7 +449,7 @@ void GLCameraRender::OnDrawFrame() {
     // 更新扩展纹理（如LUT滤镜纹理）
     UpdateExtTexture();
 
-    std::unique_lock<std::mutex> lock(m_Mutex);
+    int64_t fboStartTime = av_gettime_relative();
     // 第一步：渲染到 FBO（应用滤镜效果）
     glBindFramebuffer(GL_FRAMEBUFFER, m_SrcFboId);
     glViewport(0, 0, m_RenderImage.height, m_RenderImage.width); //相机的宽和高反了
@@ -535,7 +589,9 @@ void GLCameraRender::OnDrawFrame() {
     // 从FBO读取渲染结果，用于录制
     GetRenderFrameFromFBO();
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    lock.unlock();
+    // glReadPixels 会等待 GPU 完成，录制时这段时间包含了两次 FBO 绘制
+    if(m_RenderFrameCallback != nullptr && m_ReadbackPending) m_ReadbackCost.Add(av_gettime_relative() - fboStartTime);
+    if(m_ReadbackPending) FinishReadback();
 
     // 第三步：渲染到屏幕
     glViewport(0, 0, m_ScreenSize.x, m_ScreenSize.y);
@@ -675,7 +731,7 @@ bool GLCameraRender::CreateFrameBufferObj() {
  */
 void GLCameraRender::GetRenderFrameFromFBO() {
     LOGCATE("GLCameraRender::GetRenderFrameFromFBO m_RenderFrameCallback=%p", m_RenderFrameCallback);
-    if(m_RenderFrameCallback != nullptr) {
+    if(m_RenderFrameCallback != nullptr && m_ReadbackPending) {
         // 分配缓冲区并读取像素数据
         uint8_t *pBuffer = new uint8_t[m_RenderImage.width * m_RenderImage.height * 4];
         NativeImage nativeImage = m_RenderImage;
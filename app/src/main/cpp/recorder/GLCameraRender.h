@@ -17,6 +17,9 @@
 #include <vec2.hpp>
 #include <render/BaseGLRender.h>
 #include <vector>
+#include <atomic>
+#include <condition_variable>
+#include "CostCounter.h"
 using namespace glm;
 using namespace std;
 
@@ -24,6 +27,11 @@ using namespace std;
 
 #define TEXTURE_NUM 3                          // 纹理数量
 
+// 相机帧三缓冲：写线程、读线程各持有一个，剩下一个用于交换
+#define FRAME_SLOT_NUM       3
+#define FRAME_SLOT_MASK      0x3               // 交换槽中的缓冲索引
+#define FRAME_SLOT_FRESH     0x4               // 交换槽中的帧还没被读线程取走
+
 // 着色器索引定义
 #define SHADER_INDEX_ORIGIN  0                 // 原始着色器
 #define SHADER_INDEX_DMESH   1                 // 网格变形着色器
@@ -152,6 +160,28 @@ public:
      */
     void SetFragShaderStr(int index, char *pShaderStr, int strSize);
 
+    /**
+     * @brief 获取当前着色器索引
+     * @return SHADER_INDEX_ORIGIN 表示没有滤镜
+     */
+    int GetShaderIndex() { return m_ShaderIndex; }
+
+    /**
+     * @brief 设置之后送入的帧是否从FBO读回
+     * 无滤镜录制时相机帧直接送编码器，不需要 glReadPixels。只在相机线程调用，
+     * 读回模式随帧一起交给 GL 线程，切换前已送入的帧仍按原来的模式处理，不会重复编码
+     * @param enabled false 时这些帧跳过读回和渲染帧回调
+     */
+    void SetReadbackEnabled(bool enabled) { m_ReadbackEnabled = enabled; }
+
+    /**
+     * @brief 等待已送入、需要读回的帧都被 GL 线程读回或跳过
+     * 关闭读回前调用，避免最后一帧既没有读回也没有直接编码
+     * @param timeoutMs 最长等待时间，GL 线程不再绘制时不会一直阻塞相机线程
+     * @return false 表示超时
+     */
+    bool WaitReadbackDrained(int timeoutMs);
+
 private:
     /**
      * @brief 私有构造函数（单例模式）
@@ -181,8 +211,19 @@ private:
      */
     void UpdateExtTexture();
 
+    /**
+     * @brief GL 线程取最新的完整帧
+     * @return 有新帧返回true，否则继续使用上一帧
+     */
+    bool AcquireLatestFrame();
+
+    /**
+     * @brief 一帧需要读回的帧已处理完（读回或被跳过），唤醒 WaitReadbackDrained
+     */
+    void FinishReadback();
+
 private:
-    static std::mutex m_Mutex;                      // 单例保护锁
+    static std::mutex m_Mutex;                      // 单例保护锁，也保护 LUT 图像的更新
     static GLCameraRender* s_Instance;              // 单例实例
 
     GLuint m_ProgramObj = GL_NONE;                  // 着色器程序对象
@@ -195,7 +236,13 @@ private:
     GLuint m_DstFboTextureId = GL_NONE;            // 目标FBO纹理ID
     GLuint m_DstFboId = GL_NONE;                   // 目标FBO ID
 
-    NativeImage m_RenderImage;                      // 渲染图像数据缓冲
+    NativeImage m_FrameSlots[FRAME_SLOT_NUM];       // 相机帧三缓冲
+    int m_WriteSlot = 0;                           // 相机线程独占的缓冲索引
+    int m_ReadSlot = 1;                            // GL 线程独占的缓冲索引
+    std::atomic<int> m_PendingSlot;                // 交换槽：缓冲索引 | FRAME_SLOT_FRESH
+    long m_ReceivedFrames = 0;                     // 相机线程收到的帧数
+    long m_SkippedFrames = 0;                      // 没被渲染就被新帧覆盖的帧数
+    NativeImage m_RenderImage;                      // GL 线程当前渲染的帧，指向 m_FrameSlots[m_ReadSlot]，不持有内存
     glm::mat4 m_MVPMatrix;                         // MVP变换矩阵（模型-视图-投影）
     TransformMatrix m_transformMatrix;              // 变换矩阵
 
@@ -214,6 +261,13 @@ private:
     GLuint m_ExtTextureId = GL_NONE;               // 外部纹理ID
     int m_ShaderIndex = 0;                         // 当前着色器索引
     mutex m_ShaderMutex;                           // 着色器互斥锁，保护着色器切换
+    bool m_ReadbackEnabled = true;                 // 相机线程：之后送入的帧是否读回交给录制器
+    bool m_SlotReadback[FRAME_SLOT_NUM] = {true, true, true}; // 各缓冲中的帧是否需要读回，随缓冲交换
+    bool m_ReadbackPending = false;                // GL 线程：本次取到的新帧需要读回
+    int m_PendingReadbacks = 0;                    // 已送入还没读回或跳过的帧数
+    mutex m_ReadbackMutex;                         // 保护 m_PendingReadbacks
+    condition_variable m_ReadbackCond;             // m_PendingReadbacks 减少时通知
+    CostCounter m_ReadbackCost{"GLCameraRender fbo+readback"};  // 两次 FBO 绘制和 glReadPixels 的耗时
 
 };
 
@@ -126,6 +126,22 @@ int MediaRecorder::OnFrame2Encode(AudioFrame *inputFrame) {
     return 0;
 }
 
+/**
+ * @brief 将音频帧直接加入编码队列
+ * @param pFrame 音频帧
+ * @return 0表示成功
+ *
+ * 接管帧的所有权，不拷贝数据，编码完成删除帧时由其释放回调归还缓冲
+ */
+int MediaRecorder::PushFrame2Encode(AudioFrame *pFrame) {
+    if(m_Exit) {
+        delete pFrame;
+        return 0;
+    }
+    m_AudioFrameQueue.Push(pFrame);
+    return 0;
+}
+
 /**
  * @brief 将视频帧添加到编码队列
  * @param inputFrame 输入的视频帧
@@ -196,6 +212,7 @@ int MediaRecorder::StopRecord() {
         int ret = av_write_trailer(m_FormatCtx);
         LOGCATE("MediaRecorder::StopRecord while av_write_trailer %s",
                 av_err2str(ret));
+        m_EncodeStats.Report();
 
         /* 关闭每个编解码器 */
         if (m_EnableVideo)
@@ -298,8 +315,11 @@ void MediaRecorder::AddStream(AVOutputStream *ost, AVFormatContext *oc, AVCodec
     AVCodecContext *c;
     int i;
 
-    /* find the encoder */
-    *codec = avcodec_find_encoder(codec_id);
+    /* find the encoder，视频按编码配置查找（H.264 优先 libx264） */
+    if (avcodec_get_type(codec_id) == AVMEDIA_TYPE_VIDEO)
+        *codec = m_EncoderConfig.FindEncoder(oc->oformat);
+    else
+        *codec = avcodec_find_encoder(codec_id);
     if (!(*codec)) {
         LOGCATE("MediaRecorder::AddStream Could not find encoder for '%s'",
                 avcodec_get_name(codec_id));
@@ -334,8 +354,7 @@ void MediaRecorder::AddStream(AVOutputStream *ost, AVFormatContext *oc, AVCodec
         case AVMEDIA_TYPE_VIDEO:
             LOGCATE("MediaRecorder::AddStream AVMEDIA_TYPE_VIDEO AVCodecID=%d", codec_id);
 
-            c->codec_id = codec_id;
-            c->bit_rate = m_RecorderParam.videoBitRate;
+            c->codec_id = (*codec)->id;
             /* Resolution must be a multiple of two. */
             c->width    = m_RecorderParam.frameWidth;
             c->height   = m_RecorderParam.frameHeight;
@@ -346,7 +365,8 @@ void MediaRecorder::AddStream(AVOutputStream *ost, AVFormatContext *oc, AVCodec
             ost->m_pStream->time_base = (AVRational){ 1, m_RecorderParam.fps };
             c->time_base       = ost->m_pStream->time_base;
 
-            c->gop_size      = 12; /* emit one intra frame every twelve frames at most */
+            /* 码率控制、关键帧间隔、B 帧、线程等由编码配置设置 */
+            m_EncoderConfig.Apply(c, m_RecorderParam.fps, m_RecorderParam.videoBitRate);
             c->pix_fmt       = AV_PIX_FMT_YUV420P;
             if (c->codec_id == AV_CODEC_ID_MPEG2VIDEO) {
                 /* just for testing, we also add B-frames */
@@ -604,6 +624,15 @@ int MediaRecorder::OpenVideo(AVFormatContext *oc, AVCodec *codec, AVOutputStream
         LOGCATE("MediaRecorder::OpenVideo Could not copy the stream parameters");
         return -1;
     }
+
+    m_EncodeStats.Start(m_EncoderConfig.ToString(), m_RecorderParam.fps);
+
+    /* 按传感器方向编码时，旋转和镜像写入显示矩阵 */
+    ret = DisplayMatrix::WriteToStream(ost->m_pStream, m_DisplayDegree, m_DisplayMirror);
+    if (ret < 0) {
+        LOGCATE("MediaRecorder::OpenVideo Could not set the display matrix");
+        return -1;
+    }
     return 0;
 }
 
@@ -614,6 +643,7 @@ int MediaRecorder::EncodeVideoFrame(AVOutputStream *ost) {
     AVCodecContext *c;
     AVFrame *frame;
     AVPacket pkt = { 0 };
+    int64_t encodeStart = 0;
 
     c = ost->m_pCodecCtx;
 
@@ -665,7 +695,18 @@ int MediaRecorder::EncodeVideoFrame(AVOutputStream *ost) {
             goto EXIT;
         }
 
-        if (srcPixFmt != AV_PIX_FMT_YUV420P) {
+        int dstWidth = 0, dstHeight = 0;
+        if (videoFrame != nullptr)
+            YuvTransform::GetOutputSize(videoFrame->width, videoFrame->height, m_TransformDegree, &dstWidth, &dstHeight);
+        if (videoFrame != nullptr && videoFrame->format != IMAGE_FORMAT_RGBA && dstWidth == c->width && dstHeight == c->height) {
+            // 相机 YUV 帧直接旋转、镜像并转换到编码帧
+            int64_t startTime = av_gettime_relative();
+            if (YuvTransform::ToI420(videoFrame, ost->m_pFrame->data, ost->m_pFrame->linesize, m_TransformDegree, m_TransformMirror) == 0) {
+                m_YuvCost.Add(av_gettime_relative() - startTime);
+            } else {
+                LOGCATE("MediaRecorder::EncodeVideoFrame YuvTransform fail format=%d", videoFrame->format);
+            }
+        } else if (srcPixFmt != AV_PIX_FMT_YUV420P) {
             /* as we only generate a YUV420P picture, we must convert it
              * to the codec pixel format if needed */
             if (!ost->m_pSwsCtx) {
@@ -680,9 +721,11 @@ int MediaRecorder::EncodeVideoFrame(AVOutputStream *ost) {
                     goto EXIT;
                 }
             }
+            int64_t startTime = av_gettime_relative();
             sws_scale(ost->m_pSwsCtx, (const uint8_t * const *) frame->data,
                       frame->linesize, 0, c->height, ost->m_pFrame->data,
                       ost->m_pFrame->linesize);
+            m_SwsCost.Add(av_gettime_relative() - startTime);
         }
         ost->m_pFrame->pts = ost->m_NextPts++;
         frame = ost->m_pFrame;
@@ -703,6 +746,7 @@ int MediaRecorder::EncodeVideoFrame(AVOutputStream *ost) {
 //    }
 
     /* encode the image */
+    encodeStart = av_gettime_relative();
     ret = avcodec_send_frame(c, frame);
     if(ret == AVERROR_EOF) {
         result = 1;
@@ -724,6 +768,7 @@ int MediaRecorder::EncodeVideoFrame(AVOutputStream *ost) {
             goto EXIT;
         }
         LOGCATE("MediaRecorder::EncodeVideoFrame video pkt pts=%ld, size=%d", pkt.pts, pkt.size);
+        m_EncodeStats.AddPacket(pkt.size);
         int result = WritePacket(m_FormatCtx, &c->time_base, ost->m_pStream, &pkt);
         if (result < 0) {
             LOGCATE("MediaRecorder::EncodeVideoFrame video Error while writing audio frame: %s",
@@ -734,6 +779,9 @@ int MediaRecorder::EncodeVideoFrame(AVOutputStream *ost) {
     }
 
 EXIT:
+    // 刷新编码器时不计入帧数
+    if (frame != nullptr && encodeStart > 0)
+        m_EncodeStats.AddFrame(av_gettime_relative() - encodeStart);
     NativeImageUtil::FreeNativeImage(videoFrame);
     if(videoFrame) delete videoFrame;
     return result;
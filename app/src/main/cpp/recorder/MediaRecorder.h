@@ -19,6 +19,10 @@
 #include <render/audio/AudioRender.h>
 #include "ThreadSafeQueue.h"
 #include "thread"
+#include "YuvTransform.h"
+#include "CostCounter.h"
+#include "DisplayMatrix.h"
+#include "EncoderConfig.h"
 
 extern "C" {
 #include <libavutil/avassert.h>
@@ -29,6 +33,7 @@ extern "C" {
 #include <libavformat/avformat.h>
 #include <libswscale/swscale.h>
 #include <libswresample/swresample.h>
+#include <libavutil/time.h>
 }
 
 using namespace std;
@@ -133,6 +138,42 @@ public:
      */
     int OnFrame2Encode(AudioFrame *inputFrame);
 
+    /**
+     * @brief 把音频帧直接加入音频队列，接管其所有权，不拷贝数据
+     * @param pFrame 堆上分配的音频帧，调用后不可再使用
+     * @return 0表示成功，负数表示失败
+     */
+    int PushFrame2Encode(AudioFrame *pFrame);
+
+    /**
+     * @brief 设置相机 YUV 帧的旋转和镜像，无滤镜时相机帧直接在编码线程转为 I420
+     * @param degree 旋转角度
+     * @param mirror 镜像方式
+     */
+    void SetFrameTransform(int degree, int mirror) {
+        m_TransformDegree = degree;
+        m_TransformMirror = mirror;
+    }
+
+    /**
+     * @brief 设置写入视频流显示矩阵的旋转和镜像，需在 StartRecord 之前调用
+     * 按传感器方向编码时，旋转由播放端根据显示矩阵完成
+     * @param degree 旋转角度
+     * @param mirror 镜像方式
+     */
+    void SetDisplayTransform(int degree, int mirror) {
+        m_DisplayDegree = degree;
+        m_DisplayMirror = mirror;
+    }
+
+    /**
+     * @brief 设置视频编码配置，需在 StartRecord 之前调用，不设置时使用默认配置
+     * @param config 编码配置
+     */
+    void SetEncoderConfig(const EncoderConfig &config) {
+        m_EncoderConfig = config;
+    }
+
     /**
      * @brief 添加视频数据到视频队列
      * @param inputFrame 输入的视频帧数据
@@ -272,6 +313,14 @@ private:
     int              m_EnableVideo = 0;            // 视频启用标志，1表示启用
     int              m_EnableAudio = 0;            // 音频启用标志，1表示启用
     volatile bool    m_Exit = false;               // 退出标志，用于通知线程退出
+    volatile int     m_TransformDegree = 0;        // 相机 YUV 帧的旋转角度
+    volatile int     m_TransformMirror = 0;        // 相机 YUV 帧的镜像方式
+    int              m_DisplayDegree = 0;          // 显示矩阵的旋转角度
+    int              m_DisplayMirror = 0;          // 显示矩阵的镜像方式
+    EncoderConfig    m_EncoderConfig;              // 视频编码配置
+    EncodeStats      m_EncodeStats{"MediaRecorder encode"};  // 视频编码帧率和码率统计
+    CostCounter      m_YuvCost{"MediaRecorder yuv"};  // YuvTransform 转换耗时
+    CostCounter      m_SwsCost{"MediaRecorder sws"};  // sws_scale 转换耗时
 
     // 音频编码线程
     thread          *m_pAudioThread = nullptr;
@@ -9,6 +9,7 @@
 #include <LogUtil.h>
 #include <ImageDef.h>
 #include "MediaRecorderContext.h"
+#include "YuvTransform.h"
 
 jfieldID MediaRecorderContext::s_ContextHandle = 0L;
 
@@ -27,6 +28,12 @@ MediaRecorderContext::MediaRecorderContext() {
 MediaRecorderContext::~MediaRecorderContext()
 {
 	GLCameraRender::ReleaseInstance();
+	for (int i = 0; i < BUFFER_TYPE_NUM; ++i) {
+		if(m_pBufferPools[i] != nullptr) {
+			delete m_pBufferPools[i];
+			m_pBufferPools[i] = nullptr;
+		}
+	}
 }
 
 /**
@@ -164,11 +171,26 @@ MediaRecorderContext::StartRecord(int recorderType, const char *outUrl, int fram
                                   int fps) {
 	LOGCATE("MediaRecorderContext::StartRecord recorderType=%d, outUrl=%s, [w,h]=[%d,%d], videoBitRate=%ld, fps=%d", recorderType, outUrl, frameWidth, frameHeight, videoBitRate, fps);
 	std::unique_lock<std::mutex> lock(m_mutex);
+	// 按传感器方向录制时编码尺寸就是相机帧尺寸，否则交换宽高，录制旋转后的画面
+	bool byMetadata = m_RotationMetadataEnabled && recorderType != RECORDER_TYPE_SINGLE_AUDIO
+			&& GLCameraRender::GetInstance()->GetShaderIndex() == SHADER_INDEX_ORIGIN;
+	int encodeWidth = byMetadata ? frameWidth : frameHeight;
+	int encodeHeight = byMetadata ? frameHeight : frameWidth;
+	int frameDegree = byMetadata ? 0 : m_transformMatrix.degree;
+	int frameMirror = byMetadata ? 0 : m_transformMatrix.mirror;
+	int displayDegree = byMetadata ? m_transformMatrix.degree : 0;
+	int displayMirror = byMetadata ? m_transformMatrix.mirror : 0;
 	switch (recorderType) {
 		case RECORDER_TYPE_SINGLE_VIDEO:  // 单视频录制
 			if(m_pVideoRecorder == nullptr) {
-				m_pVideoRecorder = new SingleVideoRecorder(outUrl, frameHeight, frameWidth, videoBitRate, fps);
+				m_pVideoRecorder = new SingleVideoRecorder(outUrl, encodeWidth, encodeHeight, videoBitRate, fps);
+				m_pVideoRecorder->SetFrameTransform(frameDegree, frameMirror);
+				m_pVideoRecorder->SetDisplayTransform(displayDegree, displayMirror);
+				m_pVideoRecorder->SetEncoderConfig(m_EncoderConfig);
 				m_pVideoRecorder->StartRecord();
+				m_EncodeWidth = encodeWidth;
+				m_EncodeHeight = encodeHeight;
+				m_RotationByMetadata = byMetadata;
 			}
 			break;
 		case RECORDER_TYPE_SINGLE_AUDIO:  // 单音频录制
@@ -180,15 +202,21 @@ MediaRecorderContext::StartRecord(int recorderType, const char *outUrl, int fram
 		case RECORDER_TYPE_AV:  // 音视频同时录制
 			if(m_pAVRecorder == nullptr) {
 				RecorderParam param = {0};
-				param.frameWidth      = frameHeight;
-				param.frameHeight     = frameWidth;
+				param.frameWidth      = encodeWidth;
+				param.frameHeight     = encodeHeight;
 				param.videoBitRate    = videoBitRate;
 				param.fps             = fps;
 				param.audioSampleRate = DEFAULT_SAMPLE_RATE;
 				param.channelLayout   = AV_CH_LAYOUT_STEREO;
 				param.sampleFormat    = AV_SAMPLE_FMT_S16;
 				m_pAVRecorder = new MediaRecorder(outUrl, &param);
+				m_pAVRecorder->SetFrameTransform(frameDegree, frameMirror);
+				m_pAVRecorder->SetDisplayTransform(displayDegree, displayMirror);
+				m_pAVRecorder->SetEncoderConfig(m_EncoderConfig);
 				m_pAVRecorder->StartRecord();
+				m_EncodeWidth = param.frameWidth;
+				m_EncodeHeight = param.frameHeight;
+				m_RotationByMetadata = byMetadata;
 			}
 			break;
 		default:
@@ -207,6 +235,9 @@ MediaRecorderContext::StartRecord(int recorderType, const char *outUrl, int fram
  */
 int MediaRecorderContext::StopRecord() {
 	std::unique_lock<std::mutex> lock(m_mutex);
+	m_EncodeWidth = 0;
+	m_EncodeHeight = 0;
+	m_RotationByMetadata = false;
 	// 停止单视频录制
 	if(m_pVideoRecorder != nullptr) {
         m_pVideoRecorder->StopRecord();
@@ -230,6 +261,30 @@ int MediaRecorderContext::StopRecord() {
     return 0;
 }
 
+/**
+ * @brief 设置是否按传感器方向录制
+ * @param enable 是否开启
+ *
+ * 下一次开始录制时生效
+ */
+void MediaRecorderContext::SetRotationMetadataEnabled(bool enable) {
+	LOGCATE("MediaRecorderContext::SetRotationMetadataEnabled enable=%d", enable);
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_RotationMetadataEnabled = enable;
+}
+
+/**
+ * @brief 设置视频编码配置
+ * @param config 编码配置
+ *
+ * 下一次开始录制时生效
+ */
+void MediaRecorderContext::SetEncoderConfig(const EncoderConfig &config) {
+	LOGCATE("MediaRecorderContext::SetEncoderConfig %s", config.ToString().c_str());
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_EncoderConfig = config;
+}
+
 /**
  * @brief 接收音频数据
  * @param pData 音频数据指针
@@ -289,15 +344,160 @@ void MediaRecorderContext::OnPreviewFrame(int format, uint8_t *pBuffer, int widt
 			break;
 	}
 
-//	std::unique_lock<std::mutex> lock(m_mutex);
-//	if(m_pVideoRecorder!= nullptr) {
-//        m_pVideoRecorder->OnFrame2Encode(&nativeImage);
-//    }
-//	lock.unlock();
-
     //NativeImageUtil::DumpNativeImage(&nativeImage, "/sdcard", "camera");
+	// 编码尺寸和方向由 StartRecord/StopRecord/SetTransformMatrix 在其他线程修改，在锁内取快照
+	int encodeWidth, encodeHeight, degree;
+	bool rotationByMetadata;
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		encodeWidth = m_EncodeWidth;
+		encodeHeight = m_EncodeHeight;
+		rotationByMetadata = m_RotationByMetadata;
+		degree = m_transformMatrix.degree;
+	}
+
+	// 没有滤镜且旋转后尺寸与编码尺寸一致时，相机帧直接交给录制器，由编码线程在 CPU 上旋转转换，
+	// GL 只负责预览，跳过 FBO 读回。按传感器方向录制时不旋转，录制过程中切换的滤镜只作用于预览
+	bool directEncode = false;
+	if(format != IMAGE_FORMAT_RGBA && encodeWidth > 0
+	   && (rotationByMetadata || GLCameraRender::GetInstance()->GetShaderIndex() == SHADER_INDEX_ORIGIN)) {
+		int dstWidth = 0, dstHeight = 0;
+		YuvTransform::GetOutputSize(width, height, rotationByMetadata ? 0 : degree, &dstWidth, &dstHeight);
+		directEncode = dstWidth == encodeWidth && dstHeight == encodeHeight;
+	}
+
+	// 只在模式变化（切换滤镜、开始或停止录制）时切换读回。切到直接编码前先等已送入的帧读回，
+	// 否则它们既不读回也不直接编码；切回读回时之前的帧没有读回标记，不会重复编码
+	if(directEncode != m_DirectEncode) {
+		LOGCATE("MediaRecorderContext::OnPreviewFrame directEncode %d -> %d", m_DirectEncode, directEncode);
+		if(directEncode && !GLCameraRender::GetInstance()->WaitReadbackDrained(READBACK_DRAIN_TIMEOUT_MS)) {
+			LOGCATE("MediaRecorderContext::OnPreviewFrame wait readback timeout");
+		}
+		GLCameraRender::GetInstance()->SetReadbackEnabled(!directEncode);
+		m_DirectEncode = directEncode;
+	}
+
     // 传递给渲染器
     GLCameraRender::GetInstance()->RenderVideoFrame(&nativeImage);
+
+	if(directEncode) {
+		std::unique_lock<std::mutex> lock(m_mutex);
+		if(m_pVideoRecorder != nullptr)
+			m_pVideoRecorder->OnFrame2Encode(&nativeImage);
+		if(m_pAVRecorder != nullptr)
+			m_pAVRecorder->OnFrame2Encode(&nativeImage);
+	}
+}
+
+/**
+ * @brief 创建直接缓冲池
+ * @param bufferType 缓冲池类型
+ * @param count 缓冲块数量
+ * @param capacity 每块缓冲的大小
+ * @return 缓冲池指针
+ *
+ * 同类型的缓冲池已存在且规格相同时直接复用；规格不同时只有全部缓冲都已归还才重建，
+ * 避免 Java 或编码队列还持有旧缓冲
+ */
+DirectBufferPool *MediaRecorderContext::CreateBufferPool(int bufferType, int count, int capacity) {
+	LOGCATE("MediaRecorderContext::CreateBufferPool bufferType=%d, count=%d, capacity=%d", bufferType, count, capacity);
+	if(bufferType < 0 || bufferType >= BUFFER_TYPE_NUM || count <= 0 || capacity <= 0) return nullptr;
+	std::unique_lock<std::mutex> lock(m_mutex);
+	DirectBufferPool *pool = m_pBufferPools[bufferType];
+	if(pool != nullptr) {
+		if(pool->GetCount() == count && pool->GetCapacity() == capacity) return pool;
+		if(pool->GetFreeCount() != pool->GetCount()) {
+			LOGCATE("MediaRecorderContext::CreateBufferPool buffers still in use, bufferType=%d", bufferType);
+			return nullptr;
+		}
+		delete pool;
+	}
+	m_pBufferPools[bufferType] = new DirectBufferPool(count, capacity);
+	return m_pBufferPools[bufferType];
+}
+
+/**
+ * @brief 借出一块空闲缓冲
+ * @param bufferType 缓冲池类型
+ * @return 缓冲索引，没有空闲缓冲时返回 -1，由 Java 丢弃这一帧
+ */
+int MediaRecorderContext::AcquireBuffer(int bufferType) {
+	if(bufferType < 0 || bufferType >= BUFFER_TYPE_NUM) return -1;
+	std::unique_lock<std::mutex> lock(m_mutex);
+	DirectBufferPool *pool = m_pBufferPools[bufferType];
+	return pool != nullptr ? pool->Acquire() : -1;
+}
+
+/**
+ * @brief 归还 Java 借出但没有提交的缓冲
+ * @param bufferType 缓冲池类型
+ * @param pData 缓冲地址
+ */
+void MediaRecorderContext::ReleaseBuffer(int bufferType, uint8_t *pData) {
+	if(bufferType < 0 || bufferType >= BUFFER_TYPE_NUM) return;
+	std::unique_lock<std::mutex> lock(m_mutex);
+	DirectBufferPool *pool = m_pBufferPools[bufferType];
+	if(pool != nullptr) pool->Release(pool->IndexOf(pData));
+}
+
+/**
+ * @brief 接收共享缓冲中的音频数据
+ * @param pData 缓冲地址
+ * @param size 数据大小
+ *
+ * 音频帧直接引用共享缓冲，交给录制器的编码队列，编码完成删除帧时归还缓冲。
+ * 没有录制器接收时立即归还
+ */
+void MediaRecorderContext::OnAudioBuffer(uint8_t *pData, int size) {
+	LOGCATE("MediaRecorderContext::OnAudioBuffer pData=%p, dataSize=%d", pData, size);
+	std::unique_lock<std::mutex> lock(m_mutex);
+	DirectBufferPool *pool = m_pBufferPools[BUFFER_TYPE_AUDIO];
+	int index = pool != nullptr ? pool->IndexOf(pData) : -1;
+	if(index < 0 || pool->Submit(index) != 0) {
+		LOGCATE("MediaRecorderContext::OnAudioBuffer invalid buffer, pData=%p, index=%d", pData, index);
+		return;
+	}
+	if(size <= 0 || size > pool->GetCapacity()) {
+		pool->Release(index);
+		return;
+	}
+
+	AudioFrame *pFrame = new AudioFrame(pData, size, false);
+	pFrame->releaseFunc = DirectBufferPool::ReleaseBuffer;
+	pFrame->releaseOpaque = pool;
+
+	if(m_pAudioRecorder != nullptr)
+		m_pAudioRecorder->PushFrame2Encode(pFrame);
+	else if(m_pAVRecorder != nullptr)
+		m_pAVRecorder->PushFrame2Encode(pFrame);
+	else
+		delete pFrame;
+}
+
+/**
+ * @brief 接收共享缓冲中的预览帧
+ * @param format 图像格式
+ * @param pBuffer 缓冲地址
+ * @param width 图像宽度
+ * @param height 图像高度
+ *
+ * 渲染器在 RenderVideoFrame 内取走数据，返回后即可归还缓冲
+ */
+void MediaRecorderContext::OnPreviewBuffer(int format, uint8_t *pBuffer, int width, int height) {
+	DirectBufferPool *pool = nullptr;
+	int index = -1;
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		pool = m_pBufferPools[BUFFER_TYPE_VIDEO];
+		if(pool != nullptr) index = pool->IndexOf(pBuffer);
+	}
+	if(index < 0 || pool->Submit(index) != 0) {
+		LOGCATE("MediaRecorderContext::OnPreviewBuffer invalid buffer, pBuffer=%p, index=%d", pBuffer, index);
+		return;
+	}
+
+	OnPreviewFrame(format, pBuffer, width, height);
+	pool->Release(index);
 }
 
 /**
@@ -313,6 +513,8 @@ void MediaRecorderContext::OnPreviewFrame(int format, uint8_t *pBuffer, int widt
  */
 void MediaRecorderContext::SetTransformMatrix(float translateX, float translateY, float scaleX, float scaleY, int degree, int mirror)
 {
+	// 相机线程在 OnPreviewFrame 中读取 m_transformMatrix，修改需要加锁
+	std::unique_lock<std::mutex> lock(m_mutex);
 	m_transformMatrix.translateX = translateX;
 	m_transformMatrix.translateY = translateY;
 	m_transformMatrix.scaleX = scaleX;
@@ -320,6 +522,16 @@ void MediaRecorderContext::SetTransformMatrix(float translateX, float translateY
 	m_transformMatrix.degree = degree;
 	m_transformMatrix.mirror = mirror;
 	GLCameraRender::GetInstance()->UpdateMVPMatrix(&m_transformMatrix);
+
+	// 显示矩阵在开始录制时已写入流头，录制过程中不能再修改
+	if(m_RotationByMetadata) {
+		LOGCATE("MediaRecorderContext::SetTransformMatrix rotation is fixed in display matrix while recording");
+		return;
+	}
+	if(m_pVideoRecorder != nullptr)
+		m_pVideoRecorder->SetFrameTransform(degree, mirror);
+	if(m_pAVRecorder != nullptr)
+		m_pAVRecorder->SetFrameTransform(degree, mirror);
 }
 
 /**
@@ -16,11 +16,18 @@
 #include "GLCameraRender.h"
 #include "SingleAudioRecorder.h"
 #include "MediaRecorder.h"
+#include "DirectBufferPool.h"
 
 #define RECORDER_TYPE_SINGLE_VIDEO  0 // 仅录制视频
 #define RECORDER_TYPE_SINGLE_AUDIO  1 // 仅录制音频
 #define RECORDER_TYPE_AV            2 // 同时录制音频和视频，打包成 MP4 文件
 
+#define BUFFER_TYPE_VIDEO           0 // 相机预览帧缓冲池
+#define BUFFER_TYPE_AUDIO           1 // 麦克风 PCM 缓冲池
+#define BUFFER_TYPE_NUM             2
+
+#define READBACK_DRAIN_TIMEOUT_MS   100 // 切换到直接编码前等待 GL 线程读回已送入帧的最长时间
+
 /**
  * @brief 媒体录制器上下文类
  *
@@ -101,6 +108,20 @@ public:
 	 */
     int StartRecord(int recorderType, const char* outUrl, int frameWidth, int frameHeight, long videoBitRate, int fps);
 
+	/**
+	 * @brief 设置是否按传感器方向录制，旋转写入显示矩阵
+	 * 开启后，开始录制时没有滤镜的视频按相机原始方向编码，不交换宽高，也不逐帧旋转像素，
+	 * 旋转和镜像写入视频流的显示矩阵，由播放端旋转显示。有滤镜时仍走 GL 旋转后读回的路径
+	 * @param enable 是否开启
+	 */
+	void SetRotationMetadataEnabled(bool enable);
+
+	/**
+	 * @brief 设置视频编码配置，下一次开始录制时生效
+	 * @param config 编码配置
+	 */
+	void SetEncoderConfig(const EncoderConfig &config);
+
 	/**
 	 * @brief 处理音频数据
 	 * @param pData 音频数据指针
@@ -117,6 +138,45 @@ public:
 	 */
 	void OnPreviewFrame(int format, uint8_t *pBuffer, int width, int height);
 
+	/**
+	 * @brief 创建与 Java 共享的直接缓冲池
+	 * @param bufferType 缓冲池类型（BUFFER_TYPE_VIDEO/BUFFER_TYPE_AUDIO）
+	 * @param count 缓冲块数量
+	 * @param capacity 每块缓冲的大小
+	 * @return 缓冲池指针，失败返回 nullptr
+	 */
+	DirectBufferPool *CreateBufferPool(int bufferType, int count, int capacity);
+
+	/**
+	 * @brief 借出一块空闲缓冲给 Java 填充
+	 * @param bufferType 缓冲池类型
+	 * @return 缓冲索引，没有空闲缓冲返回 -1
+	 */
+	int AcquireBuffer(int bufferType);
+
+	/**
+	 * @brief 归还一块未提交的缓冲
+	 * @param bufferType 缓冲池类型
+	 * @param pData 缓冲地址
+	 */
+	void ReleaseBuffer(int bufferType, uint8_t *pData);
+
+	/**
+	 * @brief 处理放在共享缓冲里的音频数据，不拷贝，编码完成后归还缓冲
+	 * @param pData 缓冲地址
+	 * @param size 数据大小
+	 */
+	void OnAudioBuffer(uint8_t *pData, int size);
+
+	/**
+	 * @brief 处理放在共享缓冲里的预览帧，渲染器取走数据后归还缓冲
+	 * @param format 图像格式
+	 * @param pBuffer 缓冲地址
+	 * @param width 图像宽度
+	 * @param height 图像高度
+	 */
+	void OnPreviewBuffer(int format, uint8_t *pBuffer, int width, int height);
+
 	/**
 	 * @brief 停止录制
 	 * @return 0表示成功，负数表示失败
@@ -176,6 +236,13 @@ private:
 	SingleAudioRecorder *m_pAudioRecorder = nullptr;  // 单独音频录制器
 	MediaRecorder       *m_pAVRecorder    = nullptr;  // 音视频录制器
 	mutex m_mutex;                              // 互斥锁，保护共享数据
+	DirectBufferPool *m_pBufferPools[BUFFER_TYPE_NUM] = {nullptr}; // 与 Java 共享的直接缓冲池
+	int m_EncodeWidth = 0;                      // 录制中的视频编码宽度，未录制视频时为0
+	int m_EncodeHeight = 0;                     // 录制中的视频编码高度
+	bool m_RotationMetadataEnabled = false;     // 是否允许按传感器方向录制
+	bool m_RotationByMetadata = false;          // 当前录制是否按传感器方向编码，旋转写入显示矩阵
+	bool m_DirectEncode = false;                // 相机线程：当前是否跳过 GL 读回、直接编码相机帧
+	EncoderConfig m_EncoderConfig;              // 视频编码配置
 
 };
 
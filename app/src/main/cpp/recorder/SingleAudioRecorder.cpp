@@ -149,6 +149,22 @@ int SingleAudioRecorder::OnFrame2Encode(AudioFrame *inputFrame) {
     return 0;
 }
 
+/**
+ * @brief 接收音频帧的所有权
+ * @param pFrame 音频帧
+ * @return 0表示成功
+ *
+ * 数据来自共享缓冲池时不再拷贝，帧编码完成被删除时归还缓冲
+ */
+int SingleAudioRecorder::PushFrame2Encode(AudioFrame *pFrame) {
+    if(m_exit) {
+        delete pFrame;
+        return 0;
+    }
+    m_frameQueue.Push(pFrame);
+    return 0;
+}
+
 /**
  * @brief 停止音频录制
  * @return 0表示成功
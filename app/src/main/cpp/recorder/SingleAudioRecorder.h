@@ -67,6 +67,14 @@ public:
      */
     int OnFrame2Encode(AudioFrame *inputFrame);
 
+    /**
+     * @brief 接收音频帧的所有权
+     * 不拷贝数据，直接加入编码队列，编码完成后由 AudioFrame 析构归还数据
+     * @param pFrame 堆上分配的音频帧，调用后不可再使用
+     * @return 0表示成功，负数表示失败
+     */
+    int PushFrame2Encode(AudioFrame *pFrame);
+
     /**
      * @brief 停止录制
      * 停止编码线程并写入文件尾
@@ -45,7 +45,7 @@ SingleVideoRecorder::~SingleVideoRecorder() {
  * 1. 分配输出格式上下文
  * 2. 打开输出文件
  * 3. 创建视频流
- * 4. 查找并配置MPEG4编码器
+ * 4. 按编码配置查找并配置编码器（H.264 优先 libx264）
  * 5. 启动编码线程
  */
 int SingleVideoRecorder::StartRecord() {
@@ -74,8 +74,8 @@ int SingleVideoRecorder::StartRecord() {
             break;
         }
 
-        // 查找MPEG4编码器
-        m_pCodec = avcodec_find_encoder(AV_CODEC_ID_MPEG4);
+        // 按编码配置查找编码器
+        m_pCodec = m_encoderConfig.FindEncoder(m_pFormatCtx->oformat);
         if (m_pCodec == nullptr) {
             result = -1;
             LOGCATE("SingleVideoRecorder::StartRecord avcodec_find_encoder fail. ret=%d", result);
@@ -91,23 +91,35 @@ int SingleVideoRecorder::StartRecord() {
         m_pCodecCtx->height = m_frameHeight;
         m_pCodecCtx->time_base.num = 1;
         m_pCodecCtx->time_base.den = m_frameRate;
-        m_pCodecCtx->bit_rate = m_bitRate;
-        m_pCodecCtx->gop_size = 15;  // 关键帧间隔
+        // 码率控制、关键帧间隔、B 帧、线程等由编码配置设置
+        m_encoderConfig.Apply(m_pCodecCtx, m_frameRate, m_bitRate);
+        // MP4 等容器需要单独的 SPS/PPS
+        if (m_pFormatCtx->oformat->flags & AVFMT_GLOBALHEADER)
+            m_pCodecCtx->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
 
-        result = avcodec_parameters_from_context(m_pStream->codecpar, m_pCodecCtx);
+        av_stream_set_r_frame_rate(m_pStream, {1, m_frameRate});
+
+        // 按传感器方向编码时，旋转和镜像写入显示矩阵
+        result = DisplayMatrix::WriteToStream(m_pStream, m_displayDegree, m_displayMirror);
         if(result < 0) {
-            LOGCATE("SingleVideoRecorder::StartRecord avcodec_parameters_from_context ret=%d", result);
+            LOGCATE("SingleVideoRecorder::StartRecord DisplayMatrix::WriteToStream ret=%d", result);
             break;
         }
 
-        av_stream_set_r_frame_rate(m_pStream, {1, m_frameRate});
-
         result = avcodec_open2(m_pCodecCtx, m_pCodec, nullptr);
         if(result < 0) {
             LOGCATE("SingleVideoRecorder::StartRecord avcodec_open2 ret=%d", result);
             break;
         }
 
+        // 编码器打开后才有 extradata，再拷贝到流参数
+        result = avcodec_parameters_from_context(m_pStream->codecpar, m_pCodecCtx);
+        if(result < 0) {
+            LOGCATE("SingleVideoRecorder::StartRecord avcodec_parameters_from_context ret=%d", result);
+            break;
+        }
+        m_encodeStats.Start(m_encoderConfig.ToString(), m_frameRate);
+
         // 打印格式信息
         av_dump_format(m_pFormatCtx, 0, m_outUrl, 1);
 
@@ -122,13 +134,7 @@ int SingleVideoRecorder::StartRecord() {
         av_image_fill_arrays(m_pFrame->data, m_pFrame->linesize, m_pFrameBuffer, m_pCodecCtx->pix_fmt,
                              m_pCodecCtx->width, m_pCodecCtx->height, 1);
 
-        AVDictionary *opt = 0;
-        if (m_pCodecCtx->codec_id == AV_CODEC_ID_H264) {
-            av_dict_set_int(&opt, "video_track_timescale", 25, 0);
-            av_dict_set(&opt, "preset", "slow", 0);
-            av_dict_set(&opt, "tune", "zerolatency", 0);
-        }
-        avformat_write_header(m_pFormatCtx, &opt);
+        avformat_write_header(m_pFormatCtx, nullptr);
         av_new_packet(&m_avPacket, bufferSize * 3);
 
     } while(false);
@@ -160,6 +166,7 @@ int SingleVideoRecorder::StopRecord() {
         if(result >= 0) {
             av_write_trailer(m_pFormatCtx);
         }
+        m_encodeStats.Report();
     }
 
     // 清理队列中剩余的帧
@@ -234,8 +241,19 @@ void SingleVideoRecorder::StartH264EncoderThread(SingleVideoRecorder *recorder)
                 LOGCATE("SingleVideoRecorder::StartH264EncoderThread unsupport format pImage->format=%d", pImage->format);
                 break;
         }
+        // 相机 YUV 帧旋转后与编码尺寸一致时，一次遍历完成旋转、镜像和转换
+        int dstWidth = 0, dstHeight = 0;
+        YuvTransform::GetOutputSize(pImage->width, pImage->height, recorder->m_transformDegree, &dstWidth, &dstHeight);
+        if(pImage->format != IMAGE_FORMAT_RGBA && dstWidth == recorder->m_frameWidth && dstHeight == recorder->m_frameHeight) {
+            int64_t startTime = av_gettime_relative();
+            if(YuvTransform::ToI420(pImage, pFrame->data, pFrame->linesize, recorder->m_transformDegree, recorder->m_transformMirror) == 0) {
+                recorder->m_yuvCost.Add(av_gettime_relative() - startTime);
+            } else {
+                LOGCATE("SingleVideoRecorder::StartH264EncoderThread YuvTransform fail format=%d", pImage->format);
+            }
+        }
         // 如果源格式不是YUV420P，需要进行格式转换
-        if(srcPixFmt != AV_PIX_FMT_YUV420P) {
+        else if(srcPixFmt != AV_PIX_FMT_YUV420P) {
             if(recorder->m_SwsContext == nullptr) {
                 // 创建格式转换上下文
                 recorder->m_SwsContext = sws_getContext(pImage->width, pImage->height, srcPixFmt,
@@ -244,6 +262,7 @@ void SingleVideoRecorder::StartH264EncoderThread(SingleVideoRecorder *recorder)
             }
             // 转换为编码器的目标格式 AV_PIX_FMT_YUV420P
             if(recorder->m_SwsContext != nullptr) {
+                int64_t startTime = av_gettime_relative();
                 int slice = sws_scale(recorder->m_SwsContext, pImage->ppPlane, pImage->pLineSize, 0,
                           recorder->m_frameHeight, pFrame->data, pFrame->linesize);
 //                NativeImage i420;
@@ -257,6 +276,7 @@ void SingleVideoRecorder::StartH264EncoderThread(SingleVideoRecorder *recorder)
 //                i420.pLineSize[1] = pFrame->linesize[1];
 //                i420.pLineSize[2] = pFrame->linesize[2];
 //                NativeImageUtil::DumpNativeImage(&i420, "/sdcard/DCIM", "NDK");
+                recorder->m_swsCost.Add(av_gettime_relative() - startTime);
                 LOGCATE("SingleVideoRecorder::StartH264EncoderThread sws_scale slice=%d", slice);
             }
         }
@@ -303,6 +323,7 @@ int SingleVideoRecorder::OnFrame2Encode(NativeImage *inputFrame) {
  */
 int SingleVideoRecorder::EncodeFrame(AVFrame *pFrame) {
     int result = 0;
+    int64_t startTime = av_gettime_relative();
     // 发送帧到编码器
     result = avcodec_send_frame(m_pCodecCtx, pFrame);
     if(result < 0)
@@ -314,12 +335,13 @@ int SingleVideoRecorder::EncodeFrame(AVFrame *pFrame) {
     while(!result) {
         result = avcodec_receive_packet(m_pCodecCtx, &m_avPacket);
         if (result == AVERROR(EAGAIN) || result == AVERROR_EOF) {
-            return 0;
+            break;
         } else if (result < 0) {
             LOGCATE("SingleVideoRecorder::EncodeFrame avcodec_receive_packet fail. ret=%d", result);
             return result;
         }
         LOGCATE("SingleVideoRecorder::EncodeFrame frame pts=%ld, size=%d", m_avPacket.pts, m_avPacket.size);
+        m_encodeStats.AddPacket(m_avPacket.size);
         // 调整时间戳并写入文件
         m_avPacket.stream_index = m_pStream->index;
         av_packet_rescale_ts(&m_avPacket, m_pCodecCtx->time_base, m_pStream->time_base);
@@ -327,5 +349,8 @@ int SingleVideoRecorder::EncodeFrame(AVFrame *pFrame) {
         av_interleaved_write_frame(m_pFormatCtx, &m_avPacket);
         av_packet_unref(&m_avPacket);
     }
+    // 刷新编码器时不计入帧数
+    if(pFrame != nullptr)
+        m_encodeStats.AddFrame(av_gettime_relative() - startTime);
     return 0;
 }
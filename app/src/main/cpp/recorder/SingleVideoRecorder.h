@@ -16,12 +16,17 @@ extern "C" {
 #include <libavutil/avutil.h>
 #include <libswscale/swscale.h>
 #include <libavutil/imgutils.h>
+#include <libavutil/time.h>
 }
 
 #include "ThreadSafeQueue.h"
 #include "ImageDef.h"
 #include "thread"
 #include "LogUtil.h"
+#include "YuvTransform.h"
+#include "CostCounter.h"
+#include "DisplayMatrix.h"
+#include "EncoderConfig.h"
 
 using namespace std;
 
@@ -63,6 +68,36 @@ public:
      */
     int OnFrame2Encode(NativeImage *inputFrame);
 
+    /**
+     * @brief 设置相机 YUV 帧的旋转和镜像
+     * 无滤镜时相机帧不经过 GL，直接在编码线程用 YuvTransform 转为 I420
+     * @param degree 旋转角度
+     * @param mirror 镜像方式
+     */
+    void SetFrameTransform(int degree, int mirror) {
+        m_transformDegree = degree;
+        m_transformMirror = mirror;
+    }
+
+    /**
+     * @brief 设置写入视频流显示矩阵的旋转和镜像，需在 StartRecord 之前调用
+     * 按传感器方向编码时，旋转由播放端根据显示矩阵完成
+     * @param degree 旋转角度
+     * @param mirror 镜像方式
+     */
+    void SetDisplayTransform(int degree, int mirror) {
+        m_displayDegree = degree;
+        m_displayMirror = mirror;
+    }
+
+    /**
+     * @brief 设置视频编码配置，需在 StartRecord 之前调用，不设置时使用默认配置
+     * @param config 编码配置
+     */
+    void SetEncoderConfig(const EncoderConfig &config) {
+        m_encoderConfig = config;
+    }
+
     /**
      * @brief 停止录制
      * 停止编码线程并写入文件尾
@@ -102,6 +137,14 @@ private:
     thread *m_encodeThread = nullptr;               // 编码线程
     SwsContext *m_SwsContext = nullptr;             // 图像格式转换上下文
     volatile int m_exit = 0;                        // 退出标志
+    volatile int m_transformDegree = 0;             // 相机 YUV 帧的旋转角度
+    volatile int m_transformMirror = 0;             // 相机 YUV 帧的镜像方式
+    int m_displayDegree = 0;                        // 显示矩阵的旋转角度
+    int m_displayMirror = 0;                        // 显示矩阵的镜像方式
+    EncoderConfig m_encoderConfig;                  // 视频编码配置
+    EncodeStats m_encodeStats{"SingleVideoRecorder encode"};  // 编码帧率和码率统计
+    CostCounter m_yuvCost{"SingleVideoRecorder yuv"};  // YuvTransform 转换耗时
+    CostCounter m_swsCost{"SingleVideoRecorder sws"};  // sws_scale 转换耗时
 };
 
 
@@ -25,6 +25,10 @@
 #define IMAGE_FORMAT_NV12           0x03
 /** @brief I420格式标识(YUV420P,平面格式) */
 #define IMAGE_FORMAT_I420           0x04
+/** @brief P010格式标识(10bit YUV420SP,UV交错,每个分量16bit存储,高10位有效) */
+#define IMAGE_FORMAT_P010           0x05
+/** @brief I010格式标识(YUV420P10LE,平面格式,每个分量16bit存储,低10位有效) */
+#define IMAGE_FORMAT_I010           0x06
 
 /** @brief RGBA格式扩展名 */
 #define IMAGE_FORMAT_RGBA_EXT       "RGB32"
@@ -34,6 +38,10 @@
 #define IMAGE_FORMAT_NV12_EXT       "NV12"
 /** @brief I420格式扩展名 */
 #define IMAGE_FORMAT_I420_EXT       "I420"
+/** @brief P010格式扩展名 */
+#define IMAGE_FORMAT_P010_EXT       "P010"
+/** @brief I010格式扩展名 */
+#define IMAGE_FORMAT_I010_EXT       "I010"
 
 /**
  * @struct RectF
@@ -141,6 +149,77 @@ public:
 				pImage->pLineSize[2] = pImage->width / 2;
 			}
 				break;
+			case IMAGE_FORMAT_P010:
+			{
+				// P010格式: 每个分量2字节, width * height * 3字节
+				pImage->ppPlane[0] = static_cast<uint8_t *>(malloc(pImage->width * pImage->height * 3));
+				pImage->ppPlane[1] = pImage->ppPlane[0] + pImage->width * pImage->height * 2;
+				pImage->pLineSize[0] = pImage->width * 2;
+				pImage->pLineSize[1] = pImage->width * 2;
+				pImage->pLineSize[2] = 0;
+			}
+				break;
+			case IMAGE_FORMAT_I010:
+			{
+				// I010格式: 每个分量2字节, width * height * 3字节
+				pImage->ppPlane[0] = static_cast<uint8_t *>(malloc(pImage->width * pImage->height * 3));
+				pImage->ppPlane[1] = pImage->ppPlane[0] + pImage->width * pImage->height * 2;
+				pImage->ppPlane[2] = pImage->ppPlane[1] + (pImage->width >> 1) * (pImage->height >> 1) * 2;
+				pImage->pLineSize[0] = pImage->width * 2;
+				pImage->pLineSize[1] = pImage->width;
+				pImage->pLineSize[2] = pImage->width;
+			}
+				break;
+			default:
+				LOGCATE("NativeImageUtil::AllocNativeImage do not support the format. Format = %d", pImage->format);
+				break;
+		}
+	}
+
+	/**
+	 * @brief 按指定行宽为图像分配内存
+	 * @details 行宽与源图像保持一致时,CopyNativeImage 可按平面整体拷贝,
+	 *          GL 端再通过 GL_UNPACK_ROW_LENGTH 直接上传,无需逐行重排
+	 * @param pImage 要分配内存的图像结构指针
+	 * @param pLineSize 各平面的行字节数
+	 */
+	static void AllocNativeImage(NativeImage *pImage, const int *pLineSize)
+	{
+		if (pImage->height == 0 || pImage->width == 0 || pLineSize == nullptr) return;
+
+		int chromaHeight = (pImage->height + 1) >> 1;
+		switch (pImage->format)
+		{
+			case IMAGE_FORMAT_RGBA:
+			{
+				pImage->ppPlane[0] = static_cast<uint8_t *>(malloc(pLineSize[0] * pImage->height));
+				pImage->pLineSize[0] = pLineSize[0];
+				pImage->pLineSize[1] = 0;
+				pImage->pLineSize[2] = 0;
+			}
+				break;
+			case IMAGE_FORMAT_NV12:
+			case IMAGE_FORMAT_NV21:
+			case IMAGE_FORMAT_P010:
+			{
+				pImage->ppPlane[0] = static_cast<uint8_t *>(malloc(pLineSize[0] * pImage->height + pLineSize[1] * chromaHeight));
+				pImage->ppPlane[1] = pImage->ppPlane[0] + pLineSize[0] * pImage->height;
+				pImage->pLineSize[0] = pLineSize[0];
+				pImage->pLineSize[1] = pLineSize[1];
+				pImage->pLineSize[2] = 0;
+			}
+				break;
+			case IMAGE_FORMAT_I420:
+			case IMAGE_FORMAT_I010:
+			{
+				pImage->ppPlane[0] = static_cast<uint8_t *>(malloc(pLineSize[0] * pImage->height + (pLineSize[1] + pLineSize[2]) * chromaHeight));
+				pImage->ppPlane[1] = pImage->ppPlane[0] + pLineSize[0] * pImage->height;
+				pImage->ppPlane[2] = pImage->ppPlane[1] + pLineSize[1] * chromaHeight;
+				pImage->pLineSize[0] = pLineSize[0];
+				pImage->pLineSize[1] = pLineSize[1];
+				pImage->pLineSize[2] = pLineSize[2];
+			}
+				break;
 			default:
 				LOGCATE("NativeImageUtil::AllocNativeImage do not support the format. Format = %d", pImage->format);
 				break;
@@ -190,15 +269,19 @@ public:
 
 		if(pDstImg->ppPlane[0] == nullptr) AllocNativeImage(pDstImg);  // 目标图像未分配则分配内存
 
+		// 10bit格式每个分量占2字节
+		int bytesPerSample = (pSrcImg->format == IMAGE_FORMAT_P010 || pSrcImg->format == IMAGE_FORMAT_I010) ? 2 : 1;
+
 		switch (pSrcImg->format)
 		{
 			case IMAGE_FORMAT_I420:
+			case IMAGE_FORMAT_I010:
 			{
 				// Y平面拷贝
 				if(pSrcImg->pLineSize[0] != pDstImg->pLineSize[0]) {
 					// 行宽不同,逐行拷贝
 					for (int i = 0; i < pSrcImg->height; ++i) {
-						memcpy(pDstImg->ppPlane[0] + i * pDstImg->pLineSize[0], pSrcImg->ppPlane[0] + i * pSrcImg->pLineSize[0], pDstImg->width);
+						memcpy(pDstImg->ppPlane[0] + i * pDstImg->pLineSize[0], pSrcImg->ppPlane[0] + i * pSrcImg->pLineSize[0], pDstImg->width * bytesPerSample);
 					}
 				}
 				else
@@ -210,7 +293,7 @@ public:
 				// U平面拷贝
 				if(pSrcImg->pLineSize[1] != pDstImg->pLineSize[1]) {
 					for (int i = 0; i < pSrcImg->height / 2; ++i) {
-						memcpy(pDstImg->ppPlane[1] + i * pDstImg->pLineSize[1], pSrcImg->ppPlane[1] + i * pSrcImg->pLineSize[1], pDstImg->width / 2);
+						memcpy(pDstImg->ppPlane[1] + i * pDstImg->pLineSize[1], pSrcImg->ppPlane[1] + i * pSrcImg->pLineSize[1], pDstImg->width / 2 * bytesPerSample);
 					}
 				}
 				else
@@ -221,7 +304,7 @@ public:
 				// V平面拷贝
 				if(pSrcImg->pLineSize[2] != pDstImg->pLineSize[2]) {
 					for (int i = 0; i < pSrcImg->height / 2; ++i) {
-						memcpy(pDstImg->ppPlane[2] + i * pDstImg->pLineSize[2], pSrcImg->ppPlane[2] + i * pSrcImg->pLineSize[2], pDstImg->width / 2);
+						memcpy(pDstImg->ppPlane[2] + i * pDstImg->pLineSize[2], pSrcImg->ppPlane[2] + i * pSrcImg->pLineSize[2], pDstImg->width / 2 * bytesPerSample);
 					}
 				}
 				else
@@ -232,11 +315,12 @@ public:
 			    break;
 			case IMAGE_FORMAT_NV21:
 			case IMAGE_FORMAT_NV12:
+			case IMAGE_FORMAT_P010:
 			{
 				// Y平面拷贝
 				if(pSrcImg->pLineSize[0] != pDstImg->pLineSize[0]) {
 					for (int i = 0; i < pSrcImg->height; ++i) {
-						memcpy(pDstImg->ppPlane[0] + i * pDstImg->pLineSize[0], pSrcImg->ppPlane[0] + i * pSrcImg->pLineSize[0], pDstImg->width);
+						memcpy(pDstImg->ppPlane[0] + i * pDstImg->pLineSize[0], pSrcImg->ppPlane[0] + i * pSrcImg->pLineSize[0], pDstImg->width * bytesPerSample);
 					}
 				}
 				else
@@ -247,7 +331,7 @@ public:
 				// UV平面拷贝
 				if(pSrcImg->pLineSize[1] != pDstImg->pLineSize[1]) {
 					for (int i = 0; i < pSrcImg->height / 2; ++i) {
-						memcpy(pDstImg->ppPlane[1] + i * pDstImg->pLineSize[1], pSrcImg->ppPlane[1] + i * pSrcImg->pLineSize[1], pDstImg->width);
+						memcpy(pDstImg->ppPlane[1] + i * pDstImg->pLineSize[1], pSrcImg->ppPlane[1] + i * pSrcImg->pLineSize[1], pDstImg->width * bytesPerSample);
 					}
 				}
 				else
@@ -316,6 +400,12 @@ public:
 			case IMAGE_FORMAT_RGBA:
 				pExt = IMAGE_FORMAT_RGBA_EXT;
 				break;
+			case IMAGE_FORMAT_P010:
+				pExt = IMAGE_FORMAT_P010_EXT;
+				break;
+			case IMAGE_FORMAT_I010:
+				pExt = IMAGE_FORMAT_I010_EXT;
+				break;
 			default:
 				pExt = "Default";
 				break;
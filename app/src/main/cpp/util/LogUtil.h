@@ -5,16 +5,28 @@
 #ifndef BYTEFLOW_LOGUTIL_H
 #define BYTEFLOW_LOGUTIL_H
 
-#include<android/log.h>
 #include <sys/time.h>
 
 #define  LOG_TAG "ByteFlow"  // 日志标签
 
+#ifdef __ANDROID__
+#include<android/log.h>
+
 // Android 日志宏定义
 #define  LOGCATE(...)  __android_log_print(ANDROID_LOG_ERROR,LOG_TAG,__VA_ARGS__)    // 错误级别日志
 #define  LOGCATV(...)  __android_log_print(ANDROID_LOG_VERBOSE,LOG_TAG,__VA_ARGS__)  // 详细级别日志
 #define  LOGCATD(...)  __android_log_print(ANDROID_LOG_DEBUG,LOG_TAG,__VA_ARGS__)    // 调试级别日志
 #define  LOGCATI(...)  __android_log_print(ANDROID_LOG_INFO,LOG_TAG,__VA_ARGS__)     // 信息级别日志
+#else
+#include <stdio.h>
+
+// 主机上编译单元测试（app/src/test/cpp）时没有 logcat，日志输出到 stderr
+#define  LOG_PRINT(...)  (fprintf(stderr, LOG_TAG ": " __VA_ARGS__), fputc('\n', stderr))
+#define  LOGCATE(...)  LOG_PRINT(__VA_ARGS__)
+#define  LOGCATV(...)  LOG_PRINT(__VA_ARGS__)
+#define  LOGCATD(...)  LOG_PRINT(__VA_ARGS__)
+#define  LOGCATI(...)  LOG_PRINT(__VA_ARGS__)
+#endif
 
 // 日志宏别名
 #define ByteFlowPrintE LOGCATE
@@ -58,7 +70,7 @@
  * @brief 获取系统当前时间（毫秒）
  * @return 当前时间戳（毫秒）
  */
-static long long GetSysCurrentTime()
+static inline long long GetSysCurrentTime()
 {
 	struct timeval time;
 	gettimeofday(&time, NULL);
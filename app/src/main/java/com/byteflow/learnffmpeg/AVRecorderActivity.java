@@ -19,6 +19,7 @@ import android.graphics.Bitmap;
 import android.graphics.BitmapFactory;
 import android.graphics.Color;
 import android.hardware.camera2.CameraCharacteristics;
+import android.media.Image;
 import android.net.Uri;
 import android.opengl.GLSurfaceView;
 import android.os.Build;
@@ -72,6 +73,8 @@ import java.util.GregorianCalendar;
 import java.util.List;
 import java.util.Locale;
 
+import static com.byteflow.learnffmpeg.media.MediaRecorderContext.BUFFER_TYPE_AUDIO;
+import static com.byteflow.learnffmpeg.media.MediaRecorderContext.BUFFER_TYPE_VIDEO;
 import static com.byteflow.learnffmpeg.media.MediaRecorderContext.IMAGE_FORMAT_I420;
 import static com.byteflow.learnffmpeg.media.MediaRecorderContext.IMAGE_FORMAT_RGBA;
 import static com.byteflow.learnffmpeg.media.MediaRecorderContext.RECORDER_TYPE_AV;
@@ -214,9 +217,15 @@ public class AVRecorderActivity extends AppCompatActivity implements Camera2Fram
     }
 
     @Override
-    public void onPreviewFrame(byte[] data, int width, int height) {
-        Log.d(TAG, "onPreviewFrame() called with: data = [" + data + "], width = [" + width + "], height = [" + height + "]");
-        mMediaRecorder.onPreviewFrame(IMAGE_FORMAT_I420, data, width, height);
+    public void onPreviewFrame(Image image, int width, int height) {
+        Log.d(TAG, "onPreviewFrame() called with: image = [" + image + "], width = [" + width + "], height = [" + height + "]");
+        ByteBuffer buffer = mMediaRecorder.acquireBuffer(BUFFER_TYPE_VIDEO, CameraUtil.getI420Size(width, height));
+        if (buffer == null) {
+            Log.d(TAG, "onPreviewFrame() no free buffer, drop frame");
+            return;
+        }
+        CameraUtil.YUV_420_888_data(image, buffer);
+        mMediaRecorder.onPreviewBuffer(IMAGE_FORMAT_I420, buffer, width, height);
         mMediaRecorder.requestRender();
     }
 
@@ -544,8 +553,13 @@ public class AVRecorderActivity extends AppCompatActivity implements Camera2Fram
     }
 
     @Override
-    public void onAudioData(byte[] data, int dataSize) {
-        mMediaRecorder.onAudioData(data, dataSize);
+    public ByteBuffer onAcquireBuffer(int capacity) {
+        return mMediaRecorder.acquireBuffer(BUFFER_TYPE_AUDIO, capacity);
+    }
+
+    @Override
+    public void onAudioData(ByteBuffer data, int dataSize) {
+        mMediaRecorder.onAudioBuffer(data, dataSize);
     }
 
     @Override
@@ -32,10 +32,12 @@ import com.byteflow.learnffmpeg.view.CaptureListener;
 import com.byteflow.learnffmpeg.view.TypeListener;
 
 import java.io.File;
+import java.nio.ByteBuffer;
 import java.text.SimpleDateFormat;
 import java.util.GregorianCalendar;
 import java.util.Locale;
 
+import static com.byteflow.learnffmpeg.media.MediaRecorderContext.BUFFER_TYPE_AUDIO;
 import static com.byteflow.learnffmpeg.media.MediaRecorderContext.RECORDER_TYPE_SINGLE_AUDIO;
 import static com.byteflow.learnffmpeg.view.RecordedButton.BUTTON_STATE_ONLY_RECORDER;
 
@@ -224,8 +226,13 @@ public class AudioRecorderActivity extends AppCompatActivity implements AudioRec
     }
 
     @Override
-    public void onAudioData(byte[] data, int dataSize) {
-        mFFMediaRecorder.onAudioData(data, dataSize);
+    public ByteBuffer onAcquireBuffer(int capacity) {
+        return mFFMediaRecorder.acquireBuffer(BUFFER_TYPE_AUDIO, capacity);
+    }
+
+    @Override
+    public void onAudioData(ByteBuffer data, int dataSize) {
+        mFFMediaRecorder.onAudioBuffer(data, dataSize);
     }
 
     @Override
@@ -109,6 +109,7 @@ public class AudioVisualMediaPlayerActivity extends AppCompatActivity implements
 
             }
         });
+        FFMediaPlayer.setCacheDir(getCacheDir().getAbsolutePath());
         mMediaPlayer = new FFMediaPlayer();
         mMediaPlayer.addEventCallback(this);
         mMediaPlayer.init(mVideoPath, VIDEO_RENDER_OPENGL, null);
@@ -116,6 +116,7 @@ public class FFMediaCodecPlayerActivity extends AppCompatActivity implements Sur
     @Override
     public void surfaceCreated(SurfaceHolder surfaceHolder) {
         Log.d(TAG, "surfaceCreated() called with: surfaceHolder = [" + surfaceHolder + "]");
+        FFMediaPlayer.setCacheDir(getCacheDir().getAbsolutePath());
         mMediaPlayer = new FFMediaPlayer();
         mMediaPlayer.addEventCallback(this);
         mMediaPlayer.init(mVideoPath, HWCODEC_PLAYER, VIDEO_RENDER_ANWINDOW, surfaceHolder.getSurface());
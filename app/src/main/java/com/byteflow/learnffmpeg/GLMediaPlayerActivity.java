@@ -67,7 +67,10 @@ public class GLMediaPlayerActivity extends AppCompatActivity implements GLSurfac
         mSeekBar.setOnSeekBarChangeListener(new SeekBar.OnSeekBarChangeListener() {
             @Override
             public void onProgressChanged(SeekBar seekBar, int i, boolean b) {
-
+                //拖动过程中只预览关键帧，松手后精确跳转
+                if(b && mMediaPlayer != null) {
+                    mMediaPlayer.scrubToPosition(i);
+                }
             }
 
             @Override
@@ -85,6 +88,7 @@ public class GLMediaPlayerActivity extends AppCompatActivity implements GLSurfac
 
             }
         });
+        FFMediaPlayer.setCacheDir(getCacheDir().getAbsolutePath());
         mMediaPlayer = new FFMediaPlayer();
         mMediaPlayer.addEventCallback(this);
         mMediaPlayer.init(mVideoPath, VIDEO_RENDER_OPENGL, null);
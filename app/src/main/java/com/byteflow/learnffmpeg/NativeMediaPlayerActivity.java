@@ -59,7 +59,10 @@ public class NativeMediaPlayerActivity extends AppCompatActivity implements Surf
         mSeekBar.setOnSeekBarChangeListener(new SeekBar.OnSeekBarChangeListener() {
             @Override
             public void onProgressChanged(SeekBar seekBar, int i, boolean b) {
-
+                //拖动过程中只预览关键帧，松手后精确跳转
+                if(b && mMediaPlayer != null) {
+                    mMediaPlayer.scrubToPosition(i);
+                }
             }
 
             @Override
@@ -113,6 +116,7 @@ public class NativeMediaPlayerActivity extends AppCompatActivity implements Surf
     @Override
     public void surfaceCreated(SurfaceHolder surfaceHolder) {
         Log.d(TAG, "surfaceCreated() called with: surfaceHolder = [" + surfaceHolder + "]");
+        FFMediaPlayer.setCacheDir(getCacheDir().getAbsolutePath());
         mMediaPlayer = new FFMediaPlayer();
         mMediaPlayer.addEventCallback(this);
         mMediaPlayer.init(mVideoPath, VIDEO_RENDER_ANWINDOW, surfaceHolder.getSurface());
@@ -124,6 +124,7 @@ public class StreamMediaPlayerActivity extends AppCompatActivity implements Surf
     @Override
     public void surfaceCreated(SurfaceHolder surfaceHolder) {
         Log.d(TAG, "surfaceCreated() called with: surfaceHolder = [" + surfaceHolder + "]");
+        FFMediaPlayer.setCacheDir(getCacheDir().getAbsolutePath());
         mMediaPlayer = new FFMediaPlayer();
         mMediaPlayer.addEventCallback(this);
         mMediaPlayer.init(mVideoPath, VIDEO_RENDER_ANWINDOW, surfaceHolder.getSurface());
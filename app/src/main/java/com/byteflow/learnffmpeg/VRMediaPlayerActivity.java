@@ -90,6 +90,7 @@ public class VRMediaPlayerActivity extends AppCompatActivity implements GLSurfac
 
             }
         });
+        FFMediaPlayer.setCacheDir(getCacheDir().getAbsolutePath());
         mMediaPlayer = new FFMediaPlayer();
         mMediaPlayer.addEventCallback(this);
         mMediaPlayer.init(mVideoPath, VIDEO_RENDER_3D_VR, null);
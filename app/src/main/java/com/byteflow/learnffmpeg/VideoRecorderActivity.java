@@ -17,6 +17,7 @@ import android.content.Intent;
 import android.content.pm.PackageManager;
 import android.graphics.Color;
 import android.hardware.camera2.CameraCharacteristics;
+import android.media.Image;
 import android.net.Uri;
 import android.opengl.GLSurfaceView;
 import android.os.Build;
@@ -58,12 +59,14 @@ import com.byteflow.learnffmpeg.view.CaptureListener;
 import com.byteflow.learnffmpeg.view.TypeListener;
 
 import java.io.File;
+import java.nio.ByteBuffer;
 import java.text.SimpleDateFormat;
 import java.util.ArrayList;
 import java.util.GregorianCalendar;
 import java.util.List;
 import java.util.Locale;
 
+import static com.byteflow.learnffmpeg.media.MediaRecorderContext.BUFFER_TYPE_VIDEO;
 import static com.byteflow.learnffmpeg.media.MediaRecorderContext.IMAGE_FORMAT_I420;
 import static com.byteflow.learnffmpeg.media.MediaRecorderContext.RECORDER_TYPE_SINGLE_VIDEO;
 import static com.byteflow.learnffmpeg.view.RecordedButton.BUTTON_STATE_ONLY_RECORDER;
@@ -188,9 +191,15 @@ public class VideoRecorderActivity extends AppCompatActivity implements Camera2F
     }
 
     @Override
-    public void onPreviewFrame(byte[] data, int width, int height) {
-        Log.d(TAG, "onPreviewFrame() called with: data = [" + data + "], width = [" + width + "], height = [" + height + "]");
-        mMediaRecorder.onPreviewFrame(IMAGE_FORMAT_I420, data, width, height);
+    public void onPreviewFrame(Image image, int width, int height) {
+        Log.d(TAG, "onPreviewFrame() called with: image = [" + image + "], width = [" + width + "], height = [" + height + "]");
+        ByteBuffer buffer = mMediaRecorder.acquireBuffer(BUFFER_TYPE_VIDEO, CameraUtil.getI420Size(width, height));
+        if (buffer == null) {
+            Log.d(TAG, "onPreviewFrame() no free buffer, drop frame");
+            return;
+        }
+        CameraUtil.YUV_420_888_data(image, buffer);
+        mMediaRecorder.onPreviewBuffer(IMAGE_FORMAT_I420, buffer, width, height);
         mMediaRecorder.requestRender();
     }
 
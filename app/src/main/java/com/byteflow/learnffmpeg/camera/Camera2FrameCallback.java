@@ -1,6 +1,9 @@
 package com.byteflow.learnffmpeg.camera;
 
+import android.media.Image;
+
 public interface Camera2FrameCallback {
-    void onPreviewFrame(byte[] data, int width, int height);
+    //image 只在回调内有效，返回后由 Camera2Wrapper 关闭
+    void onPreviewFrame(Image image, int width, int height);
     void onCaptureFrame(byte[] data, int width, int height);
 }
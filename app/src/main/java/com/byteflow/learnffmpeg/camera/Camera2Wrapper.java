@@ -73,7 +73,7 @@ public class Camera2Wrapper {
             Image image = reader.acquireLatestImage();
             if (image != null) {
                 if (mCamera2FrameCallback != null) {
-                    mCamera2FrameCallback.onPreviewFrame(CameraUtil.YUV_420_888_data(image), image.getWidth(), image.getHeight());
+                    mCamera2FrameCallback.onPreviewFrame(image, image.getWidth(), image.getHeight());
                 }
                 image.close();
             }
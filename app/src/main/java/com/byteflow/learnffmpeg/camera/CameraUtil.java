@@ -8,6 +8,9 @@ import android.util.Size;
 import java.nio.ByteBuffer;
 
 public class CameraUtil {
+    //YUV_420_888_data 的行缓冲，每帧复用，不在相机回调里反复分配
+    private static final ThreadLocal<byte[]> sRowBuffer = new ThreadLocal<>();
+
     public static Size getFitInScreenSize(int previewWidth, int previewHeight, int screenWidth,
                                           int screenHeight) {
         Point res = new Point(0, 0);
@@ -39,11 +42,21 @@ public class CameraUtil {
     }
 
     public static byte[] YUV_420_888_data(Image image) {
+        byte[] data = new byte[getI420Size(image.getWidth(), image.getHeight())];
+        YUV_420_888_data(image, ByteBuffer.wrap(data));
+        return data;
+    }
+
+    public static int getI420Size(int width, int height) {
+        return width * height * ImageFormat.getBitsPerPixel(ImageFormat.YUV_420_888) / 8;
+    }
+
+    //把 Image 转成 I420 写入 out（从 position 0 开始），out 可以是与 Native 共享的 direct ByteBuffer，
+    //容量至少为 getI420Size
+    public static void YUV_420_888_data(Image image, ByteBuffer out) {
         final int imageWidth = image.getWidth();
         final int imageHeight = image.getHeight();
         final Image.Plane[] planes = image.getPlanes();
-        byte[] data = new byte[imageWidth * imageHeight *
-                ImageFormat.getBitsPerPixel(ImageFormat.YUV_420_888) / 8];
         int offset = 0;
 
         for (int plane = 0; plane < planes.length; ++plane) {
@@ -55,28 +68,49 @@ public class CameraUtil {
             final int planeWidth = (plane == 0) ? imageWidth : imageWidth / 2;
             final int planeHeight = (plane == 0) ? imageHeight : imageHeight / 2;
             if (pixelStride == 1 && rowStride == planeWidth) {
-                // Copy whole plane from buffer into |data| at once.
-                buffer.get(data, offset, planeWidth * planeHeight);
+                // Copy whole plane from buffer into |out| at once.
+                ByteBuffer src = buffer.duplicate();
+                src.limit(src.position() + planeWidth * planeHeight);
+                out.position(offset);
+                out.put(src);
                 offset += planeWidth * planeHeight;
+            } else if (pixelStride == 1) {
+                // Copy row by row, skipping the row padding.
+                ByteBuffer src = buffer.duplicate();
+                int rowStart = src.position();
+                for (int row = 0; row < planeHeight; ++row) {
+                    src.limit(rowStart + row * rowStride + planeWidth);
+                    src.position(rowStart + row * rowStride);
+                    out.position(offset);
+                    out.put(src);
+                    offset += planeWidth;
+                }
             } else {
-                // Copy pixels one by one respecting pixelStride and rowStride.
-                byte[] rowData = new byte[rowStride];
-                for (int row = 0; row < planeHeight - 1; ++row) {
-                    buffer.get(rowData, 0, rowStride);
-                    for (int col = 0; col < planeWidth; ++col) {
-                        data[offset++] = rowData[col * pixelStride];
+                // Pack each row in place by pixelStride, then copy it into |out| at once.
+                byte[] rowData = getRowBuffer(rowStride);
+                for (int row = 0; row < planeHeight; ++row) {
+                    // Last row is special in some devices and may not contain the full
+                    // |rowStride| bytes of data.
+                    // See http://developer.android.com/reference/android/media/Image.Plane.html#getBuffer()
+                    buffer.get(rowData, 0, Math.min(rowStride, buffer.remaining()));
+                    for (int col = 1; col < planeWidth; ++col) {
+                        rowData[col] = rowData[col * pixelStride];
                     }
-                }
-                // Last row is special in some devices and may not contain the full
-                // |rowStride| bytes of data.
-                // See http://developer.android.com/reference/android/media/Image.Plane.html#getBuffer()
-                buffer.get(rowData, 0, Math.min(rowStride, buffer.remaining()));
-                for (int col = 0; col < planeWidth; ++col) {
-                    data[offset++] = rowData[col * pixelStride];
+                    out.position(offset);
+                    out.put(rowData, 0, planeWidth);
+                    offset += planeWidth;
                 }
             }
         }
+        out.position(0);
+    }
 
-        return data;
+    private static byte[] getRowBuffer(int size) {
+        byte[] rowData = sRowBuffer.get();
+        if (rowData == null || rowData.length < size) {
+            rowData = new byte[size];
+            sRowBuffer.set(rowData);
+        }
+        return rowData;
     }
 }
@@ -4,12 +4,15 @@ import android.media.AudioFormat;
 import android.media.AudioRecord;
 import android.util.Log;
 
+import java.nio.ByteBuffer;
+
 public class AudioRecorder extends Thread {
 	private static final String TAG = "AudioRecorder";
 	private AudioRecord mAudioRecord = null;
 	private static final int DEFAULT_SAMPLE_RATE = 44100;
 	private static final int DEFAULT_CHANNEL_LAYOUT = AudioFormat.CHANNEL_IN_STEREO;
 	private static final int DEFAULT_SAMPLE_FORMAT = AudioFormat.ENCODING_PCM_16BIT;
+	public static final int AUDIO_BUFFER_SIZE = 4096; //每次读取的 PCM 字节数
 	private final AudioRecorderCallback mRecorderCallback;
 
 	public AudioRecorder(AudioRecorderCallback callback) {
@@ -35,12 +38,23 @@ public class AudioRecorder extends Thread {
 			return;
 		}
 
-		byte[] sampleBuffer = new byte[4096];
+		//没有空闲缓冲时仍要把数据读走，避免 AudioRecord 内部溢出，读到这里的数据被丢弃
+		ByteBuffer dropBuffer = null;
 		try {
 			while (!Thread.currentThread().isInterrupted()) {
+				ByteBuffer sampleBuffer = mRecorderCallback.onAcquireBuffer(AUDIO_BUFFER_SIZE);
+				if (sampleBuffer == null) {
+					if (dropBuffer == null) dropBuffer = ByteBuffer.allocateDirect(AUDIO_BUFFER_SIZE);
+					mAudioRecord.read(dropBuffer, AUDIO_BUFFER_SIZE);
+					Log.d(TAG, "run() no free buffer, drop audio data");
+					continue;
+				}
 
-				int result = mAudioRecord.read(sampleBuffer, 0, 4096);
-				if (result > 0) {
+				int result = 0;
+				try {
+					result = mAudioRecord.read(sampleBuffer, AUDIO_BUFFER_SIZE);
+				} finally {
+					//读取失败时 result <= 0，接收方只归还缓冲
 					mRecorderCallback.onAudioData(sampleBuffer, result);
 				}
 			}
@@ -53,7 +67,10 @@ public class AudioRecorder extends Thread {
 	}
 
 	public interface AudioRecorderCallback {
-		void onAudioData(byte[] data, int dataSize);
+		//借出一块 capacity 字节的 direct ByteBuffer 用于读取 PCM，返回 null 表示没有空闲缓冲
+		ByteBuffer onAcquireBuffer(int capacity);
+		//data 中有 dataSize 字节 PCM，接收方负责归还缓冲；dataSize <= 0 表示读取失败
+		void onAudioData(ByteBuffer data, int dataSize);
 		void onError(String msg);
 	}
 }
@@ -24,6 +24,9 @@ public class FFMediaPlayer {
     public static final int MSG_DECODER_DONE            = 2;
     public static final int MSG_REQUEST_RENDER          = 3;
     public static final int MSG_DECODING_TIME           = 4;
+    public static final int MSG_BUFFERING_START         = 5;
+    public static final int MSG_BUFFERING_END           = 6;
+    public static final int MSG_DECODER_ERROR           = 7;
 
     public static final int MEDIA_PARAM_VIDEO_WIDTH     = 0x0001;
     public static final int MEDIA_PARAM_VIDEO_HEIGHT    = 0x0002;
@@ -66,6 +69,13 @@ public class FFMediaPlayer {
         return native_GetFFmpegVersion();
     }
 
+    /**
+     * 设置 http 磁盘缓存和流信息缓存所在的目录，一般传 Context.getCacheDir()，未设置时不缓存
+     */
+    public static void setCacheDir(String cacheDir) {
+        native_SetCacheDir(cacheDir);
+    }
+
     public void init(String url, int videoRenderType, Surface surface) {
         mNativePlayerHandle = native_Init(url, FFMEDIA_PLAYER, videoRenderType, surface);
     }
@@ -86,6 +96,27 @@ public class FFMediaPlayer {
         native_SeekToPosition(mNativePlayerHandle, position);
     }
 
+    /**
+     * 拖动进度条过程中快速预览，只显示关键帧，松手后调用 seekToPosition 精确跳转
+     */
+    public void scrubToPosition(float position) {
+        native_ScrubToPosition(mNativePlayerHandle, position);
+    }
+
+    /**
+     * 设置 seekToPosition 是否精确到目标帧，默认开启；关闭后直接显示目标之前的关键帧，跳转更快
+     */
+    public void setAccurateSeek(boolean accurate) {
+        native_SetAccurateSeek(mNativePlayerHandle, accurate);
+    }
+
+    /**
+     * 设置直播（rtsp/rtmp 等）的目标延迟（毫秒），延迟超过目标时加速或丢帧追赶，对点播无效
+     */
+    public void setLatencyTarget(int latencyMs) {
+        native_SetLatencyTarget(mNativePlayerHandle, latencyMs);
+    }
+
     public void stop() {
         native_Stop(mNativePlayerHandle);
     }
@@ -118,12 +149,20 @@ public class FFMediaPlayer {
 
     private static native String native_GetFFmpegVersion();
 
+    private static native void native_SetCacheDir(String cacheDir);
+
     private native long native_Init(String url, int playerType, int renderType, Object surface);
 
     private native void native_Play(long playerHandle);
 
     private native void native_SeekToPosition(long playerHandle, float position);
 
+    private native void native_ScrubToPosition(long playerHandle, float position);
+
+    private native void native_SetAccurateSeek(long playerHandle, boolean accurate);
+
+    private native void native_SetLatencyTarget(long playerHandle, int latencyMs);
+
     private native void native_Pause(long playerHandle);
 
     private native void native_Stop(long playerHandle);
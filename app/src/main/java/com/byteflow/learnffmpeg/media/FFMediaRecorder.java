@@ -17,6 +17,10 @@ import javax.microedition.khronos.opengles.GL10;
 public class FFMediaRecorder extends MediaRecorderContext implements GLSurfaceView.Renderer {
     private static final String TAG = "CameraRender";
     private GLSurfaceView mGLSurfaceView;
+    private static final int VIDEO_BUFFER_COUNT = 3;  //预览帧在 onPreviewBuffer 内同步消费，少量缓冲即可
+    private static final int AUDIO_BUFFER_COUNT = 64; //PCM 排队等待编码，约 1.5s 的 44.1kHz 双声道数据
+    private ByteBuffer[][] mBufferPools = new ByteBuffer[2][];
+    private int[] mBufferCapacity = new int[2];
 
     public FFMediaRecorder() {
     }
@@ -47,6 +51,20 @@ public class FFMediaRecorder extends MediaRecorderContext implements GLSurfaceVi
         native_SetTransformMatrix(0, 0, 1, 1, degree, mirror);
     }
 
+    public void setRotationMetadataEnabled(boolean enable) {
+        Log.d(TAG, "setRotationMetadataEnabled() called with: enable = [" + enable + "]");
+        native_SetRotationMetadataEnabled(enable);
+    }
+
+    public void setEncoderConfig(int codec, String preset, String tune, int rateControl, int crf,
+                                 long bitRate, long maxBitRate, long bufferSize,
+                                 int threadCount, boolean slicedThreads, int lookahead,
+                                 int maxBFrames, int keyIntervalFrames) {
+        Log.d(TAG, "setEncoderConfig() called with: codec = [" + codec + "], preset = [" + preset + "], tune = [" + tune + "], rateControl = [" + rateControl + "], crf = [" + crf + "], bitRate = [" + bitRate + "], maxBitRate = [" + maxBitRate + "], bufferSize = [" + bufferSize + "], threadCount = [" + threadCount + "], slicedThreads = [" + slicedThreads + "], lookahead = [" + lookahead + "], maxBFrames = [" + maxBFrames + "], keyIntervalFrames = [" + keyIntervalFrames + "]");
+        native_SetEncoderConfig(codec, preset, tune, rateControl, crf, bitRate, maxBitRate, bufferSize,
+                threadCount, slicedThreads, lookahead, maxBFrames, keyIntervalFrames);
+    }
+
     public void startRecord(int recorderType, String outUrl, int frameWidth, int frameHeight, long videoBitRate, int fps) {
         Log.d(TAG, "startRecord() called with: recorderType = [" + recorderType + "], outUrl = [" + outUrl + "], frameWidth = [" + frameWidth + "], frameHeight = [" + frameHeight + "], videoBitRate = [" + videoBitRate + "], fps = [" + fps + "]");
         native_StartRecord(recorderType, outUrl, frameWidth, frameHeight, videoBitRate, fps);
@@ -62,6 +80,47 @@ public class FFMediaRecorder extends MediaRecorderContext implements GLSurfaceVi
         native_OnAudioData(data, size);
     }
 
+    //创建与 Native 共享的缓冲池，重建后旧的 ByteBuffer 不可再使用
+    public boolean createBufferPool(int bufferType, int count, int capacity) {
+        Log.d(TAG, "createBufferPool() called with: bufferType = [" + bufferType + "], count = [" + count + "], capacity = [" + capacity + "]");
+        mBufferPools[bufferType] = native_CreateBufferPool(bufferType, count, capacity);
+        mBufferCapacity[bufferType] = mBufferPools[bufferType] != null ? capacity : 0;
+        return mBufferPools[bufferType] != null;
+    }
+
+    //按数据大小借出缓冲，缓冲池不存在或大小变化（如切换预览分辨率）时先创建缓冲池
+    public ByteBuffer acquireBuffer(int bufferType, int capacity) {
+        if (mBufferCapacity[bufferType] != capacity) {
+            int count = bufferType == BUFFER_TYPE_AUDIO ? AUDIO_BUFFER_COUNT : VIDEO_BUFFER_COUNT;
+            if (!createBufferPool(bufferType, count, capacity)) return null;
+        }
+        return acquireBuffer(bufferType);
+    }
+
+    //借出一块空闲缓冲，写入数据后通过 onPreviewBuffer/onAudioBuffer 提交，
+    //不提交时调用 releaseBuffer 归还；返回 null 表示没有空闲缓冲，应丢弃这一帧
+    public ByteBuffer acquireBuffer(int bufferType) {
+        ByteBuffer[] buffers = mBufferPools[bufferType];
+        if (buffers == null) return null;
+        int index = native_AcquireBuffer(bufferType);
+        if (index < 0) return null;
+        ByteBuffer buffer = buffers[index];
+        buffer.clear();
+        return buffer;
+    }
+
+    public void releaseBuffer(int bufferType, ByteBuffer buffer) {
+        native_ReleaseBuffer(bufferType, buffer);
+    }
+
+    public void onPreviewBuffer(int format, ByteBuffer buffer, int width, int height) {
+        native_OnPreviewBuffer(format, buffer, width, height);
+    }
+
+    public void onAudioBuffer(ByteBuffer buffer, int size) {
+        native_OnAudioBuffer(buffer, size);
+    }
+
     public void stopRecord() {
         Log.d(TAG, "stopRecord() called");
         native_StopRecord();
@@ -121,5 +180,10 @@ public class FFMediaRecorder extends MediaRecorderContext implements GLSurfaceVi
     public void unInit() {
         native_UnInit();
         native_DestroyContext();
+        //缓冲池随 Native 上下文释放
+        for (int i = 0; i < mBufferPools.length; i++) {
+            mBufferPools[i] = null;
+            mBufferCapacity[i] = 0;
+        }
     }
 }
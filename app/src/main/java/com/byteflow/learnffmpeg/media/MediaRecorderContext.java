@@ -1,5 +1,7 @@
 package com.byteflow.learnffmpeg.media;
 
+import java.nio.ByteBuffer;
+
 public abstract class MediaRecorderContext {
     public static final int IMAGE_FORMAT_RGBA = 0x01;
     public static final int IMAGE_FORMAT_NV21 = 0x02;
@@ -10,6 +12,16 @@ public abstract class MediaRecorderContext {
     public static final int RECORDER_TYPE_SINGLE_AUDIO   = 1; //仅录制音频
     public static final int RECORDER_TYPE_AV             = 2; //同时录制音频和视频,打包成 MP4 文件
 
+    public static final int BUFFER_TYPE_VIDEO = 0; //相机预览帧缓冲池
+    public static final int BUFFER_TYPE_AUDIO = 1; //麦克风 PCM 缓冲池
+
+    public static final int ENCODER_CODEC_H264  = 0; //H.264，使用 libx264
+    public static final int ENCODER_CODEC_MPEG4 = 1; //MPEG-4 Part 2
+
+    public static final int ENCODER_RC_ABR = 0; //平均码率，maxBitRate > 0 时带 VBV 上限
+    public static final int ENCODER_RC_CBR = 1; //恒定码率
+    public static final int ENCODER_RC_CRF = 2; //恒定质量，仅 H.264 支持
+
     private long mNativeContextHandle;
 
     protected native void native_CreateContext();
@@ -26,10 +38,33 @@ public abstract class MediaRecorderContext {
 
     protected native void native_OnPreviewFrame(int format, byte[] data, int width, int height);
 
+    //Native 分配、与 Java 共享内存的 direct ByteBuffer，失败返回 null
+    protected native ByteBuffer[] native_CreateBufferPool(int bufferType, int count, int capacity);
+
+    //借出一块空闲缓冲，返回其在缓冲池数组中的索引，没有空闲缓冲时返回 -1
+    protected native int native_AcquireBuffer(int bufferType);
+
+    //归还借出但没有提交的缓冲
+    protected native void native_ReleaseBuffer(int bufferType, ByteBuffer buffer);
+
+    //提交缓冲后不可再写，Native 用完后自行归还
+    protected native void native_OnAudioBuffer(ByteBuffer buffer, int len);
+
+    protected native void native_OnPreviewBuffer(int format, ByteBuffer buffer, int width, int height);
+
     protected native int native_StopRecord();
 
     protected native void native_SetTransformMatrix(float translateX, float translateY, float scaleX, float scaleY, int degree, int mirror);
 
+    //按传感器方向录制，旋转写入 MP4 的显示矩阵，下一次 startRecord 生效
+    protected native void native_SetRotationMetadataEnabled(boolean enable);
+
+    //视频编码配置，下一次 startRecord 生效；字符串传空表示不设置，数值参数的默认值见 native 层 EncoderConfig
+    protected native void native_SetEncoderConfig(int codec, String preset, String tune, int rateControl, int crf,
+                                                  long bitRate, long maxBitRate, long bufferSize,
+                                                  int threadCount, boolean slicedThreads, int lookahead,
+                                                  int maxBFrames, int keyIntervalFrames);
+
     protected native void native_OnSurfaceCreated();
 
     protected native void native_OnSurfaceChanged(int width, int height);
@@ -0,0 +1,143 @@
+/**
+ *
+ * Created by 公众号：字节流动 on 2026/10/18.
+ * https://github.com/githubhaohao/LearnFFmpeg
+ * 最新文章首发于公众号：字节流动，有疑问或者技术交流可以添加微信 Byte-Flow ,领取视频教程, 拉你进技术交流群
+ *
+ * */
+
+#include <string.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "TestUtil.h"
+#include "DirectBufferPool.h"
+
+static void TestAllocate() {
+    DirectBufferPool pool(3, 1000);
+    EXPECT_EQ(pool.GetCount(), 3);
+    EXPECT_EQ(pool.GetCapacity(), 1000);
+    EXPECT_EQ(pool.GetFreeCount(), 3);
+    for (int i = 0; i < pool.GetCount(); i++) {
+        uint8_t *pBuffer = pool.GetBuffer(i);
+        EXPECT_TRUE(pBuffer != nullptr);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(pBuffer) % DIRECT_BUFFER_ALIGN, 0);
+        //整块容量可写，ASan 会发现分配不足
+        memset(pBuffer, i, pool.GetCapacity());
+        EXPECT_EQ(pool.IndexOf(pBuffer), i);
+    }
+    EXPECT_TRUE(pool.GetBuffer(-1) == nullptr);
+    EXPECT_TRUE(pool.GetBuffer(3) == nullptr);
+}
+
+static void TestIndexOf() {
+    DirectBufferPool pool(2, 64);
+    uint8_t other[64];
+    EXPECT_EQ(pool.IndexOf(nullptr), -1);
+    EXPECT_EQ(pool.IndexOf(other), -1);
+    //缓冲中间的地址不属于本池，只认 GetDirectBufferAddress 返回的起始地址
+    EXPECT_EQ(pool.IndexOf(pool.GetBuffer(0) + 1), -1);
+}
+
+static void TestLifecycle() {
+    DirectBufferPool pool(2, 64);
+    int a = pool.Acquire();
+    int b = pool.Acquire();
+    EXPECT_TRUE(a >= 0 && b >= 0 && a != b);
+    EXPECT_EQ(pool.GetFreeCount(), 0);
+
+    //用完后 Acquire 返回 -1，由调用方丢帧
+    EXPECT_EQ(pool.Acquire(), -1);
+
+    EXPECT_EQ(pool.Submit(a), 0);
+    //同一块缓冲不能重复提交，也不能提交空闲缓冲
+    EXPECT_EQ(pool.Submit(a), -1);
+    pool.Release(a);
+    EXPECT_EQ(pool.Submit(a), -1);
+    EXPECT_EQ(pool.GetFreeCount(), 1);
+
+    //归还的缓冲可以再次借出
+    EXPECT_EQ(pool.Acquire(), a);
+
+    //没有提交就归还（Java 不使用借出的缓冲）
+    pool.Release(b);
+    pool.Release(a);
+    EXPECT_EQ(pool.GetFreeCount(), 2);
+}
+
+static void TestInvalidIndex() {
+    DirectBufferPool pool(1, 64);
+    EXPECT_EQ(pool.Submit(-1), -1);
+    EXPECT_EQ(pool.Submit(1), -1);
+    pool.Release(-1);
+    pool.Release(1);
+    EXPECT_EQ(pool.GetFreeCount(), 1);
+}
+
+static void TestReleaseCallback() {
+    DirectBufferPool pool(2, 64);
+    int index = pool.Acquire();
+    EXPECT_EQ(pool.Submit(index), 0);
+    //AudioFrame 删除时通过回调归还，地址不属于本池时忽略
+    uint8_t other[64];
+    DirectBufferPool::ReleaseBuffer(&pool, other);
+    EXPECT_EQ(pool.GetFreeCount(), 1);
+    DirectBufferPool::ReleaseBuffer(nullptr, pool.GetBuffer(index));
+    EXPECT_EQ(pool.GetFreeCount(), 1);
+    DirectBufferPool::ReleaseBuffer(&pool, pool.GetBuffer(index));
+    EXPECT_EQ(pool.GetFreeCount(), 2);
+}
+
+static void TestEmptyPool() {
+    DirectBufferPool pool(0, 64);
+    EXPECT_EQ(pool.GetCount(), 0);
+    EXPECT_EQ(pool.Acquire(), -1);
+    DirectBufferPool invalid(-1, -1);
+    EXPECT_EQ(invalid.GetCount(), 0);
+    EXPECT_EQ(invalid.GetCapacity(), 0);
+}
+
+/**
+ * @brief 模拟相机线程、音频线程借出提交，编码线程归还；同一块缓冲同时只能被一方持有
+ */
+static void TestConcurrent() {
+    const int threadCount = 4;
+    const int loops = 20000;
+    DirectBufferPool pool(3, 256);
+    std::vector<std::atomic<int>> owners(pool.GetCount());
+    for (auto &owner : owners) owner = 0;
+    std::atomic<int> conflicts(0);
+    std::atomic<int> acquired(0);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; t++) {
+        threads.push_back(std::thread([&pool, &owners, &conflicts, &acquired]() {
+            for (int i = 0; i < loops; i++) {
+                int index = pool.Acquire();
+                if (index < 0) continue;
+                acquired++;
+                if (owners[index].fetch_add(1) != 0) conflicts++;
+                pool.GetBuffer(index)[i % pool.GetCapacity()] = static_cast<uint8_t>(i);
+                if (pool.Submit(index) != 0) conflicts++;
+                owners[index].fetch_sub(1);
+                DirectBufferPool::ReleaseBuffer(&pool, pool.GetBuffer(index));
+            }
+        }));
+    }
+    for (auto &thread : threads) thread.join();
+
+    EXPECT_EQ(conflicts.load(), 0);
+    EXPECT_TRUE(acquired.load() > 0);
+    EXPECT_EQ(pool.GetFreeCount(), pool.GetCount());
+}
+
+int main() {
+    RUN_TEST(TestAllocate);
+    RUN_TEST(TestIndexOf);
+    RUN_TEST(TestLifecycle);
+    RUN_TEST(TestInvalidIndex);
+    RUN_TEST(TestReleaseCallback);
+    RUN_TEST(TestEmptyPool);
+    RUN_TEST(TestConcurrent);
+    return TEST_RESULT();
+}
@@ -0,0 +1,175 @@
+/**
+ *
+ * Created by 公众号：字节流动 on 2026/10/18.
+ * https://github.com/githubhaohao/LearnFFmpeg
+ * 最新文章首发于公众号：字节流动，有疑问或者技术交流可以添加微信 Byte-Flow ,领取视频教程, 拉你进技术交流群
+ *
+ * */
+
+#include <string.h>
+#include <stdlib.h>
+#include "TestUtil.h"
+#include "EncoderConfig.h"
+
+#define BENCH_WIDTH      720
+#define BENCH_HEIGHT     1280
+#define BENCH_FPS        25
+#define BENCH_BIT_RATE   (2 * 1000 * 1000)
+
+/**
+ * @brief 打开按配置设置好的编码器上下文
+ * @return 失败返回 nullptr
+ */
+static AVCodecContext *OpenEncoder(const EncoderConfig &config, AVOutputFormat *oformat) {
+    AVCodec *codec = config.FindEncoder(oformat);
+    if (codec == nullptr) return nullptr;
+    AVCodecContext *ctx = avcodec_alloc_context3(codec);
+    ctx->width = BENCH_WIDTH;
+    ctx->height = BENCH_HEIGHT;
+    ctx->time_base = av_make_q(1, BENCH_FPS);
+    ctx->framerate = av_make_q(BENCH_FPS, 1);
+    ctx->pix_fmt = AV_PIX_FMT_YUV420P;
+    config.Apply(ctx, BENCH_FPS, BENCH_BIT_RATE);
+    if (avcodec_open2(ctx, codec, nullptr) < 0) {
+        fprintf(stderr, "avcodec_open2 fail: %s\n", config.ToString().c_str());
+        avcodec_free_context(&ctx);
+    }
+    return ctx;
+}
+
+static void CheckApply(const EncoderConfig &config, AVOutputFormat *oformat) {
+    AVCodec *codec = config.FindEncoder(oformat);
+    EXPECT_TRUE(codec != nullptr);
+    if (codec == nullptr) return;
+    AVCodecContext *ctx = avcodec_alloc_context3(codec);
+    config.Apply(ctx, BENCH_FPS, BENCH_BIT_RATE);
+    bool isX264 = strcmp(codec->name, "libx264") == 0;
+    long bitRate = config.bitRate > 0 ? config.bitRate : BENCH_BIT_RATE;
+
+    EXPECT_EQ(ctx->gop_size, config.keyIntervalFrames > 0 ? config.keyIntervalFrames : BENCH_FPS * ENCODER_DEFAULT_KEYINT_SEC);
+    EXPECT_EQ(ctx->thread_type, config.slicedThreads ? FF_THREAD_SLICE : FF_THREAD_FRAME);
+    if (config.maxBFrames >= 0) EXPECT_EQ(ctx->max_b_frames, config.maxBFrames);
+    if (config.rateControl == ENCODER_RC_CBR) {
+        EXPECT_EQ(ctx->bit_rate, bitRate);
+        EXPECT_EQ(ctx->rc_min_rate, bitRate);
+        EXPECT_EQ(ctx->rc_max_rate, bitRate);
+    } else if (config.rateControl == ENCODER_RC_CRF && isX264) {
+        //CRF 不设置目标码率
+        EXPECT_EQ(ctx->bit_rate, 0);
+    } else {
+        //ABR，以及编码器不支持 CRF 时退回的 ABR
+        EXPECT_EQ(ctx->bit_rate, bitRate);
+    }
+    if (config.maxBitRate > 0 || config.rateControl == ENCODER_RC_CBR) {
+        EXPECT_TRUE(ctx->rc_buffer_size > 0);
+    }
+    avcodec_free_context(&ctx);
+}
+
+/**
+ * @brief 合成一帧：随帧号移动的亮度渐变和色块，让运动估计和码率控制有事可做
+ */
+static void FillFrame(AVFrame *frame, int index) {
+    for (int y = 0; y < frame->height; ++y) {
+        uint8_t *p = frame->data[0] + y * frame->linesize[0];
+        for (int x = 0; x < frame->width; ++x) {
+            p[x] = static_cast<uint8_t>(x + y + index * 3);
+        }
+    }
+    for (int y = 0; y < frame->height / 2; ++y) {
+        uint8_t *u = frame->data[1] + y * frame->linesize[1];
+        uint8_t *v = frame->data[2] + y * frame->linesize[2];
+        for (int x = 0; x < frame->width / 2; ++x) {
+            u[x] = static_cast<uint8_t>(128 + ((x + index) / 32 % 2) * 40);
+            v[x] = static_cast<uint8_t>(128 + ((y + index) / 32 % 2) * 40);
+        }
+    }
+}
+
+/**
+ * @brief 编码 frameCount 帧，计时方式与 MediaRecorder::EncodeVideoFrame 相同（不含封装）
+ */
+static void RunConfig(const char *name, const EncoderConfig &config, AVOutputFormat *oformat, int frameCount) {
+    CheckApply(config, oformat);
+    AVCodecContext *ctx = OpenEncoder(config, oformat);
+    EXPECT_TRUE(ctx != nullptr);
+    if (ctx == nullptr) return;
+
+    AVFrame *frame = av_frame_alloc();
+    frame->format = ctx->pix_fmt;
+    frame->width = ctx->width;
+    frame->height = ctx->height;
+    av_frame_get_buffer(frame, 32);
+    AVPacket *pkt = av_packet_alloc();
+
+    EncodeStats stats(name);
+    stats.Start(config.ToString(), BENCH_FPS);
+    int packets = 0;
+    for (int i = 0; i <= frameCount; ++i) {
+        // 最后一次送入 nullptr 刷新编码器，不计入帧数
+        AVFrame *input = nullptr;
+        if (i < frameCount) {
+            av_frame_make_writable(frame);
+            FillFrame(frame, i);
+            frame->pts = i;
+            input = frame;
+        }
+        long long start = GetTestTimeUs();
+        int ret = avcodec_send_frame(ctx, input);
+        while (ret >= 0) {
+            ret = avcodec_receive_packet(ctx, pkt);
+            if (ret < 0) break;
+            stats.AddPacket(pkt->size);
+            packets++;
+            av_packet_unref(pkt);
+        }
+        if (input != nullptr) stats.AddFrame(GetTestTimeUs() - start);
+    }
+    stats.Report();
+    EXPECT_EQ(packets, frameCount);
+
+    av_packet_free(&pkt);
+    av_frame_free(&frame);
+    avcodec_free_context(&ctx);
+}
+
+/**
+ * 各配置在同一组合成帧上的编码帧率和实际码率，结果由 EncodeStats::Report 输出到 stderr。
+ * 参数：编码帧数，默认 ENCODE_STATS_INTERVAL 帧
+ */
+int main(int argc, char *argv[]) {
+    int frameCount = argc > 1 ? atoi(argv[1]) : ENCODE_STATS_INTERVAL;
+    AVOutputFormat *oformat = av_guess_format("mp4", nullptr, nullptr);
+
+    EncoderConfig abr;
+    RunConfig("abr veryfast", abr, oformat, frameCount);
+
+    EncoderConfig cbr;
+    cbr.rateControl = ENCODER_RC_CBR;
+    RunConfig("cbr veryfast", cbr, oformat, frameCount);
+
+    EncoderConfig crf;
+    crf.rateControl = ENCODER_RC_CRF;
+    crf.maxBitRate = 4 * 1000 * 1000;
+    RunConfig("crf vbv", crf, oformat, frameCount);
+
+    EncoderConfig live;
+    live.preset = "ultrafast";
+    live.tune = "zerolatency";
+    live.slicedThreads = true;
+    live.maxBFrames = 0;
+    RunConfig("zerolatency sliced", live, oformat, frameCount);
+
+    EncoderConfig lookahead;
+    lookahead.lookahead = 10;
+    lookahead.maxBFrames = 2;
+    lookahead.keyIntervalFrames = BENCH_FPS;
+    RunConfig("lookahead 10", lookahead, oformat, frameCount);
+
+    EncoderConfig mpeg4;
+    mpeg4.codec = ENCODER_CODEC_MPEG4;
+    mpeg4.rateControl = ENCODER_RC_CRF;
+    RunConfig("mpeg4", mpeg4, oformat, frameCount);
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,203 @@
+/**
+ *
+ * Created by 公众号：字节流动 on 2026/10/18.
+ * https://github.com/githubhaohao/LearnFFmpeg
+ * 最新文章首发于公众号：字节流动，有疑问或者技术交流可以添加微信 Byte-Flow ,领取视频教程, 拉你进技术交流群
+ *
+ * */
+
+#include <string.h>
+#include <vector>
+#include "TestUtil.h"
+#include "MediaCodecFormat.h"
+
+static const uint8_t START_CODE[] = {0, 0, 0, 1};
+
+static const uint8_t AVC_SPS[] = {0x67, 0x42, 0xC0, 0x1E, 0xDA, 0x02};
+static const uint8_t AVC_PPS[] = {0x68, 0xCE, 0x3C, 0x80};
+static const uint8_t HEVC_VPS[] = {0x40, 0x01, 0x0C, 0x01};
+static const uint8_t HEVC_SPS[] = {0x42, 0x01, 0x01, 0x01, 0x60};
+static const uint8_t HEVC_PPS[] = {0x44, 0x01, 0xC1};
+
+static void AppendBytes(std::vector<uint8_t> &out, const uint8_t *data, size_t size) {
+    out.insert(out.end(), data, data + size);
+}
+
+static void AppendLengthPrefixed(std::vector<uint8_t> &out, const uint8_t *nal, size_t size) {
+    out.push_back(static_cast<uint8_t>(size >> 8));
+    out.push_back(static_cast<uint8_t>(size & 0xff));
+    AppendBytes(out, nal, size);
+}
+
+static std::vector<uint8_t> AnnexB(const uint8_t *nal, size_t size) {
+    std::vector<uint8_t> out(START_CODE, START_CODE + sizeof(START_CODE));
+    AppendBytes(out, nal, size);
+    return out;
+}
+
+static std::vector<uint8_t> MakeAvcC() {
+    std::vector<uint8_t> avcC = {1, AVC_SPS[1], AVC_SPS[2], AVC_SPS[3], 0xFF, 0xE1};
+    AppendLengthPrefixed(avcC, AVC_SPS, sizeof(AVC_SPS));
+    avcC.push_back(1);
+    AppendLengthPrefixed(avcC, AVC_PPS, sizeof(AVC_PPS));
+    return avcC;
+}
+
+static std::vector<uint8_t> MakeHvcC() {
+    std::vector<uint8_t> hvcC(22, 0);
+    hvcC[0] = 1;
+    hvcC.push_back(3);
+    const uint8_t types[] = {32, 33, 34};
+    const uint8_t *nals[] = {HEVC_VPS, HEVC_SPS, HEVC_PPS};
+    const size_t sizes[] = {sizeof(HEVC_VPS), sizeof(HEVC_SPS), sizeof(HEVC_PPS)};
+    for (int i = 0; i < 3; i++) {
+        hvcC.push_back(0x80 | types[i]);
+        hvcC.push_back(0);
+        hvcC.push_back(1);
+        AppendLengthPrefixed(hvcC, nals[i], sizes[i]);
+    }
+    return hvcC;
+}
+
+/**
+ * @brief extradata 按原长度单独分配，ASan 可以发现任何越界读
+ */
+static bool Convert(AVCodecID codecId, const std::vector<uint8_t> &extradata, MediaCodecFormat *format) {
+    std::vector<uint8_t> copy(extradata);
+    AVCodecParameters par;
+    memset(&par, 0, sizeof(par));
+    par.codec_type = AVMEDIA_TYPE_VIDEO;
+    par.codec_id = codecId;
+    par.width = 1280;
+    par.height = 720;
+    par.extradata = copy.empty() ? nullptr : copy.data();
+    par.extradata_size = static_cast<int>(copy.size());
+    return MediaCodecFormat::FromCodecParameters(&par, format);
+}
+
+static void TestAvcC() {
+    MediaCodecFormat format;
+    EXPECT_TRUE(Convert(AV_CODEC_ID_H264, MakeAvcC(), &format));
+    EXPECT_TRUE(format.mime == "video/avc");
+    EXPECT_EQ(format.width, 1280);
+    EXPECT_EQ(format.height, 720);
+    EXPECT_TRUE(format.csd0 == AnnexB(AVC_SPS, sizeof(AVC_SPS)));
+    EXPECT_TRUE(format.csd1 == AnnexB(AVC_PPS, sizeof(AVC_PPS)));
+}
+
+static void TestAvcCWithoutSps() {
+    std::vector<uint8_t> avcC = {1, 0x42, 0xC0, 0x1E, 0xFF, 0xE0, 0};
+    MediaCodecFormat format;
+    EXPECT_TRUE(!Convert(AV_CODEC_ID_H264, avcC, &format));
+}
+
+static void TestAvcCBadLength() {
+    //SPS 长度字段远大于剩余数据
+    std::vector<uint8_t> avcC = {1, 0x42, 0xC0, 0x1E, 0xFF, 0xE1, 0xFF, 0xFF, 0x67};
+    MediaCodecFormat format;
+    EXPECT_TRUE(!Convert(AV_CODEC_ID_H264, avcC, &format));
+}
+
+static void TestAvcCTruncated() {
+    std::vector<uint8_t> avcC = MakeAvcC();
+    for (size_t size = 1; size < avcC.size(); size++) {
+        std::vector<uint8_t> prefix(avcC.begin(), avcC.begin() + size);
+        MediaCodecFormat format;
+        if (Convert(AV_CODEC_ID_H264, prefix, &format)) {
+            fprintf(stderr, "avcC truncated to %d bytes accepted\n", (int) size);
+            g_TestFailures++;
+        }
+    }
+}
+
+static void TestAnnexBAvc() {
+    //SPS 前是 4 字节起始码，PPS 前是 3 字节起始码，IDR 不放入 csd
+    std::vector<uint8_t> extradata(START_CODE, START_CODE + sizeof(START_CODE));
+    AppendBytes(extradata, AVC_SPS, sizeof(AVC_SPS));
+    extradata.push_back(0);
+    extradata.push_back(0);
+    extradata.push_back(1);
+    AppendBytes(extradata, AVC_PPS, sizeof(AVC_PPS));
+    AppendBytes(extradata, START_CODE, sizeof(START_CODE));
+    extradata.push_back(0x65);
+    extradata.push_back(0x88);
+
+    MediaCodecFormat format;
+    EXPECT_TRUE(Convert(AV_CODEC_ID_H264, extradata, &format));
+    EXPECT_TRUE(format.csd0 == AnnexB(AVC_SPS, sizeof(AVC_SPS)));
+    EXPECT_TRUE(format.csd1 == AnnexB(AVC_PPS, sizeof(AVC_PPS)));
+}
+
+static void TestAnnexBAvcTruncated() {
+    //起始码之后没有数据，或 NAL 只有一部分，都不能越界
+    std::vector<uint8_t> extradata(START_CODE, START_CODE + sizeof(START_CODE));
+    AppendBytes(extradata, AVC_SPS, sizeof(AVC_SPS));
+    for (size_t size = sizeof(START_CODE); size <= extradata.size(); size++) {
+        std::vector<uint8_t> prefix(extradata.begin(), extradata.begin() + size);
+        MediaCodecFormat format;
+        EXPECT_TRUE(Convert(AV_CODEC_ID_H264, prefix, &format));
+        EXPECT_TRUE(format.csd1.empty());
+    }
+}
+
+static void TestHvcC() {
+    std::vector<uint8_t> expected = AnnexB(HEVC_VPS, sizeof(HEVC_VPS));
+    std::vector<uint8_t> sps = AnnexB(HEVC_SPS, sizeof(HEVC_SPS));
+    std::vector<uint8_t> pps = AnnexB(HEVC_PPS, sizeof(HEVC_PPS));
+    expected.insert(expected.end(), sps.begin(), sps.end());
+    expected.insert(expected.end(), pps.begin(), pps.end());
+
+    MediaCodecFormat format;
+    EXPECT_TRUE(Convert(AV_CODEC_ID_HEVC, MakeHvcC(), &format));
+    EXPECT_TRUE(format.mime == "video/hevc");
+    EXPECT_TRUE(format.csd0 == expected);
+    EXPECT_TRUE(format.csd1.empty());
+}
+
+static void TestHvcCTruncated() {
+    std::vector<uint8_t> hvcC = MakeHvcC();
+    for (size_t size = 1; size < hvcC.size(); size++) {
+        std::vector<uint8_t> prefix(hvcC.begin(), hvcC.begin() + size);
+        MediaCodecFormat format;
+        if (Convert(AV_CODEC_ID_HEVC, prefix, &format)) {
+            fprintf(stderr, "hvcC truncated to %d bytes accepted\n", (int) size);
+            g_TestFailures++;
+        }
+    }
+}
+
+static void TestAnnexBHevc() {
+    std::vector<uint8_t> extradata = AnnexB(HEVC_VPS, sizeof(HEVC_VPS));
+    MediaCodecFormat format;
+    EXPECT_TRUE(Convert(AV_CODEC_ID_HEVC, extradata, &format));
+    EXPECT_TRUE(format.csd0 == extradata);
+}
+
+static void TestOtherCodecs() {
+    std::vector<uint8_t> vol = {0x00, 0x00, 0x01, 0xB0, 0x01};
+    MediaCodecFormat format;
+    EXPECT_TRUE(Convert(AV_CODEC_ID_MPEG4, vol, &format));
+    EXPECT_TRUE(format.mime == "video/mp4v-es");
+    EXPECT_TRUE(format.csd0 == vol);
+
+    //没有 extradata 时参数集在码流中，不生成 csd
+    EXPECT_TRUE(Convert(AV_CODEC_ID_VP9, std::vector<uint8_t>(), &format));
+    EXPECT_TRUE(format.mime == "video/x-vnd.on2.vp9");
+    EXPECT_TRUE(format.csd0.empty() && format.csd1.empty());
+
+    EXPECT_TRUE(!Convert(AV_CODEC_ID_THEORA, std::vector<uint8_t>(), &format));
+}
+
+int main() {
+    RUN_TEST(TestAvcC);
+    RUN_TEST(TestAvcCWithoutSps);
+    RUN_TEST(TestAvcCBadLength);
+    RUN_TEST(TestAvcCTruncated);
+    RUN_TEST(TestAnnexBAvc);
+    RUN_TEST(TestAnnexBAvcTruncated);
+    RUN_TEST(TestHvcC);
+    RUN_TEST(TestHvcCTruncated);
+    RUN_TEST(TestAnnexBHevc);
+    RUN_TEST(TestOtherCodecs);
+    return TEST_RESULT();
+}
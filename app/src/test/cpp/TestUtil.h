@@ -0,0 +1,54 @@
+/**
+ *
+ * Created by 公众号：字节流动 on 2026/10/18.
+ * https://github.com/githubhaohao/LearnFFmpeg
+ * 最新文章首发于公众号：字节流动，有疑问或者技术交流可以添加微信 Byte-Flow ,领取视频教程, 拉你进技术交流群
+ *
+ * */
+
+#ifndef LEARNFFMPEG_TESTUTIL_H
+#define LEARNFFMPEG_TESTUTIL_H
+
+#include <stdio.h>
+#include <chrono>
+
+/**
+ * @brief 主机单元测试的断言和计时工具
+ *
+ * 每个测试程序是一个独立的可执行文件，EXPECT_XXX 失败时打印位置并计数，
+ * main 返回 TEST_RESULT()，有失败时 ctest 判定为不通过
+ */
+static int g_TestFailures = 0;
+
+#define EXPECT_TRUE(cond) do { \
+    if (!(cond)) { \
+        fprintf(stderr, "%s:%d: EXPECT_TRUE(%s) failed\n", __FILE__, __LINE__, #cond); \
+        g_TestFailures++; \
+    } \
+} while (0)
+
+#define EXPECT_EQ(a, b) do { \
+    long long _va = (long long) (a), _vb = (long long) (b); \
+    if (_va != _vb) { \
+        fprintf(stderr, "%s:%d: EXPECT_EQ(%s, %s) failed: %lld != %lld\n", __FILE__, __LINE__, #a, #b, _va, _vb); \
+        g_TestFailures++; \
+    } \
+} while (0)
+
+#define RUN_TEST(fn) do { \
+    int _before = g_TestFailures; \
+    fn(); \
+    printf("[%s] %s\n", g_TestFailures == _before ? "  OK  " : "FAILED", #fn); \
+} while (0)
+
+#define TEST_RESULT() (g_TestFailures == 0 ? 0 : 1)
+
+/**
+ * @brief 单调时钟（微秒），用于性能对比
+ */
+static inline long long GetTestTimeUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#endif //LEARNFFMPEG_TESTUTIL_H
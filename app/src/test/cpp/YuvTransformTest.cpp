@@ -0,0 +1,279 @@
+/**
+ *
+ * Created by 公众号：字节流动 on 2026/10/18.
+ * https://github.com/githubhaohao/LearnFFmpeg
+ * 最新文章首发于公众号：字节流动，有疑问或者技术交流可以添加微信 Byte-Flow ,领取视频教程, 拉你进技术交流群
+ *
+ * */
+
+#include <stdlib.h>
+#include <vector>
+#include "TestUtil.h"
+#include "YuvTransform.h"
+
+// 目标平面每行多出的填充字节，检查 ToI420 不会写出宽度之外
+#define DST_PADDING  24
+#define DST_GUARD    0xA5
+
+struct Plane {
+    int width = 0;
+    int height = 0;
+    int stride = 0;
+    std::vector<uint8_t> data;
+
+    void Alloc(int w, int h, int padding, uint8_t fill) {
+        width = w;
+        height = h;
+        stride = w + padding;
+        data.assign(static_cast<size_t>(stride) * h, fill);
+    }
+
+    uint8_t At(int x, int y) const { return data[static_cast<size_t>(y) * stride + x]; }
+
+    uint8_t &At(int x, int y) { return data[static_cast<size_t>(y) * stride + x]; }
+};
+
+/**
+ * @brief 逐像素的参考实现：先按顺时针角度旋转，再镜像
+ *
+ * 与 GLCameraRender::UpdateMVPMatrix 的语义一致：mirror 为 0 时 degree 是顺时针角度，否则是逆时针角度。
+ * 这里直接写出每个角度的坐标公式，不复用被测代码里的转置/翻转分解
+ */
+static void ReferenceTransform(const Plane &src, Plane *pDst, int degree, int mirror) {
+    int clockwise = mirror == YUV_MIRROR_NONE ? degree : 360 - degree;
+    clockwise = ((clockwise % 360) + 360) % 360;
+    int w = src.width, h = src.height;
+    bool swap = clockwise == 90 || clockwise == 270;
+
+    Plane rotated;
+    rotated.Alloc(swap ? h : w, swap ? w : h, 0, 0);
+    for (int y = 0; y < rotated.height; ++y) {
+        for (int x = 0; x < rotated.width; ++x) {
+            switch (clockwise) {
+                case 90:
+                    rotated.At(x, y) = src.At(y, h - 1 - x);
+                    break;
+                case 180:
+                    rotated.At(x, y) = src.At(w - 1 - x, h - 1 - y);
+                    break;
+                case 270:
+                    rotated.At(x, y) = src.At(w - 1 - y, x);
+                    break;
+                default:
+                    rotated.At(x, y) = src.At(x, y);
+                    break;
+            }
+        }
+    }
+
+    for (int y = 0; y < rotated.height; ++y) {
+        for (int x = 0; x < rotated.width; ++x) {
+            int sx = mirror == YUV_MIRROR_HORIZONTAL ? rotated.width - 1 - x : x;
+            int sy = mirror == YUV_MIRROR_VERTICAL ? rotated.height - 1 - y : y;
+            pDst->At(x, y) = rotated.At(sx, sy);
+        }
+    }
+}
+
+/**
+ * @brief 随机内容的源帧，Y/U/V 各自一个平面，行尾带填充
+ */
+struct SourceFrame {
+    Plane y, u, v;
+    std::vector<uint8_t> chroma;  // NV21/NV12 的交错色度
+    int chromaStride = 0;
+
+    SourceFrame(int w, int h, int padding) {
+        y.Alloc(w, h, padding, 0);
+        u.Alloc(w / 2, h / 2, padding / 2, 0);
+        v.Alloc(w / 2, h / 2, padding / 2, 0);
+        for (auto &p : y.data) p = static_cast<uint8_t>(rand());
+        for (auto &p : u.data) p = static_cast<uint8_t>(rand());
+        for (auto &p : v.data) p = static_cast<uint8_t>(rand());
+        chromaStride = w + padding;
+        chroma.assign(static_cast<size_t>(chromaStride) * h / 2, 0);
+    }
+
+    NativeImage ToImage(int format) {
+        NativeImage image;
+        image.width = y.width;
+        image.height = y.height;
+        image.format = format;
+        image.ppPlane[0] = y.data.data();
+        image.pLineSize[0] = y.stride;
+        if (format == IMAGE_FORMAT_I420) {
+            image.ppPlane[1] = u.data.data();
+            image.ppPlane[2] = v.data.data();
+            image.pLineSize[1] = u.stride;
+            image.pLineSize[2] = v.stride;
+            return image;
+        }
+        // NV21 每对中 V 在前，NV12 U 在前
+        const Plane &first = format == IMAGE_FORMAT_NV21 ? v : u;
+        const Plane &second = format == IMAGE_FORMAT_NV21 ? u : v;
+        for (int row = 0; row < u.height; ++row) {
+            uint8_t *d = chroma.data() + static_cast<size_t>(row) * chromaStride;
+            for (int col = 0; col < u.width; ++col) {
+                d[col * 2] = first.At(col, row);
+                d[col * 2 + 1] = second.At(col, row);
+            }
+        }
+        image.ppPlane[1] = chroma.data();
+        image.pLineSize[1] = chromaStride;
+        return image;
+    }
+};
+
+struct DestFrame {
+    Plane planes[3];
+
+    DestFrame(int w, int h, int padding) {
+        planes[0].Alloc(w, h, padding, DST_GUARD);
+        planes[1].Alloc(w / 2, h / 2, padding, DST_GUARD);
+        planes[2].Alloc(w / 2, h / 2, padding, DST_GUARD);
+    }
+
+    int Transform(NativeImage *pImage, int degree, int mirror) {
+        uint8_t *ppDst[3] = {planes[0].data.data(), planes[1].data.data(), planes[2].data.data()};
+        int lineSize[3] = {planes[0].stride, planes[1].stride, planes[2].stride};
+        return YuvTransform::ToI420(pImage, ppDst, lineSize, degree, mirror);
+    }
+};
+
+/**
+ * @brief 比较一个平面，返回不一致的像素数；行尾填充被改写也算不一致
+ */
+static int ComparePlane(const Plane &actual, const Plane &expected) {
+    int mismatches = 0;
+    for (int y = 0; y < actual.height; ++y) {
+        for (int x = 0; x < actual.stride; ++x) {
+            uint8_t want = x < actual.width ? expected.At(x, y) : static_cast<uint8_t>(DST_GUARD);
+            if (actual.At(x, y) != want) mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+static bool CheckTransform(int w, int h, int padding, int format, int degree, int mirror) {
+    SourceFrame src(w, h, padding);
+    NativeImage image = src.ToImage(format);
+    int dstW, dstH;
+    YuvTransform::GetOutputSize(w, h, degree, &dstW, &dstH);
+    DestFrame dst(dstW, dstH, DST_PADDING);
+    if (dst.Transform(&image, degree, mirror) != 0) {
+        fprintf(stderr, "ToI420 failed: %dx%d format=%d degree=%d mirror=%d\n", w, h, format, degree, mirror);
+        return false;
+    }
+
+    const Plane *srcPlanes[3] = {&src.y, &src.u, &src.v};
+    for (int i = 0; i < 3; ++i) {
+        Plane expected;
+        expected.Alloc(dst.planes[i].width, dst.planes[i].height, 0, 0);
+        ReferenceTransform(*srcPlanes[i], &expected, degree, mirror);
+        int mismatches = ComparePlane(dst.planes[i], expected);
+        if (mismatches != 0) {
+            fprintf(stderr, "plane %d mismatches=%d: %dx%d padding=%d format=%d degree=%d mirror=%d\n",
+                    i, mismatches, w, h, padding, format, degree, mirror);
+            return false;
+        }
+    }
+    return true;
+}
+
+static void TestMatchesReference() {
+    // 覆盖 8x8 块的整数倍、块边缘剩余和最小尺寸
+    const int sizes[][2] = {{2, 2}, {16, 16}, {36, 22}, {64, 48}, {102, 70}, {176, 144}};
+    const int formats[] = {IMAGE_FORMAT_NV21, IMAGE_FORMAT_NV12, IMAGE_FORMAT_I420};
+    for (auto &size : sizes) {
+        for (int padding = 0; padding <= 8; padding += 8) {
+            for (int format : formats) {
+                for (int degree = 0; degree < 360; degree += 90) {
+                    for (int mirror = YUV_MIRROR_NONE; mirror <= YUV_MIRROR_VERTICAL; ++mirror) {
+                        EXPECT_TRUE(CheckTransform(size[0], size[1], padding, format, degree, mirror));
+                    }
+                }
+            }
+        }
+    }
+}
+
+static void TestNegativeDegree() {
+    EXPECT_TRUE(CheckTransform(36, 22, 0, IMAGE_FORMAT_NV21, -90, YUV_MIRROR_NONE));
+    EXPECT_TRUE(CheckTransform(36, 22, 0, IMAGE_FORMAT_NV21, 450, YUV_MIRROR_HORIZONTAL));
+}
+
+static void TestOutputSize() {
+    int w, h;
+    YuvTransform::GetOutputSize(1280, 720, 90, &w, &h);
+    EXPECT_EQ(w, 720);
+    EXPECT_EQ(h, 1280);
+    YuvTransform::GetOutputSize(1280, 720, 180, &w, &h);
+    EXPECT_EQ(w, 1280);
+    EXPECT_EQ(h, 720);
+    YuvTransform::GetOutputSize(1280, 720, -90, &w, &h);
+    EXPECT_EQ(w, 720);
+    EXPECT_EQ(h, 1280);
+}
+
+static void TestInvalidInput() {
+    SourceFrame src(16, 16, 0);
+    DestFrame dst(16, 16, DST_PADDING);
+    NativeImage image = src.ToImage(IMAGE_FORMAT_I420);
+    EXPECT_EQ(dst.Transform(nullptr, 0, YUV_MIRROR_NONE), -1);
+    EXPECT_EQ(dst.Transform(&image, 45, YUV_MIRROR_NONE), -1);
+
+    NativeImage odd = image;
+    odd.width = 15;
+    EXPECT_EQ(dst.Transform(&odd, 0, YUV_MIRROR_NONE), -1);
+
+    NativeImage rgba = image;
+    rgba.format = IMAGE_FORMAT_RGBA;
+    EXPECT_EQ(dst.Transform(&rgba, 0, YUV_MIRROR_NONE), -1);
+}
+
+/**
+ * @brief 720p 帧与参考实现的耗时对比，只输出结果不做断言；
+ * 默认的 ASan 构建会放大耗时，对比性能时用 -DTEST_SANITIZE=OFF 构建
+ */
+static void BenchmarkTransform() {
+    const int w = 1280, h = 720, loops = 20;
+    const int cases[][3] = {
+            {IMAGE_FORMAT_NV21, 90,  YUV_MIRROR_NONE},
+            {IMAGE_FORMAT_NV21, 270, YUV_MIRROR_HORIZONTAL},
+            {IMAGE_FORMAT_NV21, 180, YUV_MIRROR_NONE},
+            {IMAGE_FORMAT_I420, 90,  YUV_MIRROR_NONE},
+    };
+    SourceFrame src(w, h, 0);
+    for (auto &c : cases) {
+        NativeImage image = src.ToImage(c[0]);
+        int dstW, dstH;
+        YuvTransform::GetOutputSize(w, h, c[1], &dstW, &dstH);
+        DestFrame dst(dstW, dstH, 0);
+
+        long long t0 = GetTestTimeUs();
+        for (int i = 0; i < loops; ++i) dst.Transform(&image, c[1], c[2]);
+        long long kernelUs = (GetTestTimeUs() - t0) / loops;
+
+        // 参考实现只变换 Y 平面，按 1.5 倍折算整帧
+        Plane expected;
+        expected.Alloc(dstW, dstH, 0, 0);
+        t0 = GetTestTimeUs();
+        for (int i = 0; i < loops; ++i) ReferenceTransform(src.y, &expected, c[1], c[2]);
+        long long referenceUs = (GetTestTimeUs() - t0) * 3 / 2 / loops;
+
+        printf("  %dx%d format=%d degree=%d mirror=%d: %s %lldus, reference %lldus, x%.1f\n",
+               w, h, c[0], c[1], c[2], YuvTransform::GetKernelName(), kernelUs, referenceUs,
+               kernelUs > 0 ? (double) referenceUs / kernelUs : 0.0);
+    }
+}
+
+int main() {
+    srand(1);
+    printf("YuvTransform kernel: %s\n", YuvTransform::GetKernelName());
+    RUN_TEST(TestMatchesReference);
+    RUN_TEST(TestNegativeDegree);
+    RUN_TEST(TestOutputSize);
+    RUN_TEST(TestInvalidInput);
+    RUN_TEST(BenchmarkTransform);
+    return TEST_RESULT();
+}